@@ -0,0 +1,110 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <gfx/age_convolution.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    bool reads_own_texel_only(const age::convolution_kernel& kernel)
+    {
+        return (kernel.size() == 1) && (kernel.begin()->first == std::make_pair(0, 0));
+    }
+
+    bool reads_x_axis_only(const age::convolution_kernel& kernel)
+    {
+        return std::all_of(begin(kernel), end(kernel), [](const auto& tap) {
+            return tap.first.second == 0;
+        });
+    }
+
+    bool reads_y_axis_only(const age::convolution_kernel& kernel)
+    {
+        return std::all_of(begin(kernel), end(kernel), [](const auto& tap) {
+            return tap.first.first == 0;
+        });
+    }
+
+} // namespace
+
+
+
+const age::convolution_kernel age::convolution_gauss3x3_s{{{-1, 0}, 0.27901}, {{0, 0}, 0.44198}, {{1, 0}, 0.27901}};
+const age::convolution_kernel age::convolution_gauss3x3_t{{{0, -1}, 0.27901}, {{0, 0}, 0.44198}, {{0, 1}, 0.27901}};
+
+const age::convolution_kernel age::convolution_gauss5x5_s{{{-2, 0}, 0.06136}, {{-1, 0}, 0.24477}, {{0, 0}, 0.38774}, {{1, 0}, 0.24477}, {{2, 0}, 0.06136}};
+const age::convolution_kernel age::convolution_gauss5x5_t{{{0, -2}, 0.06136}, {{0, -1}, 0.24477}, {{0, 0}, 0.38774}, {{0, 1}, 0.24477}, {{0, 2}, 0.06136}};
+
+const age::convolution_kernel age::convolution_emboss3x3{{{-1, 1}, -1.0 / 4}, {{0, 0}, 1.0}, {{1, -1}, 1.0 / 4}};
+const age::convolution_kernel age::convolution_emboss5x5{{{-2, 2}, -1.0 / 7}, {{-1, 1}, -2.0 / 7}, {{0, 0}, 1.0}, {{1, -1}, 2.0 / 7}, {{2, -2}, 1.0 / 7}};
+
+
+
+age::convolution_kernel age::convolve(const convolution_kernel& first, const convolution_kernel& second)
+{
+    convolution_kernel result;
+    for (const auto& [offset1, weight1] : first)
+    {
+        for (const auto& [offset2, weight2] : second)
+        {
+            auto offset = std::make_pair(offset1.first + offset2.first, offset1.second + offset2.second);
+            result[offset] += weight1 * weight2;
+        }
+    }
+    // remove texel reads that cancel each other out
+    std::erase_if(result, [](const auto& tap) {
+        return std::abs(tap.second) < 1e-6;
+    });
+    return result;
+}
+
+bool age::can_fuse(const convolution_kernel& first, const convolution_kernel& second)
+{
+    bool first_is_clamped = std::any_of(begin(first), end(first), [](const auto& tap) {
+        return tap.second < 0;
+    });
+    if (first_is_clamped)
+    {
+        return false;
+    }
+
+    return reads_own_texel_only(first)
+           || reads_own_texel_only(second)
+           || (reads_x_axis_only(first) && reads_y_axis_only(second))
+           || (reads_y_axis_only(first) && reads_x_axis_only(second));
+}
+
+std::vector<age::convolution_kernel> age::fuse_convolution_kernels(const std::vector<convolution_kernel>& kernels)
+{
+    std::vector<convolution_kernel> result;
+    for (const auto& kernel : kernels)
+    {
+        if (!result.empty() && can_fuse(result.back(), kernel))
+        {
+            auto fused = convolve(result.back(), kernel);
+            if (fused.size() <= max_fused_convolution_taps)
+            {
+                result.back() = fused;
+                continue;
+            }
+        }
+        result.push_back(kernel);
+    }
+    return result;
+}
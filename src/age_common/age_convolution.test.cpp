@@ -0,0 +1,166 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <gfx/age_convolution.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+
+
+namespace
+{
+    constexpr int image_size = 12;
+
+    using image = std::vector<double>;
+
+    image create_image()
+    {
+        std::mt19937                           random(0x4711);
+        std::uniform_real_distribution<double> distribution(0, 1);
+
+        image result(image_size * image_size);
+        std::generate(begin(result), end(result), [&] { return distribution(random); });
+        return result;
+    }
+
+    //! apply the kernel like a post-processing step rendering to a frame buffer:
+    //! texel reads are clamped to the image's edges, results are clamped to [0, 1]
+    image convolve_image(const image& img, const age::convolution_kernel& kernel)
+    {
+        image result(img.size());
+        for (int y = 0; y < image_size; ++y)
+        {
+            for (int x = 0; x < image_size; ++x)
+            {
+                double value = 0;
+                for (const auto& [offset, weight] : kernel)
+                {
+                    int tx = std::clamp(x + offset.first, 0, image_size - 1);
+                    int ty = std::clamp(y + offset.second, 0, image_size - 1);
+                    value += img[ty * image_size + tx] * weight;
+                }
+                result[y * image_size + x] = std::clamp(value, 0.0, 1.0);
+            }
+        }
+        return result;
+    }
+
+    image convolve_image(const image& img, const std::vector<age::convolution_kernel>& kernels)
+    {
+        image result = img;
+        for (const auto& kernel : kernels)
+        {
+            result = convolve_image(result, kernel);
+        }
+        return result;
+    }
+
+    double max_difference(const image& img1, const image& img2)
+    {
+        double result = 0;
+        for (size_t i = 0; i < img1.size(); ++i)
+        {
+            result = std::max(result, std::abs(img1[i] - img2[i]));
+        }
+        return result;
+    }
+
+    double sum_of_weights(const age::convolution_kernel& kernel)
+    {
+        return std::accumulate(begin(kernel), end(kernel), 0.0, [](double sum, const auto& tap) {
+            return sum + tap.second;
+        });
+    }
+
+} // namespace
+
+
+
+TEST(AgeConvolution, FusesSeparableGauss3x3)
+{
+    std::vector<age::convolution_kernel> kernels{age::convolution_gauss3x3_s, age::convolution_gauss3x3_t};
+
+    auto fused = age::fuse_convolution_kernels(kernels);
+    ASSERT_EQ(fused.size(), 1);
+    EXPECT_EQ(fused[0].size(), 9);
+    EXPECT_NEAR(sum_of_weights(fused[0]), 1.0, 1e-9);
+    EXPECT_LT(max_difference(convolve_image(create_image(), kernels), convolve_image(create_image(), fused)), 1e-12);
+}
+
+TEST(AgeConvolution, FusesSeparableGauss5x5)
+{
+    std::vector<age::convolution_kernel> kernels{age::convolution_gauss5x5_s, age::convolution_gauss5x5_t};
+
+    auto fused = age::fuse_convolution_kernels(kernels);
+    ASSERT_EQ(fused.size(), 1);
+    EXPECT_EQ(fused[0].size(), 25);
+    EXPECT_NEAR(sum_of_weights(fused[0]), 1.0, 1e-9);
+    EXPECT_LT(max_difference(convolve_image(create_image(), kernels), convolve_image(create_image(), fused)), 1e-12);
+}
+
+TEST(AgeConvolution, FusesOwnTexelKernel)
+{
+    age::convolution_kernel              own_texel{{{0, 0}, 1.0}};
+    std::vector<age::convolution_kernel> kernels{age::convolution_emboss3x3, own_texel, own_texel};
+
+    // the emboss kernel's negative weights prevent fusing the kernels following it
+    auto fused = age::fuse_convolution_kernels(kernels);
+    ASSERT_EQ(fused.size(), 2);
+
+    fused = age::fuse_convolution_kernels({own_texel, age::convolution_emboss3x3});
+    ASSERT_EQ(fused.size(), 1);
+    EXPECT_EQ(fused[0], age::convolution_emboss3x3);
+}
+
+TEST(AgeConvolution, KeepsStepsChangingTheResult)
+{
+    // fusing gauss and emboss would change the result at the image's edges
+    std::vector<age::convolution_kernel> kernels{age::convolution_gauss3x3_s, age::convolution_gauss3x3_t, age::convolution_emboss3x3};
+    EXPECT_GT(max_difference(convolve_image(create_image(), kernels),
+                             convolve_image(create_image(), age::convolve(age::convolve(kernels[0], kernels[1]), kernels[2]))),
+              1e-3);
+
+    auto fused = age::fuse_convolution_kernels(kernels);
+    ASSERT_EQ(fused.size(), 2);
+    EXPECT_LT(max_difference(convolve_image(create_image(), kernels), convolve_image(create_image(), fused)), 1e-12);
+
+    // fusing emboss and gauss would not clamp the emboss results
+    fused = age::fuse_convolution_kernels({age::convolution_emboss5x5, age::convolution_gauss3x3_s, age::convolution_gauss3x3_t});
+    EXPECT_EQ(fused.size(), 2);
+}
+
+TEST(AgeConvolution, LimitsFusedKernelSize)
+{
+    // 5 * 7 taps
+    age::convolution_kernel vertical_box7;
+    for (int y = -3; y <= 3; ++y)
+    {
+        vertical_box7[{0, y}] = 1.0 / 7;
+    }
+    auto fused = age::fuse_convolution_kernels({age::convolution_gauss5x5_s, vertical_box7});
+    EXPECT_EQ(fused.size(), 2);
+
+    // 5 * 3 taps
+    fused = age::fuse_convolution_kernels({age::convolution_gauss5x5_s, age::convolution_gauss3x3_t});
+    ASSERT_EQ(fused.size(), 1);
+    EXPECT_EQ(fused[0].size(), 15);
+}
@@ -0,0 +1,84 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <pcm/age_downsampler.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+
+
+namespace
+{
+    constexpr int input_sampling_rate  = 2097152;
+    constexpr int output_sampling_rate = 48000;
+    constexpr int samples_per_frame    = 35112; // samples created by the emulator per frame
+
+    age::pcm_vector create_noise()
+    {
+        std::mt19937    random(0x4711);
+        age::pcm_vector samples;
+        for (int i = 0; i < samples_per_frame; ++i)
+        {
+            samples.emplace_back(static_cast<int16_t>(random()), static_cast<int16_t>(random()));
+        }
+        return samples;
+    }
+
+    //!
+    //! Downsample one frame's worth of samples per iteration
+    //! using the ripple 1/range(0) (age_qt_gui uses 0.1 and 0.01).
+    //! The counter "time/sample" is the time spent per output sample.
+    //!
+    template<typename Downsampler>
+    void downsample_frames(benchmark::State& state)
+    {
+        Downsampler downsampler(input_sampling_rate, output_sampling_rate, 1.0 / static_cast<double>(state.range(0)));
+        auto        samples = create_noise();
+
+        int64_t output_samples = 0;
+        for (auto _ : state)
+        {
+            downsampler.add_input_samples(samples);
+            output_samples += static_cast<int64_t>(downsampler.get_output_samples().size());
+            downsampler.clear_output_samples();
+        }
+        state.counters["time/sample"] = benchmark::Counter(static_cast<double>(output_samples),
+                                                           benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+} // namespace
+
+
+
+void BM_DownsamplerKaiserLowPass(benchmark::State& state)
+{
+    downsample_frames<age::downsampler_kaiser_low_pass>(state);
+}
+BENCHMARK(BM_DownsamplerKaiserLowPass)->ArgName("inv_ripple")->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_DownsamplerPolyphase(benchmark::State& state)
+{
+    downsample_frames<age::downsampler_polyphase>(state);
+}
+BENCHMARK(BM_DownsamplerPolyphase)->ArgName("inv_ripple")->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_DownsamplerMultistage(benchmark::State& state)
+{
+    downsample_frames<age::downsampler_multistage>(state);
+}
+BENCHMARK(BM_DownsamplerMultistage)->ArgName("inv_ripple")->Arg(10)->Arg(100)->Arg(1000);
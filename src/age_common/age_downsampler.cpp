@@ -17,10 +17,19 @@
 #include <pcm/age_downsampler.hpp>
 
 #include <algorithm> // std::min, ...
+#include <array>
 #include <cassert>
 #include <cmath>     // std::pow, std::log10, ...
 #include <numbers>
 
+#if defined(__AVX2__)
+#define AGE_DOWNSAMPLER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define AGE_DOWNSAMPLER_SSE2
+#include <emmintrin.h>
+#endif
+
 
 
 
@@ -32,7 +41,8 @@
 //---------------------------------------------------------
 
 age::downsampler::downsampler(int input_sampling_rate, int output_sampling_rate)
-    : m_input_output_ratio(calculate_ratio(input_sampling_rate, output_sampling_rate))
+    : m_input_output_ratio(calculate_ratio(input_sampling_rate, output_sampling_rate)),
+      m_nominal_input_output_ratio(m_input_output_ratio)
 {
     assert(m_input_output_ratio > 0x10000); // we're downsampling
 }
@@ -54,6 +64,16 @@ void age::downsampler::set_volume(float volume)
     m_volume = std::min(1.F, std::max(0.F, volume));
 }
 
+void age::downsampler::set_ratio_correction(double correction)
+{
+    assert(correction > 0);
+    double ratio = std::round(m_nominal_input_output_ratio * correction);
+
+    assert(ratio > 0x10000); // we're still downsampling
+    assert(ratio < int_max);
+    m_input_output_ratio = static_cast<int>(ratio);
+}
+
 void age::downsampler::add_output_samples(int16_t left_sample, int16_t right_sample)
 {
     add_output_samples(pcm_frame(left_sample, right_sample));
@@ -302,68 +322,135 @@ double age::downsampler_low_pass::calculate_sinc(double n, int filter_order, dou
 //    between samples of the FIR stored in a table.
 //
 
-age::downsampler_kaiser_low_pass::downsampler_kaiser_low_pass(int input_sampling_rate, int output_sampling_rate, double ripple)
-    : downsampler_low_pass(input_sampling_rate, output_sampling_rate)
+namespace
 {
-    //
-    //           lowpass filter using a kaiser window
-    //                         based on
-    //   http://www.labbookpages.co.uk/audio/firWindowing.html
-    // ---------------------------------------------------------
-    //
-    // - Depending on the filter order the transition band around the
-    //   transition frequency may be wider or smaller, but it's
-    //   always there.
-    //      -> A smaller transition band requires more calculations
-    //         since the FIR grows.
-    //
-    // - If possible, we include all frequencies up to 15 Khz in the
-    //   passband and use the gap between 15 Khz and the Nyquist
-    //   Frequency as transition band.
-    //      -> Attenuated frequencies in the transition band are kept
-    //         in the not audible range.
-    //      -> The stopband (beginning right after the transition band)
-    //         contains all frequencies that would add aliasing.
-    //
-
-    // Use the maximal audible frequency to limit the passband,
-    // if the output sampling rate allows it.
-    // (According to Wikipedia this should actually be 20000 hz,
-    // but we use 15000 hz for a smaller FIR)
-    constexpr int max_audible_frequency_hz = 15000;
-
-    // calculate the Nyquist Frequency
-    int nyquist_frequency_hz = output_sampling_rate >> 1;
-
-    // calculate the transition width:
-    //  - not smaller than 10% of the Nyquist Frequency
-    //  - for higher output sampling rates use the range [max_audible;nyquist]
-    int transition_width_hz = nyquist_frequency_hz / 10;
-    if (max_audible_frequency_hz + transition_width_hz < nyquist_frequency_hz)
+    struct kaiser_parameters
+    {
+        double m_transition_frequency = 0; //!< relative to the input sampling rate
+        int    m_filter_order         = 0;
+        double m_beta                 = 0;
+    };
+
+    int calculate_filter_order(double A, double tw)
+    {
+        double dM = (A > 21.0)
+                        ? (A - 7.95) / (2.285 * tw)
+                        : 5.79 / tw;
+
+        assert(dM < age::int_max);
+        int M = static_cast<int>(dM) + 1;
+        return M;
+    }
+
+    double calculate_beta(double A)
     {
-        transition_width_hz = nyquist_frequency_hz - max_audible_frequency_hz;
+        if (A > 50)
+        {
+            return 0.1102 * (A - 8.7);
+        }
+        if (A > 21)
+        {
+            double beta = 0.5842 * std::pow(A - 21, 0.4);
+            return beta + (0.07886 * (A - 21));
+        }
+        return 0;
     }
 
-    double transition_width = transition_width_hz;
-    transition_width /= input_sampling_rate; // we're creating the FIR for the input signal
-    assert(transition_width < 0.5);
+    double calculate_bessel(double value)
+    {
+        double result = 1;
+
+        value /= 2;
+        double factorial = 1;
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            double v1 = std::pow(value, 2 * i);
+            double v2 = factorial * factorial;
+
+            result += v1 / v2;
+
+            factorial *= i;
+        }
+
+        return result;
+    }
+
+    kaiser_parameters calculate_kaiser_parameters(int input_sampling_rate, int output_sampling_rate, double ripple)
+    {
+        //
+        //           lowpass filter using a kaiser window
+        //                         based on
+        //   http://www.labbookpages.co.uk/audio/firWindowing.html
+        // ---------------------------------------------------------
+        //
+        // - Depending on the filter order the transition band around the
+        //   transition frequency may be wider or smaller, but it's
+        //   always there.
+        //      -> A smaller transition band requires more calculations
+        //         since the FIR grows.
+        //
+        // - If possible, we include all frequencies up to 15 Khz in the
+        //   passband and use the gap between 15 Khz and the Nyquist
+        //   Frequency as transition band.
+        //      -> Attenuated frequencies in the transition band are kept
+        //         in the not audible range.
+        //      -> The stopband (beginning right after the transition band)
+        //         contains all frequencies that would add aliasing.
+        //
+
+        // Use the maximal audible frequency to limit the passband,
+        // if the output sampling rate allows it.
+        // (According to Wikipedia this should actually be 20000 hz,
+        // but we use 15000 hz for a smaller FIR)
+        constexpr int max_audible_frequency_hz = 15000;
+
+        // calculate the Nyquist Frequency
+        int nyquist_frequency_hz = output_sampling_rate >> 1;
+
+        // calculate the transition width:
+        //  - not smaller than 10% of the Nyquist Frequency
+        //  - for higher output sampling rates use the range [max_audible;nyquist]
+        int transition_width_hz = nyquist_frequency_hz / 10;
+        if (max_audible_frequency_hz + transition_width_hz < nyquist_frequency_hz)
+        {
+            transition_width_hz = nyquist_frequency_hz - max_audible_frequency_hz;
+        }
+
+        double transition_width = transition_width_hz;
+        transition_width /= input_sampling_rate; // we're creating the FIR for the input signal
+        assert(transition_width < 0.5);
+
+        // calculate transition frequency that marks the
+        // center of the transition band
+        int    transition_frequency_hz = nyquist_frequency_hz - transition_width_hz / 2;
+        double transition_frequency    = transition_frequency_hz;
+        transition_frequency /= input_sampling_rate; // we're creating the FIR for the input signal
+        assert(transition_width < 0.5);
+
+        // calculate Kaiser Window parameters
+        double A  = -20 * std::log10(ripple);
+        double tw = 2 * std::numbers::pi * transition_width;
+
+        int M = calculate_filter_order(A, tw);
+        M += M & 1; // make even
+
+        return {.m_transition_frequency = transition_frequency,
+                .m_filter_order         = M,
+                .m_beta                 = calculate_beta(A)};
+    }
+
+} // namespace
 
-    // calculate transition frequency that marks the
-    // center of the transition band
-    int    transition_frequency_hz = nyquist_frequency_hz - transition_width_hz / 2;
-    double transition_frequency    = transition_frequency_hz;
-    transition_frequency /= input_sampling_rate; // we're creating the FIR for the input signal
-    assert(transition_width < 0.5);
 
-    // calculate Kaiser Window parameters
-    double A  = -20 * std::log10(ripple);
-    double tw = 2 * std::numbers::pi * transition_width;
 
-    int M = calculate_filter_order(A, tw);
-    M += M & 1; // make even
-    double beta = calculate_beta(A);
+age::downsampler_kaiser_low_pass::downsampler_kaiser_low_pass(int input_sampling_rate, int output_sampling_rate, double ripple)
+    : downsampler_low_pass(input_sampling_rate, output_sampling_rate)
+{
+    auto params = calculate_kaiser_parameters(input_sampling_rate, output_sampling_rate, ripple);
 
     // window weight value calculation method
+    double beta        = params.m_beta;
     double beta_bessel = calculate_bessel(beta);
 
     auto window_weight = [=](double n, int filter_order) {
@@ -376,56 +463,509 @@ age::downsampler_kaiser_low_pass::downsampler_kaiser_low_pass(int input_sampling
     };
 
     // calculate filter values
-    create_windowed_sinc(transition_frequency, M, window_weight);
+    create_windowed_sinc(params.m_transition_frequency, params.m_filter_order, window_weight);
 }
 
 
 
-int age::downsampler_kaiser_low_pass::calculate_filter_order(double A, double tw)
+
+
+//---------------------------------------------------------
+//
+//   downsampler_polyphase
+//
+//---------------------------------------------------------
+
+//
+// Each output sample is calculated at the exact (fractional) position
+// of the input signal it represents:
+//
+//      y(T) = sum( x[I - k] * h(k + f) ),  k = 0 ... fir_size - 1
+//
+//  with T = I + f being the output sample's position (I integer, 0 <= f < 1)
+//  and h being the continuous Kaiser low pass FIR.
+//
+//  - h(k + f) is precomputed for 2^phase_bits values of f (phases),
+//    we use the phase closest to (but not bigger than) f.
+//
+//  - All values are stored as float and multiplied in blocks of 8 values
+//    using SSE2 or AVX2 instructions, if available.
+//
+
+age::downsampler_polyphase::downsampler_polyphase(int input_sampling_rate, int output_sampling_rate, double ripple)
+    : downsampler(input_sampling_rate, output_sampling_rate)
 {
-    double dM = (A > 21.0)
-                    ? (A - 7.95) / (2.285 * tw)
-                    : 5.79 / tw;
+    auto   params      = calculate_kaiser_parameters(input_sampling_rate, output_sampling_rate, ripple);
+    double beta_bessel = calculate_bessel(params.m_beta);
 
-    assert(dM < int_max);
-    int M = static_cast<int>(dM) + 1;
-    return M;
+    // round up to a multiple of 8 for SIMD
+    m_fir_size = (params.m_filter_order + 1 + 7) & ~7;
+
+    // The FIR covers the range [0; m_fir_size] with its center
+    // at m_fir_size / 2.
+    // Phase values are stored in reverse order to match the history
+    // buffer's order (oldest sample first).
+    double fir_size = m_fir_size;
+    double fc2      = 2 * params.m_transition_frequency;
+
+    m_fir_phases.resize(static_cast<size_t>(phases * m_fir_size));
+    for (int p = 0; p < phases; ++p)
+    {
+        auto   phase_begin = m_fir_phases.begin() + p * m_fir_size;
+        double sum         = 0;
+
+        for (int i = 0; i < m_fir_size; ++i)
+        {
+            double t = (m_fir_size - 1 - i) + static_cast<double>(p) / phases;
+
+            double v    = (t - fir_size / 2) * std::numbers::pi;
+            double sinc = ((v > 0) || (v < 0)) ? std::sin(fc2 * v) / v : fc2;
+
+            double w      = 2 * t / fir_size - 1;
+            double weight = calculate_bessel(params.m_beta * std::sqrt(1 - w * w)) / beta_bessel;
+
+            double value       = sinc * weight;
+            *(phase_begin + i) = static_cast<float>(value);
+            sum += value;
+        }
+
+        // normalize each phase to unity gain to not modulate the
+        // signal with the phase changes
+        std::for_each(phase_begin, phase_begin + m_fir_size, [=](float& f) {
+            f = static_cast<float>(f / sum);
+        });
+    }
+
+    // start with silence
+    m_history_size = m_fir_size;
+    m_history_left.resize(static_cast<size_t>(m_fir_size + history_chunk));
+    m_history_right.resize(static_cast<size_t>(m_fir_size + history_chunk));
+
+    // the first output sample is located at the first input sample
+    m_next_output_distance = 0x10000;
+}
+
+
+
+age::size_t age::downsampler_polyphase::get_fir_size() const
+{
+    return static_cast<size_t>(m_fir_size);
 }
 
 
 
-double age::downsampler_kaiser_low_pass::calculate_beta(double A)
+void age::downsampler_polyphase::add_input_samples(const pcm_vector& samples)
 {
-    if (A > 50)
+    assert(samples.size() < int_max);
+    const int samples_size = static_cast<int>(samples.size());
+
+    int sample_idx = 0;
+    while (sample_idx < samples_size)
     {
-        return 0.1102 * (A - 8.7);
+        // history buffer full?
+        auto history_capacity = static_cast<int>(m_history_left.size());
+        if (m_history_size >= history_capacity)
+        {
+            auto keep_from = m_history_left.begin() + (m_history_size - m_fir_size);
+            std::copy(keep_from, m_history_left.begin() + m_history_size, m_history_left.begin());
+            keep_from = m_history_right.begin() + (m_history_size - m_fir_size);
+            std::copy(keep_from, m_history_right.begin() + m_history_size, m_history_right.begin());
+            m_history_size = m_fir_size;
+        }
+
+        // add all samples up to the next output sample's position
+        assert(m_next_output_distance >= 0x10000);
+        int count = std::min({m_next_output_distance >> 16,
+                              samples_size - sample_idx,
+                              history_capacity - m_history_size});
+
+        add_history_samples(samples.data() + sample_idx, count);
+        sample_idx += count;
+        m_next_output_distance -= count << 16;
+
+        // output sample located between the last and the next input sample?
+        if (m_next_output_distance < 0x10000)
+        {
+            add_output_sample(m_next_output_distance >> (16 - phase_bits));
+            m_next_output_distance += m_input_output_ratio;
+        }
     }
-    if (A > 21)
+}
+
+
+
+void age::downsampler_polyphase::add_history_samples(const pcm_frame* samples, int count)
+{
+    assert(m_history_size + count <= static_cast<int>(m_history_left.size()));
+
+    float* left  = m_history_left.data() + m_history_size;
+    float* right = m_history_right.data() + m_history_size;
+
+    for (int i = 0; i < count; ++i)
     {
-        double beta = 0.5842 * std::pow(A - 21, 0.4);
-        return beta + (0.07886 * (A - 21));
+        left[i]  = samples[i].m_left_sample;
+        right[i] = samples[i].m_right_sample;
     }
-    return 0;
+    m_history_size += count;
 }
 
 
 
-double age::downsampler_kaiser_low_pass::calculate_bessel(double value)
+void age::downsampler_polyphase::add_output_sample(int phase)
 {
-    double result = 1;
+    assert(phase >= 0);
+    assert(phase < phases);
+
+    // the last m_fir_size input samples, oldest sample first
+    const float* left  = m_history_left.data() + (m_history_size - m_fir_size);
+    const float* right = m_history_right.data() + (m_history_size - m_fir_size);
+    const float* fir   = m_fir_phases.data() + phase * m_fir_size;
+
+    float result_left  = 0;
+    float result_right = 0;
 
-    value /= 2;
-    double factorial = 1;
+#if defined(AGE_DOWNSAMPLER_AVX2)
 
-    for (int i = 1; i <= 10; ++i)
+    __m256 acc_left  = _mm256_setzero_ps();
+    __m256 acc_right = _mm256_setzero_ps();
+    for (int i = 0; i < m_fir_size; i += 8)
     {
-        double v1 = std::pow(value, 2 * i);
-        double v2 = factorial * factorial;
+        __m256 f  = _mm256_loadu_ps(fir + i);
+        acc_left  = _mm256_add_ps(acc_left, _mm256_mul_ps(_mm256_loadu_ps(left + i), f));
+        acc_right = _mm256_add_ps(acc_right, _mm256_mul_ps(_mm256_loadu_ps(right + i), f));
+    }
+    std::array<float, 8> lanes_left{};
+    std::array<float, 8> lanes_right{};
+    _mm256_storeu_ps(lanes_left.data(), acc_left);
+    _mm256_storeu_ps(lanes_right.data(), acc_right);
+
+#elif defined(AGE_DOWNSAMPLER_SSE2)
+
+    // two accumulators per channel to hide the addition latency
+    __m128 acc_left0  = _mm_setzero_ps();
+    __m128 acc_left1  = _mm_setzero_ps();
+    __m128 acc_right0 = _mm_setzero_ps();
+    __m128 acc_right1 = _mm_setzero_ps();
+    for (int i = 0; i < m_fir_size; i += 8)
+    {
+        __m128 f0  = _mm_loadu_ps(fir + i);
+        __m128 f1  = _mm_loadu_ps(fir + i + 4);
+        acc_left0  = _mm_add_ps(acc_left0, _mm_mul_ps(_mm_loadu_ps(left + i), f0));
+        acc_left1  = _mm_add_ps(acc_left1, _mm_mul_ps(_mm_loadu_ps(left + i + 4), f1));
+        acc_right0 = _mm_add_ps(acc_right0, _mm_mul_ps(_mm_loadu_ps(right + i), f0));
+        acc_right1 = _mm_add_ps(acc_right1, _mm_mul_ps(_mm_loadu_ps(right + i + 4), f1));
+    }
+    std::array<float, 8> lanes_left{};
+    std::array<float, 8> lanes_right{};
+    _mm_storeu_ps(lanes_left.data(), acc_left0);
+    _mm_storeu_ps(lanes_left.data() + 4, acc_left1);
+    _mm_storeu_ps(lanes_right.data(), acc_right0);
+    _mm_storeu_ps(lanes_right.data() + 4, acc_right1);
+
+#else
+
+    std::array<float, 8> lanes_left{};
+    std::array<float, 8> lanes_right{};
+    for (int i = 0; i < m_fir_size; i += 8)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            lanes_left[j] += left[i + j] * fir[i + j];
+            lanes_right[j] += right[i + j] * fir[i + j];
+        }
+    }
 
-        result += v1 / v2;
+#endif
 
-        factorial *= i;
+    for (int j = 0; j < 8; ++j)
+    {
+        result_left += lanes_left[j];
+        result_right += lanes_right[j];
     }
 
-    return result;
+    auto to_int16 = [](float f) {
+        return static_cast<int16_t>(std::clamp(std::lround(f), -32768L, 32767L));
+    };
+    add_output_samples(to_int16(result_left), to_int16(result_right));
+}
+
+
+
+
+
+//---------------------------------------------------------
+//
+//   downsampler_multistage
+//
+//---------------------------------------------------------
+
+//
+// Game Boy 2097152 Hz -> audio device 48000 Hz:
+//
+//  - CIC decimator (4th order):    2097152 Hz -> 262144 Hz
+//  - half-band decimator:           262144 Hz -> 131072 Hz
+//  - half-band decimator:           131072 Hz ->  65536 Hz
+//  - downsampler_polyphase:          65536 Hz ->  48000 Hz
+//
+//  - The CIC decimator's nulls are located at multiples of its output
+//    sampling rate, which is where it would fold back frequencies into
+//    the passband.
+//    Its passband droop stays below 0.2 dB for frequencies up to 15 kHz.
+//
+//  - Every half-band decimator keeps frequencies up to half the output
+//    sampling rate free of aliasing.
+//    As every second FIR value of a half-band FIR is zero, they are
+//    cheap to calculate.
+//
+//  - The polyphase downsampler's FIR is short due to the low input
+//    sampling rate.
+//
+
+age::downsampler_multistage::downsampler_multistage(int input_sampling_rate, int output_sampling_rate, double ripple)
+    : downsampler(input_sampling_rate, output_sampling_rate),
+      m_resampler(input_sampling_rate >> (cic_decimation_bits + calculate_halfband_stages(input_sampling_rate, output_sampling_rate)),
+                  output_sampling_rate,
+                  ripple)
+{
+    int stages        = calculate_halfband_stages(input_sampling_rate, output_sampling_rate);
+    int sampling_rate = input_sampling_rate >> cic_decimation_bits;
+
+    for (int i = 0; i < stages; ++i)
+    {
+        m_halfband_stages.emplace_back(sampling_rate, output_sampling_rate, ripple);
+        sampling_rate >>= 1;
+    }
+}
+
+
+
+age::size_t age::downsampler_multistage::get_fir_size() const
+{
+    size_t fir_size = m_resampler.get_fir_size();
+    for (const auto& stage : m_halfband_stages)
+    {
+        fir_size += stage.get_fir_size();
+    }
+    return fir_size;
+}
+
+void age::downsampler_multistage::set_ratio_correction(double correction)
+{
+    // only the final resampler's ratio is not an integer
+    downsampler::set_ratio_correction(correction);
+    m_resampler.set_ratio_correction(correction);
+}
+
+
+
+void age::downsampler_multistage::add_input_samples(const pcm_vector& samples)
+{
+    decimate_cic(samples);
+
+    for (auto& stage : m_halfband_stages)
+    {
+        stage.decimate(m_stage_left, m_stage_right);
+    }
+
+    m_stage_output.clear();
+    for (size_t i = 0; i < m_stage_left.size(); ++i)
+    {
+        m_stage_output.emplace_back(static_cast<int16_t>(std::clamp(std::lround(m_stage_left[i]), -32768L, 32767L)),
+                                    static_cast<int16_t>(std::clamp(std::lround(m_stage_right[i]), -32768L, 32767L)));
+    }
+
+    m_resampler.add_input_samples(m_stage_output);
+    for (const auto& frame : m_resampler.get_output_samples())
+    {
+        add_output_samples(frame);
+    }
+    m_resampler.clear_output_samples();
+}
+
+
+
+int age::downsampler_multistage::calculate_halfband_stages(int input_sampling_rate, int output_sampling_rate)
+{
+    int sampling_rate = input_sampling_rate >> cic_decimation_bits;
+    assert(sampling_rate > output_sampling_rate);
+
+    // leave a transition band of at least 25% of the output sampling rate
+    int stages = 0;
+    while ((sampling_rate >> 1) >= output_sampling_rate + output_sampling_rate / 4)
+    {
+        sampling_rate >>= 1;
+        ++stages;
+    }
+    return stages;
+}
+
+
+
+void age::downsampler_multistage::decimate_cic(const pcm_vector& samples)
+{
+    constexpr int cic_decimation = 1 << cic_decimation_bits;
+    constexpr int cic_gain_bits  = cic_order * cic_decimation_bits;
+
+    m_stage_left.resize((samples.size() + static_cast<size_t>(m_cic_phase)) >> cic_decimation_bits);
+    m_stage_right.resize(m_stage_left.size());
+
+    // work on local copies to keep the values in registers
+    auto integrators = m_cic_integrators;
+    auto combs       = m_cic_combs;
+    int  phase       = m_cic_phase;
+    int  output_idx  = 0;
+
+    // Integrators and combs rely on unsigned integer wrap-around,
+    // which cancels out as long as the result fits into 32 bits.
+    for (const auto& sample : samples)
+    {
+        auto left  = static_cast<uint32_t>(static_cast<int32_t>(sample.m_left_sample));
+        auto right = static_cast<uint32_t>(static_cast<int32_t>(sample.m_right_sample));
+        for (size_t i = 0; i < cic_order; ++i)
+        {
+            integrators[i] += left;
+            integrators[i + cic_order] += right;
+            left  = integrators[i];
+            right = integrators[i + cic_order];
+        }
+
+        ++phase;
+        if (phase < cic_decimation)
+        {
+            continue;
+        }
+        phase = 0;
+
+        for (size_t i = 0; i < cic_order; ++i)
+        {
+            uint32_t comb_left  = left - combs[i];
+            uint32_t comb_right = right - combs[i + cic_order];
+
+            combs[i]             = left;
+            combs[i + cic_order] = right;
+            left                 = comb_left;
+            right                = comb_right;
+        }
+
+        auto idx           = static_cast<size_t>(output_idx++);
+        m_stage_left[idx]  = static_cast<float>(static_cast<int32_t>(left) >> cic_gain_bits);
+        m_stage_right[idx] = static_cast<float>(static_cast<int32_t>(right) >> cic_gain_bits);
+    }
+    assert(static_cast<size_t>(output_idx) == m_stage_left.size());
+
+    m_cic_integrators = integrators;
+    m_cic_combs       = combs;
+    m_cic_phase       = phase;
+}
+
+
+
+age::downsampler_multistage::halfband_stage::halfband_stage(int input_sampling_rate, int output_sampling_rate, double ripple)
+{
+    // Keep the range [0; output_sampling_rate / 2] free of aliasing.
+    // The transition band is centered around input_sampling_rate / 4,
+    // which makes every second FIR value zero (half-band FIR).
+    int transition_width_hz = (input_sampling_rate >> 1) - output_sampling_rate;
+    assert(transition_width_hz > 0);
+
+    double A  = -20 * std::log10(ripple);
+    double tw = 2 * std::numbers::pi * transition_width_hz / input_sampling_rate;
+
+    // FIR values h(-K) ... h(K) with K being odd
+    // (h(K) would be zero for even K)
+    int K = calculate_filter_order(A, tw) / 2;
+    K |= 1;
+
+    double beta        = calculate_beta(A);
+    double beta_bessel = calculate_bessel(beta);
+    double sum         = 0;
+
+    for (int k = 1; k <= K; k += 2)
+    {
+        double v      = k * std::numbers::pi;
+        double sinc   = std::sin(v / 2) / v;
+        double w      = static_cast<double>(k) / K;
+        double weight = calculate_bessel(beta * std::sqrt(1 - w * w)) / beta_bessel;
+
+        m_fir_odd.push_back(static_cast<float>(sinc * weight));
+        sum += sinc * weight;
+    }
+
+    // normalize to unity gain: h(0) + 2 * sum(h(k)) = 1
+    for (auto& f : m_fir_odd)
+    {
+        f = static_cast<float>(f * 0.25 / sum);
+    }
+
+    for (auto* history : {&m_history_left, &m_history_right})
+    {
+        history->m_samples.resize(get_fir_size() * 2, 0);
+        history->m_samples_needed = get_fir_size();
+    }
+}
+
+
+
+age::size_t age::downsampler_multistage::halfband_stage::get_fir_size() const
+{
+    return m_fir_odd.size() * 4 - 1;
+}
+
+
+
+void age::downsampler_multistage::halfband_stage::decimate(std::vector<float>& left, std::vector<float>& right)
+{
+    assert(left.size() == right.size());
+    decimate(left, m_history_left);
+    decimate(right, m_history_right);
+}
+
+
+
+void age::downsampler_multistage::halfband_stage::decimate(std::vector<float>& samples, history& history) const
+{
+    int          K        = static_cast<int>(m_fir_odd.size()) * 2 - 1;
+    size_t       fir_size = get_fir_size();
+    const float* fir      = m_fir_odd.data();
+    float*       buffer   = history.m_samples.data();
+
+    // local copies for the compiler to keep them in registers
+    size_t write_idx      = history.m_write_idx;
+    size_t samples_needed = history.m_samples_needed;
+
+    // The output replaces the input samples already consumed,
+    // as there is at most one output sample per two input samples.
+    size_t output_idx = 0;
+    size_t size       = samples.size();
+    for (size_t i = 0; i < size;)
+    {
+        // store the samples required for the next output
+        size_t count = std::min(samples_needed, size - i);
+        for (size_t end = i + count; i < end; ++i)
+        {
+            buffer[write_idx]            = samples[i];
+            buffer[write_idx + fir_size] = samples[i];
+            write_idx                    = (write_idx + 1 == fir_size) ? 0 : write_idx + 1;
+        }
+        samples_needed -= count;
+        if (samples_needed > 0)
+        {
+            break;
+        }
+        samples_needed = 2; // output every second sample
+
+        // the last fir_size samples start at write_idx
+        const float* center = buffer + write_idx + K;
+
+        float result = 0.5F * center[0];
+        for (int j = 0, k = 1; k <= K; ++j, k += 2)
+        {
+            result += fir[j] * (center[-k] + center[k]);
+        }
+        samples[output_idx++] = result;
+    }
+
+    history.m_write_idx      = write_idx;
+    history.m_samples_needed = samples_needed;
+    samples.resize(output_idx);
 }
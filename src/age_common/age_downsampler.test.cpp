@@ -0,0 +1,170 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <pcm/age_downsampler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+
+
+
+namespace
+{
+    constexpr int input_sampling_rate  = 2097152;
+    constexpr int output_sampling_rate = 48000;
+
+    //! downsample a sine wave (one second by default) and return the output's RMS
+    double downsample_sine(age::downsampler& downsampler, double frequency_hz, double amplitude, int input_samples = input_sampling_rate)
+    {
+        age::pcm_vector samples;
+        for (int i = 0; i < input_samples; ++i)
+        {
+            double v = amplitude * std::sin(2 * std::numbers::pi * frequency_hz * i / input_sampling_rate);
+            auto   s = static_cast<int16_t>(v);
+            samples.emplace_back(s, s);
+
+            // feed the downsampler in chunks like the emulator does
+            if (samples.size() >= 35000)
+            {
+                downsampler.add_input_samples(samples);
+                samples.clear();
+            }
+        }
+        downsampler.add_input_samples(samples);
+
+        // skip the FIR's settling time
+        const auto& output = downsampler.get_output_samples();
+        double      sum    = 0;
+        for (size_t i = 1000; i < output.size(); ++i)
+        {
+            double left = output[i].m_left_sample;
+            sum += left * left;
+        }
+        return std::sqrt(sum / static_cast<double>(output.size() - 1000));
+    }
+
+    //! downsample a sine wave and return the resulting gain in dB
+    double downsample_sine_db(age::downsampler& downsampler, double frequency_hz)
+    {
+        constexpr double amplitude = 16000;
+        double           rms       = downsample_sine(downsampler, frequency_hz, amplitude, input_sampling_rate / 4);
+        return 20 * std::log10(rms * std::numbers::sqrt2 / amplitude);
+    }
+
+} // namespace
+
+
+
+TEST(AgeDownsamplerPolyphase, CreatesExpectedNumberOfSamples)
+{
+    age::downsampler_polyphase downsampler(input_sampling_rate, output_sampling_rate, 0.01);
+    downsample_sine(downsampler, 1000, 10000);
+
+    auto output_size = static_cast<int>(downsampler.get_output_samples().size());
+    EXPECT_NEAR(output_size, output_sampling_rate, 2);
+}
+
+TEST(AgeDownsamplerPolyphase, KeepsPassbandAndAttenuatesStopband)
+{
+    constexpr double amplitude = 16000;
+    const double     sine_rms  = amplitude / std::numbers::sqrt2;
+
+    age::downsampler_polyphase passband(input_sampling_rate, output_sampling_rate, 0.01);
+    EXPECT_NEAR(downsample_sine(passband, 1000, amplitude), sine_rms, sine_rms * 0.01);
+
+    age::downsampler_polyphase stopband(input_sampling_rate, output_sampling_rate, 0.01);
+    EXPECT_LT(downsample_sine(stopband, 40000, amplitude), sine_rms * 0.01);
+}
+
+
+
+TEST(AgeDownsamplerMultistage, CreatesExpectedNumberOfSamples)
+{
+    age::downsampler_multistage downsampler(input_sampling_rate, output_sampling_rate, 0.01);
+    downsample_sine(downsampler, 1000, 10000);
+
+    // the half-band stages delay the output by a few samples
+    auto output_size = static_cast<int>(downsampler.get_output_samples().size());
+    EXPECT_NEAR(output_size, output_sampling_rate, 10);
+}
+
+TEST(AgeDownsamplerMultistage, OutputDoesNotDependOnInputChunks)
+{
+    std::mt19937    random(0x1234);
+    age::pcm_vector input(100000);
+    for (auto& frame : input)
+    {
+        frame = age::pcm_frame(static_cast<age::int16_t>(random()), static_cast<age::int16_t>(random()));
+    }
+
+    age::downsampler_multistage expected(input_sampling_rate, output_sampling_rate, 0.01);
+    expected.add_input_samples(input);
+
+    for (size_t chunk_size : {1, 7, 8, 4097})
+    {
+        age::downsampler_multistage downsampler(input_sampling_rate, output_sampling_rate, 0.01);
+        for (size_t i = 0; i < input.size(); i += chunk_size)
+        {
+            auto last = std::min(i + chunk_size, input.size());
+            downsampler.add_input_samples(age::pcm_vector(input.begin() + static_cast<std::ptrdiff_t>(i),
+                                                          input.begin() + static_cast<std::ptrdiff_t>(last)));
+        }
+        EXPECT_EQ(downsampler.get_output_samples(), expected.get_output_samples()) << "chunk size " << chunk_size;
+    }
+}
+
+TEST(AgeDownsamplerMultistage, PassbandRipple)
+{
+    // measured: gain between -0.21 dB (15 kHz) and +0.01 dB (100 Hz)
+    double min_db = 0;
+    double max_db = -100;
+    for (double frequency_hz : {100, 1000, 5000, 10000, 15000})
+    {
+        age::downsampler_multistage downsampler(input_sampling_rate, output_sampling_rate, 0.01);
+        double                      db = downsample_sine_db(downsampler, frequency_hz);
+        min_db                         = std::min(min_db, db);
+        max_db                         = std::max(max_db, db);
+    }
+    EXPECT_LT(max_db - min_db, 0.3);
+    EXPECT_GT(min_db, -0.3);
+}
+
+TEST(AgeDownsamplerMultistage, StopbandAttenuation)
+{
+    // Frequencies above 33 kHz would fold back into the 15 kHz passband.
+    // Measured attenuation: at least 72 dB (70 kHz),
+    // everything else reaches the 16 bit noise floor (about -84 dB).
+    for (double frequency_hz : {33000, 40000, 70000, 100000, 257144, 521288})
+    {
+        age::downsampler_multistage downsampler(input_sampling_rate, output_sampling_rate, 0.01);
+        EXPECT_LT(downsample_sine_db(downsampler, frequency_hz), -70) << frequency_hz << " Hz";
+    }
+}
+
+TEST(AgeDownsamplerMultistage, AppliesRatioCorrection)
+{
+    // +0.5% input/output ratio => -0.5% output samples
+    age::downsampler_multistage downsampler(input_sampling_rate, output_sampling_rate, 0.01);
+    downsampler.set_ratio_correction(1.005);
+    downsample_sine(downsampler, 1000, 10000);
+
+    auto output_size = static_cast<int>(downsampler.get_output_samples().size());
+    EXPECT_NEAR(output_size, output_sampling_rate / 1.005, 10);
+}
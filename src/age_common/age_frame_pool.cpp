@@ -0,0 +1,56 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gfx/age_frame_pool.hpp>
+
+
+
+bool age::frame_pool::publish_frame(const pixel_vector& pixels, uint64_t hash)
+{
+    // The frame written to may still contain the same screen,
+    // e.g. if the screen did not change for some frames.
+    pool_frame& frame = m_frames[m_write_idx];
+    if ((frame.m_hash != hash) || (frame.m_pixels.size() != pixels.size()))
+    {
+        // no allocation after the first frame
+        frame.m_pixels.assign(pixels.begin(), pixels.end());
+        frame.m_hash = hash;
+    }
+
+    // release our frame to the consumer,
+    // acquire the frame the consumer is done with
+    unsigned previous_idx = m_shared_idx.exchange(m_write_idx | frame_fresh, std::memory_order_acq_rel);
+    m_write_idx           = previous_idx & frame_idx_mask;
+
+    return (previous_idx & frame_fresh) == 0;
+}
+
+
+
+const age::pool_frame* age::frame_pool::take_frame()
+{
+    if ((m_shared_idx.load(std::memory_order_relaxed) & frame_fresh) == 0)
+    {
+        return nullptr;
+    }
+
+    // only the producer sets the fresh flag,
+    // so it is still set
+    unsigned shared_idx = m_shared_idx.exchange(m_read_idx, std::memory_order_acq_rel);
+    m_read_idx          = shared_idx & frame_idx_mask;
+
+    return &m_frames[m_read_idx];
+}
@@ -0,0 +1,137 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gfx/age_frame_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+
+
+namespace
+{
+    age::pixel_vector create_pixels(int frame)
+    {
+        return age::pixel_vector(16, age::pixel(frame));
+    }
+
+    bool is_consistent(const age::pool_frame& frame)
+    {
+        auto expected = age::pixel(static_cast<int>(frame.m_hash));
+        return (frame.m_pixels.size() == 16)
+               && std::all_of(begin(frame.m_pixels),
+                              end(frame.m_pixels),
+                              [&](const auto& p) { return p == expected; });
+    }
+
+} // namespace
+
+
+
+TEST(AgeFramePool, TakesNothingInitially)
+{
+    age::frame_pool pool;
+    EXPECT_EQ(pool.take_frame(), nullptr);
+}
+
+TEST(AgeFramePool, TakesPublishedFrame)
+{
+    age::frame_pool pool;
+    EXPECT_TRUE(pool.publish_frame(create_pixels(1), 1));
+
+    const auto* frame = pool.take_frame();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->m_hash, 1);
+    EXPECT_EQ(frame->m_pixels, create_pixels(1));
+
+    // taken frames are not taken twice
+    EXPECT_EQ(pool.take_frame(), nullptr);
+}
+
+TEST(AgeFramePool, SkipsFrameNotTaken)
+{
+    age::frame_pool pool;
+    EXPECT_TRUE(pool.publish_frame(create_pixels(1), 1));
+    EXPECT_FALSE(pool.publish_frame(create_pixels(2), 2)); // notification still pending
+    EXPECT_FALSE(pool.publish_frame(create_pixels(3), 3));
+
+    const auto* frame = pool.take_frame();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->m_hash, 3);
+    EXPECT_EQ(frame->m_pixels, create_pixels(3));
+    EXPECT_EQ(pool.take_frame(), nullptr);
+
+    EXPECT_TRUE(pool.publish_frame(create_pixels(4), 4));
+}
+
+TEST(AgeFramePool, KeepsTakenFrameUntilNextTake)
+{
+    age::frame_pool pool;
+    pool.publish_frame(create_pixels(1), 1);
+    const auto* frame = pool.take_frame();
+    ASSERT_NE(frame, nullptr);
+
+    // the producer must not write to the frame being read
+    for (int i = 2; i < 10; ++i)
+    {
+        pool.publish_frame(create_pixels(i), i);
+        EXPECT_EQ(frame->m_hash, 1);
+        EXPECT_EQ(frame->m_pixels, create_pixels(1));
+    }
+}
+
+// Meant to be run with -DUSE_THREAD_SANITIZER=ON as well
+TEST(AgeFramePool, StressTest)
+{
+    constexpr int total_frames = 20000;
+
+    age::frame_pool pool;
+
+    std::thread producer([&] {
+        for (int i = 1; i <= total_frames; ++i)
+        {
+            pool.publish_frame(create_pixels(i), i);
+            if (!(i % 16))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t last_hash  = 0;
+    bool     consistent = true;
+    bool     in_order   = true;
+    while (last_hash < total_frames)
+    {
+        const auto* frame = pool.take_frame();
+        if (!frame)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        consistent &= is_consistent(*frame);
+        in_order &= frame->m_hash > last_hash;
+        last_hash = frame->m_hash;
+    }
+
+    producer.join();
+    EXPECT_TRUE(consistent);
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(last_hash, total_frames);
+    EXPECT_EQ(pool.take_frame(), nullptr);
+}
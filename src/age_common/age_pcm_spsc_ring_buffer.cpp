@@ -0,0 +1,146 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <pcm/age_pcm_spsc_ring_buffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+
+age::pcm_spsc_ring_buffer::pcm_spsc_ring_buffer(int min_capacity)
+    : m_capacity(calculate_capacity(min_capacity)),
+      m_buffer(static_cast<size_t>(m_capacity))
+{
+}
+
+int age::pcm_spsc_ring_buffer::get_capacity() const
+{
+    return m_capacity;
+}
+
+
+
+//---------------------------------------------------------
+//
+//   producer
+//
+//---------------------------------------------------------
+
+int age::pcm_spsc_ring_buffer::get_free_samples() const
+{
+    // the producer is the only thread modifying m_write_idx
+    size_t write_idx = m_write_idx.load(std::memory_order_relaxed);
+    size_t read_idx  = m_read_idx.load(std::memory_order_acquire);
+    assert(write_idx - read_idx <= static_cast<size_t>(m_capacity));
+
+    return m_capacity - static_cast<int>(write_idx - read_idx);
+}
+
+int age::pcm_spsc_ring_buffer::add_samples(std::span<const pcm_frame> samples)
+{
+    size_t write_idx = m_write_idx.load(std::memory_order_relaxed);
+    size_t read_idx  = m_read_idx.load(std::memory_order_acquire); // samples may be overwritten after this
+    assert(write_idx - read_idx <= static_cast<size_t>(m_capacity));
+
+    auto free_samples = static_cast<size_t>(m_capacity) - (write_idx - read_idx);
+    auto to_add       = std::min(free_samples, samples.size());
+
+    // copy in two steps to handle a wrap around
+    auto mask  = static_cast<size_t>(m_capacity - 1);
+    auto start = write_idx & mask;
+    auto first = std::min(to_add, static_cast<size_t>(m_capacity) - start);
+
+    std::copy_n(samples.data(), first, m_buffer.data() + start);
+    std::copy_n(samples.data() + first, to_add - first, m_buffer.data());
+
+    // publish the new samples
+    m_write_idx.store(write_idx + to_add, std::memory_order_release);
+    return static_cast<int>(to_add);
+}
+
+
+
+//---------------------------------------------------------
+//
+//   consumer
+//
+//---------------------------------------------------------
+
+int age::pcm_spsc_ring_buffer::get_buffered_samples() const
+{
+    // the consumer is the only thread modifying m_read_idx
+    size_t read_idx  = m_read_idx.load(std::memory_order_relaxed);
+    size_t write_idx = m_write_idx.load(std::memory_order_acquire);
+    assert(write_idx - read_idx <= static_cast<size_t>(m_capacity));
+
+    return static_cast<int>(write_idx - read_idx);
+}
+
+age::pcm_spsc_ring_buffer::buffered_spans age::pcm_spsc_ring_buffer::get_buffered_samples_spans() const
+{
+    size_t read_idx  = m_read_idx.load(std::memory_order_relaxed);
+    size_t write_idx = m_write_idx.load(std::memory_order_acquire); // makes the new samples visible
+    assert(write_idx - read_idx <= static_cast<size_t>(m_capacity));
+
+    auto buffered = write_idx - read_idx;
+    auto mask     = static_cast<size_t>(m_capacity - 1);
+    auto start    = read_idx & mask;
+    auto first    = std::min(buffered, static_cast<size_t>(m_capacity) - start);
+
+    std::span<const pcm_frame> buffer(m_buffer);
+    return {.m_first  = buffer.subspan(start, first),
+            .m_second = buffer.subspan(0, buffered - first)};
+}
+
+void age::pcm_spsc_ring_buffer::discard_buffered_samples(int samples_to_discard)
+{
+    size_t read_idx  = m_read_idx.load(std::memory_order_relaxed);
+    size_t write_idx = m_write_idx.load(std::memory_order_acquire);
+
+    auto to_discard = std::min(static_cast<size_t>(std::max(0, samples_to_discard)), write_idx - read_idx);
+
+    // release the samples to the producer
+    m_read_idx.store(read_idx + to_discard, std::memory_order_release);
+}
+
+int age::pcm_spsc_ring_buffer::read_samples(std::span<pcm_frame> destination)
+{
+    auto spans = get_buffered_samples_spans();
+
+    auto first  = std::min(spans.m_first.size(), destination.size());
+    auto second = std::min(spans.m_second.size(), destination.size() - first);
+
+    std::copy_n(spans.m_first.data(), first, destination.data());
+    std::copy_n(spans.m_second.data(), second, destination.data() + first);
+
+    auto samples_read = static_cast<int>(first + second);
+    discard_buffered_samples(samples_read);
+    return samples_read;
+}
+
+
+
+int age::pcm_spsc_ring_buffer::calculate_capacity(int min_capacity)
+{
+    int capacity = 1;
+    while (capacity < min_capacity)
+    {
+        assert(capacity <= int_max / 2);
+        capacity <<= 1;
+    }
+    return capacity;
+}
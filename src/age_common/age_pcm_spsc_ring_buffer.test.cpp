@@ -0,0 +1,127 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <pcm/age_pcm_spsc_ring_buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+
+
+namespace
+{
+    age::pcm_frame create_frame(int idx)
+    {
+        return {static_cast<int16_t>(idx), static_cast<int16_t>(~idx)};
+    }
+
+} // namespace
+
+
+
+TEST(AgePcmSpscRingBuffer, WrapsAround)
+{
+    age::pcm_spsc_ring_buffer buffer(7);
+    EXPECT_EQ(buffer.get_capacity(), 8);
+
+    age::pcm_vector samples;
+    for (int i = 0; i < 10; ++i)
+    {
+        samples.push_back(create_frame(i));
+    }
+
+    EXPECT_EQ(buffer.add_samples(std::span(samples).first(6)), 6);
+    buffer.discard_buffered_samples(4);
+    EXPECT_EQ(buffer.add_samples(std::span(samples).subspan(6)), 4);
+    EXPECT_EQ(buffer.get_free_samples(), 2);
+
+    auto spans = buffer.get_buffered_samples_spans();
+    EXPECT_EQ(spans.m_first.size(), 4);
+    EXPECT_EQ(spans.m_second.size(), 2);
+    EXPECT_EQ(spans.m_first[0], create_frame(4));
+    EXPECT_EQ(spans.m_second[1], create_frame(9));
+}
+
+TEST(AgePcmSpscRingBuffer, DropsSamplesIfFull)
+{
+    age::pcm_spsc_ring_buffer buffer(4);
+    age::pcm_vector           samples(6, create_frame(1));
+
+    EXPECT_EQ(buffer.add_samples(samples), 4);
+    EXPECT_EQ(buffer.add_samples(samples), 0);
+    EXPECT_EQ(buffer.get_buffered_samples(), 4);
+}
+
+// Meant to be run with -DUSE_THREAD_SANITIZER=ON as well
+TEST(AgePcmSpscRingBuffer, StressTest)
+{
+    constexpr int total_samples = 1 << 20;
+
+    age::pcm_spsc_ring_buffer buffer(256);
+
+    std::thread producer([&] {
+        age::pcm_vector samples;
+        int             idx = 0;
+        while (idx < total_samples)
+        {
+            // vary the number of samples added
+            samples.clear();
+            int count = std::min(1 + (idx % 97), total_samples - idx);
+            for (int i = 0; i < count; ++i)
+            {
+                samples.push_back(create_frame(idx + i));
+            }
+
+            std::span<const age::pcm_frame> to_add(samples);
+            while (!to_add.empty())
+            {
+                auto added = static_cast<size_t>(buffer.add_samples(to_add));
+                to_add     = to_add.subspan(added);
+                if (!added)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            idx += count;
+        }
+    });
+
+    int  samples_read = 0;
+    bool in_order     = true;
+    while (samples_read < total_samples)
+    {
+        auto spans = buffer.get_buffered_samples_spans();
+        if (!spans.size())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        for (auto span : {spans.m_first, spans.m_second})
+        {
+            for (auto frame : span)
+            {
+                in_order &= frame == create_frame(samples_read++);
+            }
+        }
+        buffer.discard_buffered_samples(spans.size());
+    }
+
+    producer.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(samples_read, total_samples);
+    EXPECT_EQ(buffer.get_buffered_samples(), 0);
+}
@@ -16,6 +16,7 @@
 
 #include <gfx/age_screen_buffer.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 
@@ -29,8 +30,10 @@ age::screen_buffer::screen_buffer(int16_t screen_width, int16_t screen_height)
 
     auto buffer_size = static_cast<unsigned>(m_screen_width * m_screen_height);
 
-    m_front_buffer = pixel_vector(buffer_size);
-    m_back_buffer  = pixel_vector(buffer_size);
+    m_front_buffer     = pixel_vector(buffer_size);
+    m_back_buffer      = pixel_vector(buffer_size);
+    m_back_line_hashes = std::vector<uint64_t>(static_cast<unsigned>(m_screen_height));
+    m_front_hash       = calculate_hash(m_front_buffer, m_screen_width);
 }
 
 
@@ -54,6 +57,16 @@ const age::pixel_vector& age::screen_buffer::get_front_buffer() const
     return m_front_buffer;
 }
 
+age::uint64_t age::screen_buffer::get_front_buffer_hash() const
+{
+    return m_front_hash;
+}
+
+bool age::screen_buffer::is_front_buffer_unchanged() const
+{
+    return m_front_buffer_unchanged;
+}
+
 
 age::pixel_vector& age::screen_buffer::get_back_buffer()
 {
@@ -67,10 +80,104 @@ std::span<age::pixel> age::screen_buffer::get_back_buffer_line(int line)
 }
 
 
+void age::screen_buffer::fill_back_buffer(pixel color)
+{
+    std::fill(begin(m_back_buffer), end(m_back_buffer), color);
+    m_hashed_lines = 0;
+}
+
 void age::screen_buffer::switch_buffers()
 {
+    hash_back_buffer_lines(m_screen_height);
+    auto hash                = combine_hashes(m_back_line_hashes);
+    m_front_buffer_unchanged = hash == m_front_hash;
+    m_front_hash             = hash;
+    m_hashed_lines           = 0;
+
     // https://stackoverflow.com/a/28130696
     using std::swap;
     swap(m_front_buffer, m_back_buffer);
     ++m_frame_id; // may wrap around but that's okay
 }
+
+void age::screen_buffer::repeat_front_buffer(int frame_count)
+{
+    assert(frame_count > 0);
+    m_frame_id += static_cast<unsigned>(frame_count); // may wrap around but that's okay
+    m_front_buffer_unchanged = true;
+}
+
+void age::screen_buffer::hash_back_buffer_lines(int until_line)
+{
+    assert((until_line >= 0) && (until_line <= m_screen_height));
+    for (; m_hashed_lines < until_line; ++m_hashed_lines)
+    {
+        m_back_line_hashes[static_cast<unsigned>(m_hashed_lines)] = hash_line(get_back_buffer_line(m_hashed_lines));
+    }
+}
+
+void age::screen_buffer::reset()
+{
+    std::fill(begin(m_front_buffer), end(m_front_buffer), pixel());
+    std::fill(begin(m_back_buffer), end(m_back_buffer), pixel());
+    m_frame_id               = 0;
+    m_hashed_lines           = 0;
+    m_front_hash             = calculate_hash(m_front_buffer, m_screen_width);
+    m_front_buffer_unchanged = false;
+}
+
+
+
+age::uint64_t age::screen_buffer::calculate_hash(std::span<const pixel> screen, int16_t screen_width)
+{
+    assert(screen_width > 0);
+    assert(screen.size() % static_cast<unsigned>(screen_width) == 0);
+    auto width = static_cast<unsigned>(screen_width);
+
+    std::vector<uint64_t> line_hashes;
+    for (unsigned ofs = 0; ofs < screen.size(); ofs += width)
+    {
+        line_hashes.push_back(hash_line(screen.subspan(ofs, width)));
+    }
+    return combine_hashes(line_hashes);
+}
+
+age::uint64_t age::screen_buffer::hash_line(std::span<const pixel> line)
+{
+    // FNV-1a on 64 bit values instead of bytes.
+    // We hash two pixels at once and use four independent lanes
+    // to not stall on the multiplications' latency.
+    constexpr uint64_t fnv_offset = 0xcbf29ce484222325;
+    constexpr uint64_t fnv_prime  = 0x100000001b3;
+
+    std::array<uint64_t, 4> lanes{fnv_offset, fnv_offset, fnv_offset, fnv_offset};
+
+    unsigned x = 0;
+    for (; x + 8 <= line.size(); x += 8)
+    {
+        for (unsigned lane = 0; lane < 4; ++lane)
+        {
+            auto px = x + lane * 2;
+            lanes[lane] ^= line[px].get_32bits() + (uint64_t{line[px + 1].get_32bits()} << 32);
+            lanes[lane] *= fnv_prime;
+        }
+    }
+    for (; x < line.size(); ++x)
+    {
+        lanes[0] ^= line[x].get_32bits();
+        lanes[0] *= fnv_prime;
+    }
+
+    return combine_hashes(lanes);
+}
+
+age::uint64_t age::screen_buffer::combine_hashes(std::span<const uint64_t> hashes)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (auto value : hashes)
+    {
+        hash ^= value;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
@@ -0,0 +1,53 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gfx/age_screen_buffer.hpp>
+
+#include <gtest/gtest.h>
+
+
+
+TEST(AgeScreenBuffer, HashesFrontBuffer)
+{
+    age::screen_buffer buffer(10, 4);
+    buffer.get_back_buffer_line(1)[3] = age::pixel(0x123456);
+    buffer.hash_back_buffer_lines(2);
+    buffer.get_back_buffer_line(3)[9] = age::pixel(0x654321);
+    buffer.switch_buffers();
+
+    EXPECT_EQ(buffer.get_front_buffer_hash(), age::screen_buffer::calculate_hash(buffer.get_front_buffer(), 10));
+    EXPECT_FALSE(buffer.is_front_buffer_unchanged());
+}
+
+TEST(AgeScreenBuffer, DetectsUnchangedFrontBuffer)
+{
+    age::screen_buffer buffer(10, 4);
+    buffer.fill_back_buffer(age::pixel(0x123456));
+    buffer.switch_buffers();
+    auto hash = buffer.get_front_buffer_hash();
+
+    buffer.fill_back_buffer(age::pixel(0x123456));
+    buffer.switch_buffers();
+    EXPECT_TRUE(buffer.is_front_buffer_unchanged());
+    EXPECT_EQ(buffer.get_front_buffer_hash(), hash);
+
+    // any single pixel change should change the hash
+    buffer.fill_back_buffer(age::pixel(0x123456));
+    buffer.get_back_buffer_line(2)[7] = age::pixel(0x123457);
+    buffer.switch_buffers();
+    EXPECT_FALSE(buffer.is_front_buffer_unchanged());
+    EXPECT_NE(buffer.get_front_buffer_hash(), hash);
+}
@@ -0,0 +1,90 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef AGE_CONVOLUTION_HPP
+#define AGE_CONVOLUTION_HPP
+
+//!
+//! \file
+//!
+
+#include <cstddef>
+#include <map>
+#include <utility> // std::pair
+#include <vector>
+
+
+
+namespace age
+{
+
+    //!
+    //! \brief A convolution kernel maps texel offsets (x, y) to weights.
+    //!
+    //! The y axis points upwards like OpenGL's gl_FragCoord.
+    //!
+    using convolution_kernel = std::map<std::pair<int, int>, double>;
+
+    extern const convolution_kernel convolution_gauss3x3_s;
+    extern const convolution_kernel convolution_gauss3x3_t;
+    extern const convolution_kernel convolution_gauss5x5_s;
+    extern const convolution_kernel convolution_gauss5x5_t;
+    extern const convolution_kernel convolution_emboss3x3;
+    extern const convolution_kernel convolution_emboss5x5;
+
+    //!
+    //! \brief Fusing two convolution steps saves writing and reading a
+    //! frame buffer but may increase the number of texture reads per texel.
+    //!
+    //! This limits the number of texture reads of a fused kernel.
+    //!
+    constexpr std::size_t max_fused_convolution_taps = 25;
+
+    convolution_kernel convolve(const convolution_kernel& first, const convolution_kernel& second);
+
+    //!
+    //! \brief Check if applying a single fused kernel results in the same
+    //! image as applying both kernels one after another.
+    //!
+    //! Each step clamps its results to [0, 1] and its texel reads to the
+    //! image's edges.
+    //! A fused kernel does this only once,
+    //! which makes no difference if
+    //! - the first kernel has no negative weights
+    //!   (all weights of a kernel add up to 1) and
+    //! - one of the kernels reads only the texel it writes to
+    //!   or one kernel reads texels only along the x axis
+    //!   and the other one only along the y axis
+    //!   (e.g. the two passes of a separable kernel).
+    //!
+    bool can_fuse(const convolution_kernel& first, const convolution_kernel& second);
+
+    //!
+    //! \brief Fuse consecutive convolution kernels where possible
+    //! (see can_fuse()), as long as the fused kernel does not exceed
+    //! max_fused_convolution_taps.
+    //!
+    //! \return The kernels to apply one after another,
+    //! one kernel per rendering pass.
+    //!
+    std::vector<convolution_kernel> fuse_convolution_kernels(const std::vector<convolution_kernel>& kernels);
+
+} // namespace age
+
+
+
+#endif // AGE_CONVOLUTION_HPP
@@ -0,0 +1,106 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_FRAME_POOL_HPP
+#define AGE_FRAME_POOL_HPP
+
+//!
+//! \file
+//!
+
+#include <age_types.hpp>
+#include <gfx/age_pixel.hpp>
+
+#include <array>
+#include <atomic>
+
+
+
+namespace age
+{
+
+    struct pool_frame
+    {
+        pixel_vector m_pixels;
+        uint64_t     m_hash = 0; //!< e.g. gb_emulator::get_screen_front_buffer_hash()
+    };
+
+
+
+    //!
+    //! \brief Hands frames from exactly one producer thread
+    //! (e.g. an emulation runner) to exactly one consumer thread
+    //! (e.g. the video output) without allocating memory.
+    //!
+    //! The pool consists of three frames.
+    //! The producer owns one frame for writing the next frame to
+    //! and the consumer owns one frame for reading the current frame from.
+    //! The third frame is exchanged atomically by both of them:
+    //! the producer publishes a new frame by swapping its frame with
+    //! the third frame,
+    //! the consumer takes the latest frame by doing the same.
+    //!
+    //! If the producer publishes a frame before the previous one
+    //! has been taken, the previous frame is skipped.
+    //!
+    class frame_pool
+    {
+        AGE_DISABLE_COPY(frame_pool);
+        AGE_DISABLE_MOVE(frame_pool);
+
+    public:
+        frame_pool() = default;
+        ~frame_pool() = default;
+
+        //!
+        //! \brief Publish a new frame.
+        //!
+        //! Must only be called by the producer.
+        //! The pixels are not copied, if the frame written to already
+        //! contains them (as indicated by the hash).
+        //!
+        //! \return True if the consumer has to be notified about the new frame.
+        //! False if the previously published frame has not been taken yet,
+        //! in which case the notification for that frame is still pending.
+        //!
+        bool publish_frame(const pixel_vector& pixels, uint64_t hash);
+
+        //!
+        //! \brief Take the latest published frame.
+        //!
+        //! Must only be called by the consumer.
+        //! The frame remains valid until the next call to this method.
+        //!
+        //! \return The latest published frame or nullptr, if no frame has
+        //! been published since the last call.
+        //!
+        const pool_frame* take_frame();
+
+    private:
+        static constexpr unsigned frame_idx_mask = 0x03;
+        static constexpr unsigned frame_fresh    = 0x04; //!< the shared frame has not been taken yet
+
+        std::array<pool_frame, 3> m_frames;
+        unsigned                  m_write_idx = 0; //!< owned by the producer
+        std::atomic<unsigned>     m_shared_idx{1};
+        unsigned                  m_read_idx = 2; //!< owned by the consumer
+    };
+
+} // namespace age
+
+
+
+#endif // AGE_FRAME_POOL_HPP
@@ -26,6 +26,7 @@
 
 #include <array>
 #include <span>
+#include <vector>
 
 
 
@@ -43,17 +44,71 @@ namespace age
 
         [[nodiscard]] const pixel_vector& get_front_buffer() const;
 
+        //!
+        //! \return A hash of the front buffer's pixels,
+        //! see also calculate_hash().
+        //!
+        [[nodiscard]] uint64_t get_front_buffer_hash() const;
+
+        //!
+        //! \return True if the front buffer's hash equals the hash of the
+        //! previous front buffer, i.e. the screen did not change.
+        //!
+        [[nodiscard]] bool is_front_buffer_unchanged() const;
+
         pixel_vector&    get_back_buffer();
         std::span<pixel> get_back_buffer_line(int line);
+        void             fill_back_buffer(pixel color);
         void             switch_buffers();
 
+        //!
+        //! \brief Keep the current front buffer for the specified number of
+        //! frames.
+        //!
+        //! This is equivalent to rendering the same screen again for
+        //! every frame and switching buffers,
+        //! but the screen is neither copied nor hashed again.
+        //!
+        void repeat_front_buffer(int frame_count);
+
+        //!
+        //! \brief Hash all back buffer lines up to (excluding) the specified
+        //! line, that have not been hashed yet.
+        //!
+        //! Lines should be hashed right after they have been written,
+        //! so that their pixels are still cached.
+        //! Hashed lines must not be modified until switch_buffers() is called.
+        //! Any remaining lines are hashed by switch_buffers().
+        //!
+        void hash_back_buffer_lines(int until_line);
+
+        //! Clear both buffers and reset the frame id without reallocating.
+        void reset();
+
+        //!
+        //! \brief Calculate the same hash that get_front_buffer_hash()
+        //! returns for a screen containing the specified pixels.
+        //!
+        //! The hash is intended to detect screen changes,
+        //! it is not suited for cryptographic purposes.
+        //!
+        static uint64_t calculate_hash(std::span<const pixel> screen, int16_t screen_width);
+
     private:
+        static uint64_t hash_line(std::span<const pixel> line);
+        static uint64_t combine_hashes(std::span<const uint64_t> hashes);
+
         const int16_t m_screen_width;
         const int16_t m_screen_height;
 
         pixel_vector m_front_buffer;
         pixel_vector m_back_buffer;
         unsigned     m_frame_id = 0; // unsigned for well-defined wrap around behaviour
+
+        std::vector<uint64_t> m_back_line_hashes;
+        int                   m_hashed_lines           = 0;
+        uint64_t              m_front_hash             = 0;
+        bool                  m_front_buffer_unchanged = false;
     };
 
 } // namespace age
@@ -0,0 +1,4 @@
+constexpr const char* GIT_REV="";
+constexpr const char* GIT_DATE="";
+constexpr const char* GIT_TAG="";
+constexpr const char* GIT_BRANCH="";
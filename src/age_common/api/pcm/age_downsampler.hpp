@@ -24,6 +24,7 @@
 #include <age_types.hpp>
 #include <pcm/age_pcm_frame.hpp>
 
+#include <array>
 #include <functional>
 #include <vector>
 
@@ -45,6 +46,14 @@ namespace age
 
         void         clear_output_samples();
         void         set_volume(float volume);
+
+        //!
+        //! Multiply the nominal input/output sampling rate ratio with the
+        //! specified correction factor.
+        //! A factor greater than 1 results in fewer output samples,
+        //! e.g. to drain an audio buffer that is filling up.
+        //!
+        virtual void set_ratio_correction(double correction);
         virtual void add_input_samples(const pcm_vector& samples) = 0;
 
     protected:
@@ -55,12 +64,15 @@ namespace age
         //! This variable contains the number of input samples required for
         //! a single output sample. The unsigned integer is treated as fixed
         //! point value with the lower 16 bits treated as fraction.
+        //! It may be adjusted slightly by set_ratio_correction().
         //!
-        const int m_input_output_ratio;
+        int m_input_output_ratio;
 
     private:
         static int calculate_ratio(int input_sampling_rate, int output_sampling_rate);
 
+        const int m_nominal_input_output_ratio;
+
         pcm_vector m_output_samples;
         float      m_volume = 1;
     };
@@ -129,11 +141,130 @@ namespace age
     public:
         downsampler_kaiser_low_pass(int input_sampling_rate, int output_sampling_rate, double ripple);
         ~downsampler_kaiser_low_pass() override = default;
+    };
+
+
+
+    //!
+    //! \brief A downsampler_polyphase resamples audio data using a Kaiser
+    //! low pass FIR evaluated at the exact fractional position of each
+    //! output sample.
+    //!
+    //! The FIR is precomputed for a fixed number of fractional phases.
+    //! Input samples are kept in a fixed size history buffer that holds
+    //! the samples required for the next output sample.
+    //!
+    class downsampler_polyphase : public downsampler
+    {
+        AGE_DISABLE_COPY(downsampler_polyphase);
+        AGE_DISABLE_MOVE(downsampler_polyphase);
+
+    public:
+        downsampler_polyphase(int input_sampling_rate, int output_sampling_rate, double ripple);
+        ~downsampler_polyphase() override = default;
+
+        void add_input_samples(const pcm_vector& samples) override;
+
+        [[nodiscard]] size_t get_fir_size() const;
+
+    private:
+        void add_history_samples(const pcm_frame* samples, int count);
+        void add_output_sample(int phase);
+
+        static constexpr int phase_bits    = 6;
+        static constexpr int phases        = 1 << phase_bits;
+        static constexpr int history_chunk = 4096;
+
+        int                m_fir_size = 0; //!< taps per phase, multiple of 8
+        std::vector<float> m_fir_phases;   //!< phases * m_fir_size values
+
+        //! The history buffer keeps the last m_fir_size samples and
+        //! room for history_chunk new samples.
+        //! The last m_fir_size samples are moved to the front as soon as
+        //! the buffer is full.
+        std::vector<float> m_history_left;
+        std::vector<float> m_history_right;
+        int                m_history_size = 0;
+
+        //! input samples required for the next output sample (16.16 fixed point)
+        int m_next_output_distance = 0;
+    };
+
+
+
+    //!
+    //! \brief A downsampler_multistage resamples audio data using a cascade
+    //! of cheap decimation stages.
+    //!
+    //! A CIC decimator reduces the sampling rate by 8 using integer
+    //! arithmetic only.
+    //! It is followed by half-band FIR decimators, each one halving the
+    //! sampling rate, as long as the sampling rate stays well above the
+    //! output sampling rate.
+    //! A short downsampler_polyphase finally resamples the result to the
+    //! exact output sampling rate.
+    //!
+    class downsampler_multistage : public downsampler
+    {
+        AGE_DISABLE_COPY(downsampler_multistage);
+        AGE_DISABLE_MOVE(downsampler_multistage);
+
+    public:
+        downsampler_multistage(int input_sampling_rate, int output_sampling_rate, double ripple);
+        ~downsampler_multistage() override = default;
+
+        void set_ratio_correction(double correction) override;
+        void add_input_samples(const pcm_vector& samples) override;
+
+        //! the number of FIR taps of all half-band stages and the final resampler
+        [[nodiscard]] size_t get_fir_size() const;
 
     private:
-        static int    calculate_filter_order(double A, double tw);
-        static double calculate_beta(double A);
-        static double calculate_bessel(double value);
+        class halfband_stage
+        {
+        public:
+            halfband_stage(int input_sampling_rate, int output_sampling_rate, double ripple);
+
+            void decimate(std::vector<float>& left, std::vector<float>& right);
+
+            [[nodiscard]] size_t get_fir_size() const;
+
+        private:
+            //!
+            //! The last input samples covered by the FIR.
+            //! Every sample is stored twice (at index i and i + FIR size)
+            //! so that the FIR always covers a contiguous range of samples.
+            //!
+            struct history
+            {
+                std::vector<float> m_samples;
+                size_t             m_write_idx      = 0;
+                size_t             m_samples_needed = 0; //!< samples to store before the next output
+            };
+
+            void decimate(std::vector<float>& samples, history& history) const;
+
+            //! non-zero coefficients h(1), h(3), h(5), ... (h(0) is always 0.5)
+            std::vector<float> m_fir_odd;
+            history            m_history_left;
+            history            m_history_right;
+        };
+
+        static int calculate_halfband_stages(int input_sampling_rate, int output_sampling_rate);
+        void       decimate_cic(const pcm_vector& samples);
+
+        static constexpr int cic_order           = 4;
+        static constexpr int cic_decimation_bits = 3;
+
+        std::array<uint32_t, cic_order * 2> m_cic_integrators{};
+        std::array<uint32_t, cic_order * 2> m_cic_combs{};
+        int                                 m_cic_phase = 0;
+
+        std::vector<halfband_stage> m_halfband_stages;
+        std::vector<float>          m_stage_left;
+        std::vector<float>          m_stage_right;
+        pcm_vector                  m_stage_output;
+        downsampler_polyphase       m_resampler;
     };
 
 } // namespace age
@@ -0,0 +1,129 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_PCM_SPSC_RING_BUFFER_HPP
+#define AGE_PCM_SPSC_RING_BUFFER_HPP
+
+//!
+//! \file
+//!
+
+#include <age_types.hpp>
+#include <pcm/age_pcm_frame.hpp>
+
+#include <atomic>
+#include <span>
+
+
+
+namespace age
+{
+
+    //!
+    //! \brief A wait-free ring buffer for {@link pcm_frame}s shared by exactly
+    //! one producer thread and one consumer thread.
+    //!
+    //! The producer adds samples using add_samples(),
+    //! the consumer reads them using get_buffered_samples_spans() and
+    //! discard_buffered_samples() (or read_samples()).
+    //! Unlike pcm_ring_buffer, this buffer never overwrites samples that
+    //! have not yet been read.
+    //! Samples not fitting into the buffer are dropped instead.
+    //!
+    class pcm_spsc_ring_buffer
+    {
+        AGE_DISABLE_COPY(pcm_spsc_ring_buffer);
+        AGE_DISABLE_MOVE(pcm_spsc_ring_buffer);
+
+    public:
+        //!
+        //! \brief The buffered samples as two contiguous spans.
+        //!
+        //! The second span is empty unless the buffered samples wrap around
+        //! to the ring buffer's beginning.
+        //!
+        struct buffered_spans
+        {
+            std::span<const pcm_frame> m_first;
+            std::span<const pcm_frame> m_second;
+
+            [[nodiscard]] int size() const
+            {
+                return static_cast<int>(m_first.size() + m_second.size());
+            }
+        };
+
+        //!
+        //! \brief Create a ring buffer holding at least the specified number of samples.
+        //!
+        //! The capacity is rounded up to the next power of two.
+        //!
+        explicit pcm_spsc_ring_buffer(int min_capacity);
+        ~pcm_spsc_ring_buffer() = default;
+
+        [[nodiscard]] int get_capacity() const;
+
+        //! \brief Producer: get the number of samples that can be added without dropping any.
+        [[nodiscard]] int get_free_samples() const;
+
+        //!
+        //! \brief Producer: add the specified samples.
+        //! \return The number of samples added.
+        //! Samples not fitting into the buffer are dropped.
+        //!
+        int add_samples(std::span<const pcm_frame> samples);
+
+        //! \brief Consumer: get the number of samples available for reading.
+        [[nodiscard]] int get_buffered_samples() const;
+
+        //!
+        //! \brief Consumer: get all samples available for reading.
+        //!
+        //! The returned spans stay valid until the samples are discarded
+        //! using discard_buffered_samples().
+        //!
+        [[nodiscard]] buffered_spans get_buffered_samples_spans() const;
+
+        //! \brief Consumer: discard the specified number of buffered samples.
+        void discard_buffered_samples(int samples_to_discard);
+
+        //!
+        //! \brief Consumer: copy buffered samples to the specified destination and discard them.
+        //! \return The number of samples copied.
+        //!
+        int read_samples(std::span<pcm_frame> destination);
+
+    private:
+        static int calculate_capacity(int min_capacity);
+
+        // keep the indexes on separate cache lines
+        // to not slow down the other thread on every update
+        static constexpr size_t cache_line_size = 64;
+
+        const int  m_capacity;
+        pcm_vector m_buffer;
+
+        //! Both indexes increase monotonically,
+        //! they wrap around to the buffer's beginning by masking.
+        alignas(cache_line_size) std::atomic<size_t> m_write_idx = 0; //!< written by the producer only
+        alignas(cache_line_size) std::atomic<size_t> m_read_idx  = 0; //!< written by the consumer only
+    };
+
+} // namespace age
+
+
+
+#endif // AGE_PCM_SPSC_RING_BUFFER_HPP
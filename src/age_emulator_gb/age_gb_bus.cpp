@@ -90,6 +90,23 @@ age::gb_bus::gb_bus(const gb_device&         device,
       m_serial(serial),
       m_oam_dma(device, clock, memory, events, lcd)
 {
+    reset();
+}
+
+void age::gb_bus::reset()
+{
+    m_oam_dma.reset();
+
+    m_rp               = 0x3E;
+    m_un6c             = 0xFE;
+    m_un72             = 0;
+    m_un73             = 0;
+    m_un75             = 0x8F;
+    m_hdma_source      = 0;
+    m_hdma_destination = 0;
+    m_hdma5            = 0xFF;
+    m_gp_dma_active    = false;
+
     // clear high ram
     std::fill(begin(m_high_ram), end(m_high_ram), 0);
 
@@ -291,6 +308,25 @@ age::uint8_t age::gb_bus::read_byte(uint16_t address)
 
 
 
+age::uint8_t age::gb_bus::peek_byte(uint16_t address) const
+{
+    // rom, video ram, cartridge ram & work ram
+    if (address < 0xFE00)
+    {
+        return m_memory.peek_byte(address);
+    }
+    // high ram
+    if ((address >= 0xFF80) && (address < 0xFFFF))
+    {
+        return m_high_ram[address - 0xFE00];
+    }
+    // OAM & registers are not peeked into
+    // as reading them might have side effects
+    return 0xFF;
+}
+
+
+
 void age::gb_bus::write_byte(uint16_t address, uint8_t byte)
 {
     // handle pending events to keep the system consistent
@@ -313,7 +349,14 @@ void age::gb_bus::write_byte(uint16_t address, uint8_t byte)
                     << " ignored (VRAM not accessible)";
                 return;
             }
-            m_lcd.update_state();
+            if (m_memory.read_byte(address) == byte)
+            {
+                return; // nothing changed, no need to render anything up to now
+            }
+            m_lcd.before_video_ram_write();
+            m_memory.write_byte(address, byte);
+            m_lcd.after_video_ram_write(((m_memory.read_vbk() & 1) << 13) + (address & 0x1FFF));
+            return;
         }
         m_memory.write_byte(address, byte);
         return;
@@ -512,10 +555,6 @@ void age::gb_bus::handle_events()
                 m_interrupts.unhalt();
                 break;
 
-            case gb_event::next_empty_frame:
-                m_lcd.next_empty_frame();
-                break;
-
             case gb_event::start_oam_dma:
                 m_oam_dma.handle_start_dma_event();
                 break;
@@ -147,8 +147,11 @@ namespace age
 
         ~gb_bus() = default;
 
-        uint8_t read_byte(uint16_t address);
-        void    write_byte(uint16_t address, uint8_t byte);
+        void reset();
+
+        uint8_t               read_byte(uint16_t address);
+        [[nodiscard]] uint8_t peek_byte(uint16_t address) const;
+        void                  write_byte(uint16_t address, uint8_t byte);
 
         void handle_events();
         bool handle_gp_dma();
@@ -76,11 +76,25 @@ age::gb_cpu::gb_cpu(const gb_device&         device,
       m_clock(clock),
       m_events(events),
       m_interrupts(interrupts),
-      m_bus(bus),
-      m_pc(0x0100),
-      m_sp(0xFFFE),
-      m_prefetched_opcode(m_bus.read_byte(m_pc))
+      m_bus(bus)
 {
+    reset();
+}
+
+void age::gb_cpu::reset()
+{
+    m_zero_indicator  = 0;
+    m_carry_indicator = 0;
+    m_hcs_flags       = 0;
+    m_hcs_operand     = 0;
+    m_cpu_state       = 0;
+    m_ld_b_b          = false;
+    m_invalid_opcode  = 0;
+
+    m_pc                = 0x0100;
+    m_sp                = 0xFFFE;
+    m_prefetched_opcode = m_bus.read_byte(m_pc);
+
     if (m_device.is_dmg_device())
     {
         m_a = 0x01;
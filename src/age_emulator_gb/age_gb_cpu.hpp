@@ -53,6 +53,8 @@ namespace age
                gb_bus&                  bus);
         ~gb_cpu() = default;
 
+        void reset();
+
         [[nodiscard]] bool         is_frozen() const;
         [[nodiscard]] gb_test_info get_test_info() const;
         void                       emulate();
@@ -25,7 +25,16 @@ age::gb_emulator::gb_emulator(const uint8_vector& rom,
                               gb_colors_hint      colors_hint,
                               gb_log_categories   log_categories)
 
-    : m_impl(new gb_emulator_impl(rom, device_type, colors_hint, std::move(log_categories)))
+    : gb_emulator(std::make_shared<const uint8_vector>(rom), device_type, colors_hint, std::move(log_categories))
+{
+}
+
+age::gb_emulator::gb_emulator(std::shared_ptr<const uint8_vector> rom,
+                              gb_device_type                      device_type,
+                              gb_colors_hint                      colors_hint,
+                              gb_log_categories                   log_categories)
+
+    : m_impl(new gb_emulator_impl(std::move(rom), device_type, colors_hint, std::move(log_categories)))
 {
 }
 
@@ -34,6 +43,13 @@ age::gb_emulator::~gb_emulator()
     delete m_impl;
 }
 
+void age::gb_emulator::reset(std::shared_ptr<const uint8_vector> rom,
+                             gb_device_type                      device_type,
+                             gb_colors_hint                      colors_hint)
+{
+    m_impl->reset(std::move(rom), device_type, colors_hint);
+}
+
 
 
 std::string age::gb_emulator::get_emulator_title() const
@@ -56,6 +72,36 @@ const age::pixel_vector& age::gb_emulator::get_screen_front_buffer() const
     return m_impl->get_screen_front_buffer();
 }
 
+age::uint64_t age::gb_emulator::get_screen_front_buffer_hash() const
+{
+    return m_impl->get_screen_front_buffer_hash();
+}
+
+bool age::gb_emulator::is_screen_front_buffer_unchanged() const
+{
+    return m_impl->is_screen_front_buffer_unchanged();
+}
+
+unsigned age::gb_emulator::get_screen_frame_id() const
+{
+    return m_impl->get_screen_frame_id();
+}
+
+void age::gb_emulator::set_indexed_screen_enabled(bool enabled)
+{
+    m_impl->set_indexed_screen_enabled(enabled);
+}
+
+age::gb_indexed_screen age::gb_emulator::get_indexed_screen_front_buffer() const
+{
+    return m_impl->get_indexed_screen_front_buffer();
+}
+
+void age::gb_emulator::set_screen_rendering_enabled(bool enabled)
+{
+    m_impl->set_screen_rendering_enabled(enabled);
+}
+
 const age::pcm_vector& age::gb_emulator::get_audio_buffer() const
 {
     return m_impl->get_audio_buffer();
@@ -71,6 +117,16 @@ int age::gb_emulator::get_cycles_per_second() const
     return m_impl->get_cycles_per_second();
 }
 
+int age::gb_emulator::get_cycles_per_frame() const
+{
+    return m_impl->get_cycles_per_frame();
+}
+
+void age::gb_emulator::set_audio_enabled(bool audio_enabled)
+{
+    m_impl->set_audio_enabled(audio_enabled);
+}
+
 age::int64_t age::gb_emulator::get_emulated_cycles() const
 {
     return m_impl->get_emulated_cycles();
@@ -86,6 +142,21 @@ void age::gb_emulator::set_persistent_ram(const uint8_vector& source)
     m_impl->set_persistent_ram(source);
 }
 
+bool age::gb_emulator::is_persistent_ram_dirty() const
+{
+    return m_impl->is_persistent_ram_dirty();
+}
+
+int age::gb_emulator::copy_dirty_persistent_ram(std::span<uint8_t> destination)
+{
+    return m_impl->copy_dirty_persistent_ram(destination);
+}
+
+void age::gb_emulator::peek_memory(uint16_t address, std::span<uint8_t> destination) const
+{
+    m_impl->peek_memory(address, destination);
+}
+
 void age::gb_emulator::set_buttons_down(int buttons)
 {
     m_impl->set_buttons_down(buttons);
@@ -106,6 +177,11 @@ age::gb_test_info age::gb_emulator::get_test_info() const
     return m_impl->get_test_info();
 }
 
+age::gb_render_stats age::gb_emulator::get_render_stats() const
+{
+    return m_impl->get_render_stats();
+}
+
 std::vector<age::gb_log_entry> age::gb_emulator::get_and_clear_log_entries()
 {
     return m_impl->get_and_clear_log_entries();
@@ -0,0 +1,397 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include <emulator/age_gb_emulator.hpp>
+
+#include "age_gb_test_rom.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    //!
+    //! Create an MBC1 rom with battery backed cartridge ram that
+    //! writes a value to cartridge ram, copies it to [0xC000]
+    //! and then counts frames at [0xC001]
+    //! (work ram is initialized randomly).
+    //!
+    std::shared_ptr<const age::uint8_vector> create_rom(bool cgb_rom = false)
+    {
+        const age::gb_test_rom_header header{
+            .m_cgb_rom        = cgb_rom,
+            .m_cartridge_type = 0x03, // MBC1 + RAM + BATTERY
+            .m_ram_size       = 0x02, // 8 KiB cartridge ram
+        };
+
+        return age::gb_create_test_rom({
+            0xAF,             //       xor a
+            0xEA, 0x01, 0xC0, //       ld [0xC001], a
+            0x3E, 0x0A,       //       ld a, 0x0A
+            0xEA, 0x00, 0x00, //       ld [0x0000], a
+            0x3E, 0x42,       //       ld a, 0x42
+            0xEA, 0x00, 0xA0, //       ld [0xA000], a
+            0xFA, 0x00, 0xA0, //       ld a, [0xA000]
+            0xEA, 0x00, 0xC0, //       ld [0xC000], a
+            0xF0, 0x44,       // loop: ldh a, [LY]
+            0xFE, 0x90,       //       cp 144
+            0x20, 0xFA,       //       jr nz, loop
+            0xFA, 0x01, 0xC0, //       ld a, [0xC001]
+            0x3C,             //       inc a
+            0xEA, 0x01, 0xC0, //       ld [0xC001], a
+            0xE0, 0x42,       //       ldh [SCY], a
+            0xF0, 0x44,       // wait: ldh a, [LY]
+            0xFE, 0x90,       //       cp 144
+            0x28, 0xFA,       //       jr z, wait
+            0x18, 0xE9,       //       jr loop
+        },
+                                       header);
+    }
+
+    //!
+    //! Create a rom that places 40 sprites on the screen during v-blank
+    //! and changes BGP, OBP0 and OBP1 on every line.
+    //!
+    std::shared_ptr<const age::uint8_vector> create_palettes_rom()
+    {
+        return age::gb_create_test_rom({
+            0xF0, 0x44,       // vbl:   ldh a, [LY]
+            0xFE, 0x90,       //        cp 144
+            0x20, 0xFA,       //        jr nz, vbl
+            0x21, 0x00, 0xFE, //        ld hl, 0xFE00
+            0x0E, 0x28,       //        ld c, 40
+            0x79,             // oam:   ld a, c
+            0x87,             //        add a
+            0x87,             //        add a
+            0xC6, 0x10,       //        add 16
+            0x22,             //        ld [hl+], a (y)
+            0x22,             //        ld [hl+], a (x)
+            0x79,             //        ld a, c
+            0x22,             //        ld [hl+], a (tile)
+            0x79,             //        ld a, c
+            0xCB, 0x37,       //        swap a
+            0x22,             //        ld [hl+], a (attributes)
+            0x0D,             //        dec c
+            0x20, 0xF0,       //        jr nz, oam
+            0x3E, 0x93,       //        ld a, 0x93
+            0xE0, 0x40,       //        ldh [LCDC], a
+            0xF0, 0x44,       // loop:  ldh a, [LY]
+            0xE0, 0x47,       //        ldh [BGP], a
+            0xE0, 0x48,       //        ldh [OBP0], a
+            0x2F,             //        cpl
+            0xE0, 0x49,       //        ldh [OBP1], a
+            0x18, 0xF5,       //        jr loop
+        });
+    }
+
+    //!
+    //! Create a rom that switches off the LCD during v-blank,
+    //! waits for about 2.5 frames and switches the LCD on again.
+    //!
+    std::shared_ptr<const age::uint8_vector> create_lcd_off_rom()
+    {
+        return age::gb_create_test_rom({
+            0xF0, 0x44,       // loop: ldh a, [LY]
+            0xFE, 0x90,       //       cp 144
+            0x20, 0xFA,       //       jr nz, loop
+            0xAF,             //       xor a
+            0xE0, 0x40,       //       ldh [LCDC], a
+            0x01, 0x00, 0x19, //       ld bc, 0x1900
+            0x0B,             // wait: dec bc
+            0x78,             //       ld a, b
+            0xB1,             //       or c
+            0x20, 0xFB,       //       jr nz, wait
+            0x3E, 0x91,       //       ld a, 0x91
+            0xE0, 0x40,       //       ldh [LCDC], a
+            0x18, 0xFE,       // done: jr done
+        });
+    }
+
+    //!
+    //! Create a rom that places 40 sprites on the screen during v-blank
+    //! and then (optionally) keeps writing the current values of SCX, SCY,
+    //! WX, OBP0, OBP1 and a video ram byte.
+    //!
+    std::shared_ptr<const age::uint8_vector> create_redundant_writes_rom(bool redundant_writes)
+    {
+        age::uint8_vector code{
+            0xF0, 0x44,       // vbl:  ldh a, [LY]
+            0xFE, 0x90,       //       cp 144
+            0x20, 0xFA,       //       jr nz, vbl
+            0x21, 0x00, 0xFE, //       ld hl, 0xFE00
+            0x0E, 0x28,       //       ld c, 40
+            0x79,             // oam:  ld a, c
+            0x87,             //       add a
+            0x87,             //       add a
+            0xC6, 0x10,       //       add 16
+            0x22,             //       ld [hl+], a (y)
+            0x22,             //       ld [hl+], a (x)
+            0x79,             //       ld a, c
+            0x22,             //       ld [hl+], a (tile)
+            0x79,             //       ld a, c
+            0xCB, 0x37,       //       swap a
+            0x22,             //       ld [hl+], a (attributes)
+            0x0D,             //       dec c
+            0x20, 0xF0,       //       jr nz, oam
+            0xAF,             //       xor a
+            0xEA, 0xFF, 0x9F, //       ld [0x9FFF], a
+            0x3E, 0x93,       //       ld a, 0x93
+            0xE0, 0x40,       //       ldh [LCDC], a
+        };
+        age::uint8_vector loop{
+            0xF0, 0x43,       // loop: ldh a, [SCX]
+            0xE0, 0x43,       //       ldh [SCX], a
+            0xF0, 0x42,       //       ldh a, [SCY]
+            0xE0, 0x42,       //       ldh [SCY], a
+            0xF0, 0x4B,       //       ldh a, [WX]
+            0xE0, 0x4B,       //       ldh [WX], a
+            0xF0, 0x48,       //       ldh a, [OBP0]
+            0xE0, 0x48,       //       ldh [OBP0], a
+            0xF0, 0x49,       //       ldh a, [OBP1]
+            0xE0, 0x49,       //       ldh [OBP1], a
+            0xAF,             //       xor a
+            0xEA, 0xFF, 0x9F, //       ld [0x9FFF], a (ignored during mode 3)
+            0x18, 0xE6,       //       jr loop
+        };
+        if (redundant_writes)
+        {
+            code.insert(end(code), begin(loop), end(loop));
+        }
+        else
+        {
+            code.insert(end(code), {0x18, 0xFE}); // done: jr done
+        }
+        return age::gb_create_test_rom(code);
+    }
+
+    age::uint8_vector peek_all(const age::gb_emulator& emulator)
+    {
+        age::uint8_vector memory(0x10000, 0);
+        emulator.peek_memory(0, memory);
+        return memory;
+    }
+
+    //! memory not initialized randomly: rom, video ram and the rom's work ram variables
+    age::uint8_vector peek_deterministic(const age::gb_emulator& emulator)
+    {
+        age::uint8_vector memory(0xA000, 0);
+        emulator.peek_memory(0, memory);
+
+        std::array<age::uint8_t, 2> variables{};
+        emulator.peek_memory(0xC000, variables);
+        memory.insert(end(memory), begin(variables), end(variables));
+        return memory;
+    }
+
+} // namespace
+
+
+
+TEST(AgeGbEmulator, PeeksMemory)
+{
+    age::gb_emulator emulator(create_rom(), age::gb_device_type::dmg);
+    emulator.emulate(10 * emulator.get_cycles_per_frame());
+
+    auto memory = peek_all(emulator);
+    EXPECT_EQ(memory[0x0150], 0xAF);   // rom
+    EXPECT_EQ(memory[0xC000], 0x42);   // work ram (copied from cartridge ram)
+    EXPECT_GE(memory[0xC001], 9);      // work ram (frame counter)
+    EXPECT_EQ(memory[0xA000], 0xFF);   // cartridge ram is not peeked into
+    EXPECT_EQ(memory[0xFE00], 0xFF);   // OAM is not peeked into
+    EXPECT_EQ(memory[0xFF44], 0xFF);   // registers are not peeked into
+    EXPECT_EQ(emulator.get_persistent_ram()[0], 0x42);
+}
+
+TEST(AgeGbEmulator, PeekingMemoryHasNoSideEffects)
+{
+    auto             rom = create_rom();
+    age::gb_emulator emulator(rom, age::gb_device_type::dmg);
+    age::gb_emulator peeked(rom, age::gb_device_type::dmg);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        // peek into memory several times per frame
+        emulator.emulate(emulator.get_cycles_per_frame() / 4);
+        peeked.emulate(peeked.get_cycles_per_frame() / 4);
+        auto memory = peek_all(peeked);
+        EXPECT_EQ(memory, peek_all(peeked));
+        EXPECT_EQ(peek_deterministic(emulator), peek_deterministic(peeked));
+    }
+
+    EXPECT_EQ(emulator.get_emulated_cycles(), peeked.get_emulated_cycles());
+    EXPECT_EQ(emulator.get_screen_front_buffer(), peeked.get_screen_front_buffer());
+    EXPECT_EQ(emulator.get_audio_buffer(), peeked.get_audio_buffer());
+    EXPECT_EQ(emulator.get_persistent_ram(), peeked.get_persistent_ram());
+    EXPECT_EQ(peek_deterministic(emulator), peek_deterministic(peeked));
+}
+
+TEST(AgeGbEmulator, IndexedScreenMatchesScreen)
+{
+    auto rom = create_palettes_rom();
+
+    for (auto device_type : {age::gb_device_type::dmg, age::gb_device_type::cgb_abcd})
+    {
+        // indexed frames replace RGBA frames,
+        // so we compare them to the frames of another emulator
+        age::gb_emulator emulator(rom, device_type);
+        age::gb_emulator rgba_emulator(rom, device_type);
+        emulator.set_indexed_screen_enabled(true);
+        auto width = emulator.get_screen_width();
+        auto rgba  = emulator.get_screen_front_buffer();
+
+        int frames = 0;
+        while (frames < 20)
+        {
+            bool new_frame = emulator.emulate(emulator.get_cycles_per_frame() / 3);
+            ASSERT_EQ(new_frame, rgba_emulator.emulate(rgba_emulator.get_cycles_per_frame() / 3));
+            if (!new_frame)
+            {
+                continue;
+            }
+            // indexing starts with the frame following set_indexed_screen_enabled()
+            if (++frames == 1)
+            {
+                rgba = emulator.get_screen_front_buffer();
+                continue;
+            }
+
+            // the RGBA screen is not updated while indexing
+            EXPECT_EQ(emulator.get_screen_front_buffer(), rgba);
+            EXPECT_TRUE(emulator.is_screen_front_buffer_unchanged());
+            EXPECT_EQ(emulator.get_screen_frame_id(), rgba_emulator.get_screen_frame_id());
+
+            const auto& screen  = rgba_emulator.get_screen_front_buffer();
+            auto        indexed = emulator.get_indexed_screen_front_buffer();
+            ASSERT_EQ(indexed.m_color_indexes.size(), screen.size());
+            for (unsigned i = 0; i < screen.size(); ++i)
+            {
+                unsigned palette = indexed.m_line_palettes[i / width];
+                auto     color   = indexed.m_palettes[palette * age::gb_indexed_palette_size + indexed.m_color_indexes[i]];
+                ASSERT_EQ(color, screen[i]) << "device " << int(device_type) << ", frame " << frames << ", pixel " << i;
+            }
+        }
+    }
+}
+
+TEST(AgeGbEmulator, DefersRenderingOnRedundantWrites)
+{
+    auto rom           = create_redundant_writes_rom(true);
+    auto reference_rom = create_redundant_writes_rom(false);
+
+    for (auto device_type : {age::gb_device_type::dmg, age::gb_device_type::cgb_abcd})
+    {
+        age::gb_emulator emulator(rom, device_type);
+        age::gb_emulator reference(reference_rom, device_type);
+        emulator.emulate(3 * emulator.get_cycles_per_frame());
+        reference.emulate(3 * reference.get_cycles_per_frame());
+
+        for (int frame = 0; frame < 5; ++frame)
+        {
+            emulator.emulate(emulator.get_cycles_per_frame());
+            reference.emulate(reference.get_cycles_per_frame());
+
+            // writes not changing anything don't render up to now,
+            // the frame is rendered at once after the last visible line
+            auto stats = emulator.get_render_stats();
+            EXPECT_EQ(stats.m_fifo_rendered_lines, 0) << "device " << int(device_type) << ", frame " << frame;
+            EXPECT_EQ(stats.m_line_rendered_lines, emulator.get_screen_height());
+            EXPECT_EQ(emulator.get_screen_front_buffer(), reference.get_screen_front_buffer());
+        }
+    }
+}
+
+TEST(AgeGbEmulator, KeepsFrameRateWhileLcdIsOff)
+{
+    auto rom = create_lcd_off_rom();
+
+    // switch the LCD off and on again within a single call to emulate()
+    age::gb_emulator emulator(rom, age::gb_device_type::dmg);
+    EXPECT_TRUE(emulator.emulate(10 * emulator.get_cycles_per_frame()));
+
+    // finish the frames created while the LCD was off on the way
+    age::gb_emulator chunked(rom, age::gb_device_type::dmg);
+    while (chunked.get_emulated_cycles() < emulator.get_emulated_cycles())
+    {
+        chunked.emulate(chunked.get_cycles_per_frame() / 8);
+    }
+
+    EXPECT_EQ(emulator.get_screen_frame_id(), chunked.get_screen_frame_id());
+    EXPECT_GE(emulator.get_screen_frame_id(), 9);
+    EXPECT_LE(emulator.get_screen_frame_id(), 10);
+}
+
+TEST(AgeGbEmulator, ResetEqualsNewEmulator)
+{
+    struct reset_case
+    {
+        std::shared_ptr<const age::uint8_vector> m_previous_rom;
+        std::shared_ptr<const age::uint8_vector> m_rom;
+        int                                      m_clks_before_reset;
+        bool                                     m_rom_initializes_work_ram;
+    };
+
+    auto rom          = create_rom();
+    auto palettes_rom = create_palettes_rom();
+
+    // Resetting in the middle of a line with sprites leaves the fifo
+    // renderer with sprite dots that must not show up after the reset.
+    // The palettes rom has the fifo renderer render lines with sprites,
+    // mode 3 ends about 250 clock cycles into such a line.
+    std::vector<reset_case> reset_cases = {
+        {rom, rom, 123, true},
+        {create_rom(true), rom, 123, true},
+    };
+    for (int line_clks = 120; line_clks < 250; line_clks += 20)
+    {
+        reset_cases.push_back({palettes_rom, palettes_rom, 456 * 60 + line_clks, false});
+    }
+
+    for (const auto& [previous_rom, rom, clks_before_reset, rom_initializes_work_ram] : reset_cases)
+    {
+        // run some rom (possibly on a different device) before resetting
+        age::gb_emulator emulator(previous_rom, age::gb_device_type::auto_detect, age::gb_colors_hint::dmg_greyscale);
+        emulator.set_indexed_screen_enabled(true);
+        emulator.set_buttons_down(age::gb_a | age::gb_right);
+        emulator.emulate(30 * emulator.get_cycles_per_frame() + clks_before_reset);
+        emulator.set_audio_enabled(false);
+
+        emulator.reset(rom, age::gb_device_type::dmg);
+        age::gb_emulator new_emulator(rom, age::gb_device_type::dmg);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            EXPECT_EQ(emulator.emulate(new_emulator.get_cycles_per_frame() / 4),
+                      new_emulator.emulate(new_emulator.get_cycles_per_frame() / 4));
+            EXPECT_EQ(emulator.get_audio_buffer(), new_emulator.get_audio_buffer());
+            ASSERT_EQ(emulator.get_screen_front_buffer(), new_emulator.get_screen_front_buffer())
+                << "reset after " << clks_before_reset << " clock cycles, step " << i;
+        }
+
+        EXPECT_EQ(emulator.get_emulated_cycles(), new_emulator.get_emulated_cycles());
+        EXPECT_EQ(emulator.get_screen_front_buffer(), new_emulator.get_screen_front_buffer());
+        EXPECT_EQ(emulator.get_screen_front_buffer_hash(), new_emulator.get_screen_front_buffer_hash());
+        EXPECT_EQ(emulator.get_indexed_screen_front_buffer().m_color_indexes.size(),
+                  new_emulator.get_indexed_screen_front_buffer().m_color_indexes.size());
+        EXPECT_EQ(emulator.get_persistent_ram(), new_emulator.get_persistent_ram());
+        if (rom_initializes_work_ram)
+        {
+            EXPECT_EQ(peek_deterministic(emulator), peek_deterministic(new_emulator));
+        }
+    }
+}
@@ -0,0 +1,242 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <emulator/age_gb_emulator_batch.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+
+namespace
+{
+    // 154 lines per frame, 456 clock cycles per line
+    constexpr int cycles_per_frame = 154 * 456;
+
+    // emulate in chunks of a few lines to not overshoot the frame too far
+    constexpr int cycles_per_chunk = 16 * 456;
+
+    // stop waiting for the next frame if the LCD is switched off
+    // (double speed requires twice the cycles per frame)
+    constexpr int max_cycles_per_frame = 2 * cycles_per_frame;
+
+} // namespace
+
+
+
+age::gb_emulator_batch::gb_emulator_batch(std::shared_ptr<const uint8_vector> rom,
+                                          int                                 emulator_count,
+                                          unsigned                            num_threads,
+                                          gb_device_type                      device_type,
+                                          gb_colors_hint                      colors_hint)
+{
+    assert(emulator_count > 0);
+    for (int i = 0; i < emulator_count; ++i)
+    {
+        auto emulator = std::make_unique<gb_emulator>(rom, device_type, colors_hint);
+        emulator->set_audio_enabled(false);
+        m_emulators.emplace_back(std::move(emulator));
+    }
+
+    const auto& first = *m_emulators[0];
+    m_screen_size     = first.get_screen_width() * first.get_screen_height();
+    m_screens.resize(static_cast<unsigned>(m_screen_size * emulator_count));
+    m_done_flags.resize(static_cast<unsigned>(emulator_count), 0);
+
+    // start worker threads,
+    // one thread per partition except for partition 0
+    m_partitions = std::clamp(static_cast<int>(num_threads), 1, emulator_count);
+    for (int partition = 1; partition < m_partitions; ++partition)
+    {
+        m_threads.emplace_back([this, partition]() {
+            unsigned last_generation = 0;
+            while (true)
+            {
+                int frames = 0;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_cv_start.wait(lock, [&]() {
+                        return m_terminate || (m_generation != last_generation);
+                    });
+                    if (m_terminate)
+                    {
+                        break;
+                    }
+                    last_generation = m_generation;
+                    frames          = m_frames;
+                }
+
+                emulate_partition(partition, frames);
+
+                bool all_finished = false;
+                {
+                    std::unique_lock lock(m_mutex);
+                    all_finished = --m_running_partitions == 0;
+                }
+                if (all_finished)
+                {
+                    m_cv_finished.notify_one();
+                }
+            }
+        });
+    }
+}
+
+age::gb_emulator_batch::~gb_emulator_batch()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_terminate = true;
+    }
+    m_cv_start.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+
+
+int age::gb_emulator_batch::get_emulator_count() const
+{
+    return static_cast<int>(m_emulators.size());
+}
+
+age::gb_emulator& age::gb_emulator_batch::get_emulator(int index)
+{
+    assert((index >= 0) && (index < get_emulator_count()));
+    return *m_emulators[static_cast<unsigned>(index)];
+}
+
+void age::gb_emulator_batch::set_audio_enabled(bool audio_enabled)
+{
+    for (auto& emulator : m_emulators)
+    {
+        emulator->set_audio_enabled(audio_enabled);
+    }
+}
+
+void age::gb_emulator_batch::set_ram_window(uint16_t address, int size)
+{
+    assert((size >= 0) && (address + size <= 0x10000));
+    m_ram_window_address = address;
+    m_ram_window_size    = size;
+    m_ram_windows.resize(static_cast<unsigned>(size * get_emulator_count()));
+}
+
+void age::gb_emulator_batch::set_done_condition(done_condition is_done)
+{
+    m_is_done = std::move(is_done);
+}
+
+void age::gb_emulator_batch::clear_done_flags()
+{
+    std::fill(begin(m_done_flags), end(m_done_flags), 0);
+}
+
+void age::gb_emulator_batch::emulate_frames(int frames)
+{
+    if (frames <= 0)
+    {
+        return;
+    }
+
+    // wake up the worker threads
+    if (!m_threads.empty())
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_frames             = frames;
+            m_running_partitions = m_partitions - 1;
+            ++m_generation;
+        }
+        m_cv_start.notify_all();
+    }
+
+    emulate_partition(0, frames);
+
+    // wait for the worker threads to finish
+    if (!m_threads.empty())
+    {
+        std::unique_lock lock(m_mutex);
+        m_cv_finished.wait(lock, [this]() {
+            return m_running_partitions == 0;
+        });
+    }
+}
+
+std::span<const age::pixel> age::gb_emulator_batch::get_screens() const
+{
+    return m_screens;
+}
+
+std::span<const age::uint8_t> age::gb_emulator_batch::get_ram_windows() const
+{
+    return m_ram_windows;
+}
+
+std::span<const age::uint8_t> age::gb_emulator_batch::get_done_flags() const
+{
+    return m_done_flags;
+}
+
+
+
+void age::gb_emulator_batch::emulate_partition(int partition, int frames)
+{
+    // fixed partitions: no synchronization required per instance
+    int count = get_emulator_count();
+    int first = partition * count / m_partitions;
+    int last  = (partition + 1) * count / m_partitions;
+
+    for (int index = first; index < last; ++index)
+    {
+        emulate_instance(index, frames);
+    }
+}
+
+void age::gb_emulator_batch::emulate_instance(int index, int frames)
+{
+    auto  idx      = static_cast<unsigned>(index);
+    auto& emulator = *m_emulators[idx];
+
+    for (int f = 0; (f < frames) && !m_done_flags[idx]; ++f)
+    {
+        for (int cycles = 0; cycles < max_cycles_per_frame; cycles += cycles_per_chunk)
+        {
+            if (emulator.emulate(cycles_per_chunk))
+            {
+                break;
+            }
+        }
+        if (m_is_done && m_is_done(emulator))
+        {
+            m_done_flags[idx] = 1;
+        }
+    }
+
+    // gather results
+    const auto& screen = emulator.get_screen_front_buffer();
+    std::copy(begin(screen), end(screen), begin(m_screens) + index * m_screen_size);
+
+    if (m_ram_window_size > 0)
+    {
+        std::span<uint8_t> ram_window(m_ram_windows.data() + index * m_ram_window_size,
+                                      static_cast<unsigned>(m_ram_window_size));
+        emulator.peek_memory(m_ram_window_address, ram_window);
+    }
+}
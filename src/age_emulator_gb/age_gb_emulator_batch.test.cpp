@@ -0,0 +1,143 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include <emulator/age_gb_emulator_batch.hpp>
+
+#include "age_gb_test_rom.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr int      emulator_count    = 7;
+    constexpr uint16_t ram_window        = 0xC000;
+    constexpr int      ram_window_size   = 2;
+    constexpr int      frames_until_done = 5;
+
+    //!
+    //! Create a rom that once per frame increments [0xC000]
+    //! and copies the joypad's direction keys to [0xC001].
+    //! (work ram is initialized randomly)
+    //!
+    std::shared_ptr<const age::uint8_vector> create_rom()
+    {
+        return age::gb_create_test_rom({
+            0xAF,             //       xor a
+            0xEA, 0x00, 0xC0, //       ld [0xC000], a
+            0x3E, 0x20,       //       ld a, 0x20
+            0xE0, 0x00,       //       ldh [P1], a
+            0xF0, 0x44,       // loop: ldh a, [LY]
+            0xFE, 0x90,       //       cp 144
+            0x20, 0xFA,       //       jr nz, loop
+            0xFA, 0x00, 0xC0, //       ld a, [0xC000]
+            0x3C,             //       inc a
+            0xEA, 0x00, 0xC0, //       ld [0xC000], a
+            0xF0, 0x00,       //       ldh a, [P1]
+            0xEA, 0x01, 0xC0, //       ld [0xC001], a
+            0xF0, 0x44,       // wait: ldh a, [LY]
+            0xFE, 0x90,       //       cp 144
+            0x28, 0xFA,       //       jr z, wait
+            0x18, 0xE6,       //       jr loop
+        });
+    }
+
+    bool is_done(const age::gb_emulator& emulator)
+    {
+        std::array<age::uint8_t, 1> frame_counter{};
+        emulator.peek_memory(ram_window, frame_counter);
+        return frame_counter[0] >= frames_until_done;
+    }
+
+    //! emulate frames like gb_emulator_batch does, but for a single emulator
+    void emulate_frames(age::gb_emulator& emulator, int frames, bool& done)
+    {
+        for (int f = 0; (f < frames) && !done; ++f)
+        {
+            for (int cycles = 0; cycles < 2 * 154 * 456; cycles += 16 * 456)
+            {
+                if (emulator.emulate(16 * 456))
+                {
+                    break;
+                }
+            }
+            done = is_done(emulator);
+        }
+    }
+
+} // namespace
+
+
+
+TEST(AgeGbEmulatorBatch, MatchesSequentialEmulation)
+{
+    auto rom = create_rom();
+
+    age::gb_emulator_batch batch(rom, emulator_count, 3, age::gb_device_type::dmg);
+    batch.set_ram_window(ram_window, ram_window_size);
+    batch.set_done_condition(is_done);
+
+    std::vector<std::unique_ptr<age::gb_emulator>> emulators;
+    std::vector<bool>                              done_flags(emulator_count, false);
+    for (int i = 0; i < emulator_count; ++i)
+    {
+        // instances differ by the direction keys being pressed
+        batch.get_emulator(i).set_buttons_down(i);
+        emulators.emplace_back(std::make_unique<age::gb_emulator>(rom, age::gb_device_type::dmg));
+        emulators.back()->set_buttons_down(i);
+    }
+
+    // emulate beyond the done condition
+    for (int run = 0; run < 3; ++run)
+    {
+        batch.emulate_frames(3);
+
+        auto screens     = batch.get_screens();
+        auto ram_windows = batch.get_ram_windows();
+        auto done        = batch.get_done_flags();
+
+        for (int i = 0; i < emulator_count; ++i)
+        {
+            auto& emulator = *emulators[i];
+            bool  is_done  = done_flags[i];
+            emulate_frames(emulator, 3, is_done);
+            done_flags[i] = is_done;
+
+            const auto& screen       = emulator.get_screen_front_buffer();
+            auto        batch_screen = screens.subspan(i * screen.size(), screen.size());
+            EXPECT_TRUE(std::equal(begin(screen), end(screen), begin(batch_screen))) << "instance " << i;
+
+            std::array<age::uint8_t, ram_window_size> ram{};
+            emulator.peek_memory(ram_window, ram);
+            EXPECT_EQ(ram[0], ram_windows[i * ram_window_size]) << "instance " << i;
+            EXPECT_EQ(ram[1], ram_windows[i * ram_window_size + 1]) << "instance " << i;
+
+            EXPECT_EQ(is_done, done[i] != 0) << "instance " << i;
+            EXPECT_EQ(emulator.get_emulated_cycles(), batch.get_emulator(i).get_emulated_cycles()) << "instance " << i;
+        }
+    }
+
+    // every instance finished after the same number of frames
+    for (int i = 0; i < emulator_count; ++i)
+    {
+        EXPECT_EQ(batch.get_ram_windows()[i * ram_window_size], frames_until_done);
+        EXPECT_EQ(batch.get_ram_windows()[i * ram_window_size + 1] & 0x0F, ~i & 0x0F) << "instance " << i;
+    }
+}
@@ -79,6 +79,36 @@ const age::pixel_vector& age::gb_emulator_impl::get_screen_front_buffer() const
     return m_screen_buffer.get_front_buffer();
 }
 
+age::uint64_t age::gb_emulator_impl::get_screen_front_buffer_hash() const
+{
+    return m_screen_buffer.get_front_buffer_hash();
+}
+
+bool age::gb_emulator_impl::is_screen_front_buffer_unchanged() const
+{
+    return m_screen_buffer.is_front_buffer_unchanged();
+}
+
+unsigned age::gb_emulator_impl::get_screen_frame_id() const
+{
+    return m_screen_buffer.get_current_frame_id();
+}
+
+void age::gb_emulator_impl::set_indexed_screen_enabled(bool enabled)
+{
+    m_lcd.set_indexed_screen_enabled(enabled);
+}
+
+age::gb_indexed_screen age::gb_emulator_impl::get_indexed_screen_front_buffer() const
+{
+    return m_lcd.get_indexed_screen();
+}
+
+void age::gb_emulator_impl::set_screen_rendering_enabled(bool enabled)
+{
+    m_lcd.set_rendering_enabled(enabled);
+}
+
 const age::pcm_vector& age::gb_emulator_impl::get_audio_buffer() const
 {
     return m_audio_buffer;
@@ -94,6 +124,17 @@ int age::gb_emulator_impl::get_cycles_per_second() const
     return gb_clock_cycles_per_second;
 }
 
+int age::gb_emulator_impl::get_cycles_per_frame() const
+{
+    return gb_clock_cycles_per_lcd_frame;
+}
+
+void age::gb_emulator_impl::set_audio_enabled(bool audio_enabled)
+{
+    m_sound.set_samples_enabled(audio_enabled);
+    m_audio_buffer.clear();
+}
+
 age::int64_t age::gb_emulator_impl::get_emulated_cycles() const
 {
     return m_emulated_cycles;
@@ -109,6 +150,24 @@ void age::gb_emulator_impl::set_persistent_ram(const uint8_vector& source)
     m_memory.set_persistent_ram(source);
 }
 
+bool age::gb_emulator_impl::is_persistent_ram_dirty() const
+{
+    return m_memory.is_persistent_ram_dirty();
+}
+
+int age::gb_emulator_impl::copy_dirty_persistent_ram(std::span<uint8_t> destination)
+{
+    return m_memory.copy_dirty_persistent_ram(destination);
+}
+
+void age::gb_emulator_impl::peek_memory(uint16_t address, std::span<uint8_t> destination) const
+{
+    for (auto& byte : destination)
+    {
+        byte = m_bus.peek_byte(address++);
+    }
+}
+
 void age::gb_emulator_impl::set_buttons_down(int buttons)
 {
     m_joypad.set_buttons_down(buttons);
@@ -141,6 +200,11 @@ age::gb_test_info age::gb_emulator_impl::get_test_info() const
     return m_cpu.get_test_info();
 }
 
+age::gb_render_stats age::gb_emulator_impl::get_render_stats() const
+{
+    return m_lcd.get_render_stats();
+}
+
 std::vector<age::gb_log_entry> age::gb_emulator_impl::get_and_clear_log_entries()
 {
     return m_logger.get_and_clear_log_entries();
@@ -270,16 +334,16 @@ int age::gb_emulator_impl::get_fast_forward_halt_cycles(int cycle_to_reach) cons
 //
 //---------------------------------------------------------
 
-age::gb_emulator_impl::gb_emulator_impl(const uint8_vector& rom,
-                                        gb_device_type      device_type,
-                                        gb_colors_hint      colors_hint,
-                                        gb_log_categories   log_categories)
+age::gb_emulator_impl::gb_emulator_impl(std::shared_ptr<const uint8_vector> rom,
+                                        gb_device_type                      device_type,
+                                        gb_colors_hint                      colors_hint,
+                                        gb_log_categories                   log_categories)
 
     : m_screen_buffer(gb_screen_width, gb_screen_height),
       m_logger(std::move(log_categories)),
-      m_device(rom, device_type),
+      m_device(*rom, device_type),
       m_clock(m_logger, m_device),
-      m_memory(rom, m_clock, m_device.is_cgb_device()),
+      m_memory(std::move(rom), m_clock, m_device.is_cgb_device()),
       m_interrupts(m_device, m_clock),
       m_events(m_clock),
       m_sound(m_device, m_clock, m_audio_buffer),
@@ -291,3 +355,30 @@ age::gb_emulator_impl::gb_emulator_impl(const uint8_vector& rom,
       m_cpu(m_device, m_clock, m_events, m_interrupts, m_bus)
 {
 }
+
+void age::gb_emulator_impl::reset(std::shared_ptr<const uint8_vector> rom,
+                                  gb_device_type                      device_type,
+                                  gb_colors_hint                      colors_hint)
+{
+    // keep the buffers allocated by this instance
+    m_screen_buffer.reset();
+    m_audio_buffer.clear();
+    m_emulated_cycles = 0;
+
+    // Reset the components in the order they have been constructed in,
+    // as some of them initialize their state based on the state
+    // of other components (e.g. the current clock cycle).
+    m_logger.reset();
+    m_device.reset(*rom, device_type);
+    m_clock.reset(m_device);
+    m_memory.reset(std::move(rom), m_device.is_cgb_device());
+    m_interrupts.reset();
+    m_events.reset();
+    m_sound.reset();
+    m_lcd.reset(m_memory.get_video_ram(), m_memory.get_rom_header(), colors_hint);
+    m_timer.reset();
+    m_joypad.reset(m_device);
+    m_serial.reset();
+    m_bus.reset();
+    m_cpu.reset();
+}
@@ -39,6 +39,9 @@
 #include <age_types.hpp>
 #include <emulator/age_gb_types.hpp>
 
+#include <memory>
+#include <span>
+
 
 
 namespace age
@@ -50,33 +53,49 @@ namespace age
         AGE_DISABLE_MOVE(gb_emulator_impl);
 
     public:
-        gb_emulator_impl(const uint8_vector& rom,
-                         gb_device_type      device_type,
-                         gb_colors_hint      colors_hint,
-                         gb_log_categories   log_categories);
+        gb_emulator_impl(std::shared_ptr<const uint8_vector> rom,
+                         gb_device_type                      device_type,
+                         gb_colors_hint                      colors_hint,
+                         gb_log_categories                   log_categories);
         ~gb_emulator_impl() = default;
 
+        void reset(std::shared_ptr<const uint8_vector> rom,
+                   gb_device_type                      device_type,
+                   gb_colors_hint                      colors_hint);
+
         [[nodiscard]] std::string get_emulator_title() const;
 
         [[nodiscard]] int16_t             get_screen_width() const;
         [[nodiscard]] int16_t             get_screen_height() const;
         [[nodiscard]] const pixel_vector& get_screen_front_buffer() const;
+        [[nodiscard]] uint64_t            get_screen_front_buffer_hash() const;
+        [[nodiscard]] bool                is_screen_front_buffer_unchanged() const;
+        [[nodiscard]] unsigned            get_screen_frame_id() const;
+        void                              set_indexed_screen_enabled(bool enabled);
+        [[nodiscard]] gb_indexed_screen   get_indexed_screen_front_buffer() const;
+        void                              set_screen_rendering_enabled(bool enabled);
 
         [[nodiscard]] const pcm_vector& get_audio_buffer() const;
         [[nodiscard]] int               get_pcm_sampling_rate() const;
+        void                            set_audio_enabled(bool audio_enabled);
 
         [[nodiscard]] int     get_cycles_per_second() const;
+        [[nodiscard]] int     get_cycles_per_frame() const;
         [[nodiscard]] int64_t get_emulated_cycles() const;
 
         [[nodiscard]] uint8_vector get_persistent_ram() const;
         void                       set_persistent_ram(const uint8_vector& source);
+        [[nodiscard]] bool         is_persistent_ram_dirty() const;
+        int                        copy_dirty_persistent_ram(std::span<uint8_t> destination);
+        void                       peek_memory(uint16_t address, std::span<uint8_t> destination) const;
 
         void set_buttons_down(int buttons);
         void set_buttons_up(int buttons);
 
         bool emulate(int cycles_to_emulate);
 
-        [[nodiscard]] gb_test_info get_test_info() const;
+        [[nodiscard]] gb_test_info    get_test_info() const;
+        [[nodiscard]] gb_render_stats get_render_stats() const;
 
         std::vector<gb_log_entry> get_and_clear_log_entries();
 
@@ -96,3 +96,10 @@ age::gb_joypad::gb_joypad(const gb_device&      device,
       m_p1(device.is_cgb_device() ? 0xFF : 0xCF)
 {
 }
+
+void age::gb_joypad::reset(const gb_device& device)
+{
+    m_p1  = device.is_cgb_device() ? 0xFF : 0xCF;
+    m_p14 = 0x0F;
+    m_p15 = 0x0F;
+}
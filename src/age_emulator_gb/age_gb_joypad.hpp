@@ -40,6 +40,8 @@ namespace age
         gb_joypad(const gb_device& device, gb_interrupt_trigger& interrupts);
         ~gb_joypad() = default;
 
+        void reset(const gb_device& device);
+
         [[nodiscard]] uint8_t read_p1() const;
         void                  write_p1(uint8_t byte);
         void                  set_buttons_down(int buttons);
@@ -65,6 +65,17 @@ age::gb_oam_dma::gb_oam_dma(const gb_device& device,
 {
 }
 
+void age::gb_oam_dma::reset()
+{
+    m_oam_dma_src_address    = 0;
+    m_oam_dma_offset         = 0;
+    m_oam_dma_last_cycle     = gb_no_clock_cycle;
+    m_override_next_oam_byte = uint16_t_max;
+    m_next_oam_byte          = 0;
+    m_oam_dma_active         = false;
+    m_oam_dma_reg            = m_device.is_cgb_device() ? 0x00 : 0xFF;
+}
+
 
 
 age::int16_t age::gb_oam_dma::conflicting_read(uint16_t address)
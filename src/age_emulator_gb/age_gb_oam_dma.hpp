@@ -55,6 +55,8 @@ namespace age
 
         ~gb_oam_dma() = default;
 
+        void reset();
+
         [[nodiscard]] bool dma_active() const
         {
             return m_oam_dma_active;
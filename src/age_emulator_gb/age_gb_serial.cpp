@@ -42,6 +42,16 @@ age::gb_serial::gb_serial(const gb_device&      device,
 {
 }
 
+void age::gb_serial::reset()
+{
+    m_sio_state       = gb_sio_state::no_transfer;
+    m_sio_clk_started = gb_no_clock_cycle;
+    m_sio_clock_shift = 0;
+    m_sio_initial_sb  = 0;
+    m_sb              = 0;
+    m_sc              = 0;
+}
+
 
 
 //---------------------------------------------------------
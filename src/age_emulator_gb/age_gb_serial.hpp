@@ -54,6 +54,8 @@ namespace age
                   gb_events&            events);
         ~gb_serial() = default;
 
+        void reset();
+
         uint8_t               read_sb();
         [[nodiscard]] uint8_t read_sc() const;
 
@@ -0,0 +1,72 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_GB_TEST_ROM_HPP
+#define AGE_GB_TEST_ROM_HPP
+
+//!
+//! \file
+//!
+
+#include <age_types.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+
+
+namespace age
+{
+    //! cartridge header flags of a rom created by gb_create_test_rom()
+    struct gb_test_rom_header
+    {
+        bool    m_cgb_rom        = false; //!< set the CGB flag (0x143)
+        uint8_t m_cartridge_type = 0x00;  //!< 0x147, e.g. 0x03 for MBC1 + RAM + BATTERY
+        uint8_t m_ram_size       = 0x00;  //!< 0x149, e.g. 0x02 for 8 KiB cartridge ram
+    };
+
+    //!
+    //! \brief Create a 32 KiB rom for unit tests,
+    //! that executes the specified hand-assembled code at 0x150.
+    //!
+    //! The rom's entry point jumps to 0x150,
+    //! all other bytes not set by the header are zero.
+    //!
+    inline std::shared_ptr<const uint8_vector> gb_create_test_rom(const uint8_vector&       code,
+                                                                  const gb_test_rom_header& header = {})
+    {
+        assert(code.size() <= 0x8000 - 0x150);
+        auto rom = std::make_shared<uint8_vector>(0x8000, 0);
+
+        // jp 0x150
+        (*rom)[0x101] = 0xC3;
+        (*rom)[0x102] = 0x50;
+        (*rom)[0x103] = 0x01;
+
+        (*rom)[0x143] = header.m_cgb_rom ? 0x80 : 0x00;
+        (*rom)[0x147] = header.m_cartridge_type;
+        (*rom)[0x149] = header.m_ram_size;
+
+        std::copy(begin(code), end(code), rom->begin() + 0x150);
+        return rom;
+    }
+
+} // namespace age
+
+
+
+#endif // AGE_GB_TEST_ROM_HPP
@@ -37,6 +37,16 @@ age::gb_timer::gb_timer(const gb_device&      device,
 {
 }
 
+void age::gb_timer::reset()
+{
+    m_clk_timer_zero    = gb_no_clock_cycle;
+    m_clk_last_overflow = gb_no_clock_cycle;
+    m_clock_shift       = 0;
+    m_tima              = 0;
+    m_tma               = 0;
+    m_tac               = 0xF8;
+}
+
 age::uint8_t age::gb_timer::get_clock_shift() const
 {
     // 00   (4096 Hz): clock cycle >> 10 (1024 clock cycles)
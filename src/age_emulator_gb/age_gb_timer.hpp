@@ -46,6 +46,8 @@ namespace age
 
         ~gb_timer() = default;
 
+        void reset();
+
         uint8_t               read_tima();
         [[nodiscard]] uint8_t read_tma() const;
         [[nodiscard]] uint8_t read_tac() const;
@@ -27,6 +27,8 @@
 #include <gfx/age_screen_buffer.hpp>
 #include <pcm/age_pcm_frame.hpp>
 
+#include <memory>
+#include <span>
 #include <string>
 
 
@@ -57,8 +59,32 @@ namespace age
                              gb_device_type      device_type    = gb_device_type::auto_detect,
                              gb_colors_hint      colors_hint    = gb_colors_hint::default_colors,
                              gb_log_categories   log_categories = {});
+
+        //!
+        //! \brief Create an emulator for a rom that may be shared with other
+        //! emulator instances.
+        //!
+        //! The rom is not copied, which saves memory and initialization time
+        //! when running many emulator instances for the same rom.
+        //!
+        explicit gb_emulator(std::shared_ptr<const uint8_vector> rom,
+                             gb_device_type                      device_type    = gb_device_type::auto_detect,
+                             gb_colors_hint                      colors_hint    = gb_colors_hint::default_colors,
+                             gb_log_categories                   log_categories = {});
+
         ~gb_emulator();
 
+        //!
+        //! \brief Reinitialize this emulator for the specified rom.
+        //!
+        //! The emulator's state is the same as that of a newly created
+        //! emulator, but previously allocated buffers are reused.
+        //! The log categories are kept.
+        //!
+        void reset(std::shared_ptr<const uint8_vector> rom,
+                   gb_device_type                      device_type = gb_device_type::auto_detect,
+                   gb_colors_hint                      colors_hint = gb_colors_hint::default_colors);
+
         //!
         //! \brief Get a human readable title for this emulator.
         //!
@@ -93,6 +119,81 @@ namespace age
         //!
         [[nodiscard]] const pixel_vector& get_screen_front_buffer() const;
 
+        //!
+        //! \brief Get a hash of the current front buffer.
+        //!
+        //! The hash is calculated while rendering,
+        //! right after a line has been finished.
+        //! For arbitrary screens the same hash can be calculated with
+        //! screen_buffer::calculate_hash().
+        //!
+        //! \return A 64 bit hash of the current front buffer.
+        //!
+        [[nodiscard]] uint64_t get_screen_front_buffer_hash() const;
+
+        //!
+        //! \brief Check if the current front buffer is identical to the
+        //! previous front buffer.
+        //!
+        //! Screens are compared by their hashes
+        //! (see get_screen_front_buffer_hash()).
+        //! Frontends may skip processing an unchanged screen.
+        //!
+        //! \return True if the current front buffer equals the previous one.
+        //!
+        [[nodiscard]] bool is_screen_front_buffer_unchanged() const;
+
+        //!
+        //! \brief Get the id of the current front buffer.
+        //!
+        //! The id is incremented for every emulated frame,
+        //! including frames emulated while the LCD is switched off
+        //! and frames not rendered (see set_screen_rendering_enabled()).
+        //! It wraps around on overflow.
+        //!
+        //! \return The id of the current front buffer.
+        //!
+        [[nodiscard]] unsigned get_screen_frame_id() const;
+
+        //!
+        //! \brief Enable or disable the indexed color screen buffer.
+        //!
+        //! If enabled, color indexes are written for every rendered frame
+        //! instead of RGBA pixels, see get_indexed_screen_front_buffer().
+        //! The screen returned by get_screen_front_buffer() is not updated
+        //! while indexing, it keeps the last frame rendered before
+        //! (the same goes for get_screen_front_buffer_hash() and
+        //! is_screen_front_buffer_unchanged()).
+        //! get_screen_frame_id() is incremented as usual.
+        //! Enabling or disabling it takes effect with the next frame.
+        //! The indexed screen buffer is disabled by default.
+        //!
+        void set_indexed_screen_enabled(bool enabled);
+
+        //!
+        //! \brief Get the last fully rendered Game Boy screen as color indexes.
+        //!
+        //! The indexed screen matches the screen that would have been
+        //! rendered as RGBA pixels (see gb_indexed_screen for exceptions),
+        //! but it is about four times smaller
+        //! (one byte per pixel plus the palettes used).
+        //! The returned spans are valid until the next call to emulate().
+        //! They are empty if the indexed screen buffer has never been enabled.
+        //!
+        [[nodiscard]] gb_indexed_screen get_indexed_screen_front_buffer() const;
+
+        //!
+        //! \brief Enable or disable rendering the Game Boy screen.
+        //!
+        //! If disabled, the emulation is not affected but frames are not
+        //! rendered (e.g. for fast-forwarding).
+        //! The front buffer keeps the last rendered frame instead,
+        //! as if the screen did not change.
+        //! Changes take effect with the next frame.
+        //! Rendering is enabled by default.
+        //!
+        void set_screen_rendering_enabled(bool enabled);
+
         //!
         //! \brief Get the vector of {@link pcm_frame}s calculated by the last
         //! call to emulate().
@@ -119,6 +220,15 @@ namespace age
         //!
         [[nodiscard]] int get_pcm_sampling_rate() const;
 
+        //!
+        //! \brief Enable or disable audio sample generation.
+        //!
+        //! If disabled, the audio state is still emulated
+        //! but get_audio_buffer() will be empty after calling emulate().
+        //! Audio is enabled by default.
+        //!
+        void set_audio_enabled(bool audio_enabled);
+
         //!
         //! \brief Get the number of native cycles per seconds.
         //!
@@ -129,6 +239,16 @@ namespace age
         //!
         [[nodiscard]] int get_cycles_per_second() const;
 
+        //!
+        //! \brief Get the number of native cycles per screen frame.
+        //!
+        //! This value can be used to pace the emulation frame by frame.
+        //! The returned value is greater than zero.
+        //!
+        //! \return The number of native cycles per screen frame.
+        //!
+        [[nodiscard]] int get_cycles_per_frame() const;
+
         [[nodiscard]] int64_t get_emulated_cycles() const;
 
         //!
@@ -155,6 +275,41 @@ namespace age
         //!
         void set_persistent_ram(const uint8_vector& source);
 
+        //!
+        //! \brief Check if the persistent ram has been modified since the
+        //! last call to copy_dirty_persistent_ram() or set_persistent_ram().
+        //!
+        [[nodiscard]] bool is_persistent_ram_dirty() const;
+
+        //!
+        //! \brief Copy all persistent ram pages modified since the last call
+        //! to this method (or to set_persistent_ram()).
+        //!
+        //! Modifications are tracked per page of 512 bytes.
+        //! Modified pages are copied to the same offset in the specified
+        //! destination, which must be as big as the persistent ram
+        //! (see get_persistent_ram()).
+        //! This allows for keeping a copy of the persistent ram up to date
+        //! without copying the whole ram, e.g. for saving it periodically.
+        //!
+        //! Note that MBC3 real time clock registers are not part of the
+        //! persistent ram.
+        //!
+        //! \return The number of pages copied.
+        //!
+        int copy_dirty_persistent_ram(std::span<uint8_t> destination);
+
+        //!
+        //! \brief Copy memory contents without any side effects on the
+        //! emulation.
+        //!
+        //! This covers rom, video ram, work ram and high ram
+        //! (considering the current banks).
+        //! Other memory areas like cartridge ram, OAM or registers
+        //! are read as 0xFF.
+        //!
+        void peek_memory(uint16_t address, std::span<uint8_t> destination) const;
+
         void set_buttons_down(int buttons);
         void set_buttons_up(int buttons);
 
@@ -162,6 +317,14 @@ namespace age
 
         [[nodiscard]] gb_test_info get_test_info() const;
 
+        //!
+        //! \brief Get rendering statistics of the last finished frame.
+        //!
+        //! This can be used to analyse how often the slower fifo renderer
+        //! is required for a rom.
+        //!
+        [[nodiscard]] gb_render_stats get_render_stats() const;
+
         std::vector<gb_log_entry> get_and_clear_log_entries();
 
     private:
@@ -0,0 +1,152 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_GB_EMULATOR_BATCH_HPP
+#define AGE_GB_EMULATOR_BATCH_HPP
+
+//!
+//! \file
+//!
+
+#include <age_types.hpp>
+#include <emulator/age_gb_emulator.hpp>
+#include <emulator/age_gb_types.hpp>
+#include <gfx/age_pixel.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+
+namespace age
+{
+
+    //!
+    //! \brief Step multiple emulator instances running the same rom.
+    //!
+    //! This is meant for running lots of emulator instances at once,
+    //! e.g. for automated testing or reinforcement learning environments.
+    //! All instances share the same read-only rom.
+    //! Screens, memory windows and done flags of all instances are gathered
+    //! in contiguous buffers after each call to emulate_frames().
+    //!
+    //! Instances are distributed across persistent worker threads
+    //! using a fixed partition per thread.
+    //! With one thread (or less) all instances are emulated by the calling
+    //! thread, e.g. for platforms without thread support.
+    //!
+    class gb_emulator_batch
+    {
+        AGE_DISABLE_COPY(gb_emulator_batch);
+        AGE_DISABLE_MOVE(gb_emulator_batch);
+
+    public:
+        //!
+        //! Evaluated after each frame to check if an instance has finished.
+        //! With more than one thread this is called concurrently from
+        //! different threads (for different instances) and thus must be
+        //! thread safe.
+        //!
+        using done_condition = std::function<bool(const gb_emulator&)>;
+
+        gb_emulator_batch(std::shared_ptr<const uint8_vector> rom,
+                          int                                 emulator_count,
+                          unsigned                            num_threads = std::thread::hardware_concurrency(),
+                          gb_device_type                      device_type = gb_device_type::auto_detect,
+                          gb_colors_hint                      colors_hint = gb_colors_hint::default_colors);
+        ~gb_emulator_batch();
+
+        [[nodiscard]] int          get_emulator_count() const;
+        [[nodiscard]] gb_emulator& get_emulator(int index);
+
+        //!
+        //! Audio is disabled by default for all instances,
+        //! the sound hardware is still emulated though.
+        //!
+        void set_audio_enabled(bool audio_enabled);
+
+        //!
+        //! \brief Set the memory window copied to get_ram_windows()
+        //! for every instance after each call to emulate_frames().
+        //!
+        //! Memory is read using gb_emulator::peek_memory().
+        //!
+        void set_ram_window(uint16_t address, int size);
+
+        //!
+        //! Instances are not emulated any further after they finished,
+        //! until clear_done_flags() is called.
+        //! The condition is called concurrently from worker threads,
+        //! see done_condition.
+        //!
+        void set_done_condition(done_condition is_done);
+        void clear_done_flags();
+
+        //!
+        //! \brief Emulate the specified number of frames for all instances
+        //! that did not finish yet.
+        //!
+        //! If an instance's LCD is switched off, a frame is considered
+        //! finished after emulating the cycles of about two LCD frames.
+        //!
+        void emulate_frames(int frames);
+
+        //! The screens of all instances, one after another.
+        [[nodiscard]] std::span<const pixel> get_screens() const;
+
+        //! The memory windows of all instances, one after another.
+        [[nodiscard]] std::span<const uint8_t> get_ram_windows() const;
+
+        //! One flag per instance: 1 if the instance finished, 0 otherwise.
+        [[nodiscard]] std::span<const uint8_t> get_done_flags() const;
+
+    private:
+        void emulate_partition(int partition, int frames);
+        void emulate_instance(int index, int frames);
+
+        std::vector<std::unique_ptr<gb_emulator>> m_emulators;
+        done_condition                            m_is_done;
+        int                                       m_screen_size;
+        uint16_t                                  m_ram_window_address = 0;
+        int                                       m_ram_window_size    = 0;
+
+        pixel_vector m_screens;
+        uint8_vector m_ram_windows;
+        uint8_vector m_done_flags;
+
+        // worker threads
+        // (partition 0 is emulated by the calling thread)
+        std::vector<std::thread> m_threads;
+        std::mutex               m_mutex;
+        std::condition_variable  m_cv_start;
+        std::condition_variable  m_cv_finished;
+        int                      m_partitions         = 1;
+        int                      m_frames             = 0;
+        unsigned                 m_generation         = 0;
+        int                      m_running_partitions = 0;
+        bool                     m_terminate          = false;
+    };
+
+} // namespace age
+
+
+
+#endif // AGE_GB_EMULATOR_BATCH_HPP
@@ -22,7 +22,9 @@
 //!
 
 #include <age_types.hpp>
+#include <gfx/age_pixel.hpp>
 
+#include <span>
 #include <string>
 #include <unordered_set>
 
@@ -126,6 +128,57 @@ namespace age
 
 
 
+    //!
+    //! \brief Struct containing rendering statistics of a single frame.
+    //!
+    //! Lines are usually rendered by the fast line renderer.
+    //! The slower fifo renderer is used only for lines that may change
+    //! while being rendered.
+    //!
+    struct gb_render_stats
+    {
+        int m_line_rendered_lines = 0;
+        int m_fifo_rendered_lines = 0;
+    };
+
+
+
+    //!
+    //! \brief The number of colors of a gb_indexed_screen palette.
+    //!
+    //! The first 64 colors are the Game Boy palette colors
+    //! (4 colors for each of the 16 palettes),
+    //! which makes a color index equal to <tt>palette * 4 + color</tt>.
+    //! They are followed by the 4 DMG shades used for pixels that
+    //! don't use any palette color (e.g. due to the DMG BGP glitch).
+    //!
+    constexpr int gb_indexed_palette_size = 68;
+
+    //!
+    //! \brief Screen contents made of 8 bit color indexes.
+    //!
+    //! Every line refers to a palette of gb_indexed_palette_size colors,
+    //! lines may share the same palette.
+    //! A palette is stored only if the colors changed since the previous
+    //! palette.
+    //! If the colors change while a line is being rendered,
+    //! the line's remaining pixels refer to the next palette by adding
+    //! gb_indexed_palette_size to their color indexes.
+    //! A line may refer to up to three palettes this way
+    //! (any further change is applied to the line's third palette).
+    //!
+    //! The color of pixel (x, y) is:
+    //! <tt>m_palettes[m_line_palettes[y] * gb_indexed_palette_size + m_color_indexes[y * width + x]]</tt>
+    //!
+    struct gb_indexed_screen
+    {
+        std::span<const uint8_t>  m_color_indexes;
+        std::span<const uint16_t> m_line_palettes;
+        std::span<const pixel>    m_palettes;
+    };
+
+
+
     enum class gb_log_category
     {
         lc_clock,
@@ -37,6 +37,16 @@ void age::gb_set_back_clock_cycle(int& clock_cycle, int cycle_offset)
 age::gb_clock::gb_clock(gb_logger& logger, const gb_device& device)
     : m_logger(logger)
 {
+    reset(device);
+}
+
+void age::gb_clock::reset(const gb_device& device)
+{
+    m_machine_cycle_clocks = 4;
+    m_key1                 = 0x7E;
+    m_old_div_offset       = 0;
+    m_div_offset           = 0;
+
     if (device.cgb_mode())
     {
         // Gambatte tests:
@@ -71,6 +71,8 @@ namespace age
         explicit gb_clock(gb_logger& logger, const gb_device& device);
         ~gb_clock() = default;
 
+        void reset(const gb_device& device);
+
         //! \brief Get the current 4Mhz cycle.
         //!
         //! This clock runs at 4Mhz regardless of the current
@@ -76,3 +76,10 @@ age::gb_device::gb_device(const uint8_vector&  rom,
       m_device_type(calculate_device_type(device_type, m_device_mode))
 {
 }
+
+void age::gb_device::reset(const uint8_vector&  rom,
+                           const gb_device_type device_type)
+{
+    m_device_mode = calculate_device_mode(rom, device_type);
+    m_device_type = calculate_device_type(device_type, m_device_mode);
+}
@@ -46,6 +46,8 @@ namespace age
     public:
         gb_device(const uint8_vector& rom, gb_device_type device_type);
 
+        void reset(const uint8_vector& rom, gb_device_type device_type);
+
         //!
         //! The emulated device is a Game Boy Classic.
         //!
@@ -88,8 +90,8 @@ namespace age
         }
 
     private:
-        const gb_device_mode m_device_mode;
-        const gb_device_type m_device_type;
+        gb_device_mode m_device_mode;
+        gb_device_type m_device_type;
     };
 
 } // namespace age
@@ -28,12 +28,18 @@
 //---------------------------------------------------------
 
 age::gb_sorted_events::gb_sorted_events()
+{
+    clear();
+}
+
+void age::gb_sorted_events::clear()
 {
     std::for_each(begin(m_active_events),
                   end(m_active_events),
                   [&](auto& aev) {
                       aev = gb_no_clock_cycle;
                   });
+    m_events.clear(); // keeps the allocated memory
 }
 
 
@@ -174,6 +180,11 @@ age::gb_events::gb_events(const gb_clock& clock)
 {
 }
 
+void age::gb_events::reset()
+{
+    m_events.clear();
+}
+
 
 
 void age::gb_events::schedule_event(gb_event event, int clock_cycle_offset)
@@ -43,13 +43,9 @@ namespace age
         //! oscillation stabilization (HALT mode) that follows each STOP.
         unhalt = 6,
 
-        //! To keep up the framerate while the LCD is switched off,
-        //! we create a stream of empty frames.
-        next_empty_frame = 7,
+        start_oam_dma = 7,
 
-        start_oam_dma = 8,
-
-        none = 9 // must be the last value
+        none = 8 // must be the last value
     };
 
 
@@ -59,6 +55,7 @@ namespace age
     public:
         gb_sorted_events();
 
+        void                 clear();
         void                 schedule_event(gb_event event, int for_clock_cycle);
         bool                 remove_event(gb_event event);
         [[nodiscard]] int    get_event_cycle(gb_event event) const;
@@ -89,6 +86,7 @@ namespace age
         explicit gb_events(const gb_clock& clock);
         ~gb_events() = default;
 
+        void              reset();
         void              schedule_event(gb_event event, int clock_cycle_offset);
         void              remove_event(gb_event event);
         [[nodiscard]] int get_event_cycle(gb_event event) const;
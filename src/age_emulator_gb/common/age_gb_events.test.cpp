@@ -63,6 +63,32 @@ TEST(AgeGbSortedEvents, PollsBasedOnCycle)
 
 
 
+TEST(AgeGbSortedEvents, PollsSimultaneousEventsInEventOrder)
+{
+    // every event value below gb_event::none must be usable
+    // (e.g. start_oam_dma after removing next_empty_frame)
+    constexpr int event_count = age::to_underlying(age::gb_event::none);
+    EXPECT_EQ(event_count, 8);
+    EXPECT_EQ(age::to_underlying(age::gb_event::start_oam_dma), event_count - 1);
+
+    age::gb_sorted_events events;
+    for (int ev = event_count - 1; ev >= 0; --ev)
+    {
+        events.schedule_event(static_cast<age::gb_event>(ev), 10);
+    }
+    for (int ev = 0; ev < event_count; ++ev)
+    {
+        EXPECT_EQ(events.get_event_cycle(static_cast<age::gb_event>(ev)), 10);
+    }
+    EXPECT_EQ(events.get_events_scheduled(), event_count);
+
+    for (int ev = 0; ev < event_count; ++ev)
+    {
+        EXPECT_EQ(events.poll_next_event(10), static_cast<age::gb_event>(ev));
+    }
+    EXPECT_EQ(events.poll_next_event(max_clock_cycle), age::gb_event::none);
+}
+
 TEST(AgeGbSortedEvents, KeepsTrackOfScheduledEventCycle)
 {
     age::gb_sorted_events events;
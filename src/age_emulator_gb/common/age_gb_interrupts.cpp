@@ -45,6 +45,15 @@ age::gb_interrupt_trigger::gb_interrupt_trigger(const gb_device& device,
 {
 }
 
+void age::gb_interrupt_trigger::reset()
+{
+    m_if              = 0xE1;
+    m_ie              = 0;
+    m_during_dispatch = 0;
+    m_ime             = false;
+    m_halted          = false;
+}
+
 
 
 void age::gb_interrupt_trigger::trigger_interrupt(gb_interrupt interrupt,
@@ -52,6 +52,7 @@ namespace age
         gb_interrupt_trigger(const gb_device& device, gb_clock& clock);
         ~gb_interrupt_trigger() = default;
 
+        void reset();
         void trigger_interrupt(gb_interrupt interrupt, int irq_clock_cycle);
 
         // logging code is header-only to allow for compile time optimization
@@ -237,6 +237,13 @@ namespace age
             m_clock_offset += clock_cycle_offset;
         }
 
+        //! Discard all log entries and start over at clock cycle zero.
+        void reset()
+        {
+            m_messages.clear();
+            m_clock_offset = 0;
+        }
+
     private:
         gb_log_categories         m_log_categories;
         std::vector<gb_log_entry> m_messages;
@@ -268,6 +275,11 @@ namespace age
         void set_back_clock([[maybe_unused]] int clock_cycle_offset)
         {
         }
+
+        // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+        void reset()
+        {
+        }
 #endif
     };
 
@@ -30,7 +30,6 @@ age::gb_lcd::gb_lcd(const gb_device&         device,
                     gb_colors_hint           colors_hint)
     : m_device(device),
       m_clock(clock),
-      m_events(events),
       m_line(device, clock),
       m_lcd_irqs(device, clock, m_line, events, interrupts),
       m_palettes(device, rom_header, colors_hint),
@@ -39,6 +38,20 @@ age::gb_lcd::gb_lcd(const gb_device&         device,
 {
 }
 
+void age::gb_lcd::reset(std::span<uint8_t const> video_ram,
+                        std::span<uint8_t const> rom_header,
+                        gb_colors_hint           colors_hint)
+{
+    m_line.reset(m_device);
+    m_lcd_irqs.reset();
+    m_palettes.reset(rom_header, colors_hint);
+    m_sprites.reset(m_device.cgb_mode());
+    m_render.reset(video_ram);
+
+    m_retained_ly_match    = 0;
+    m_clk_next_empty_frame = gb_no_clock_cycle;
+}
+
 
 
 bool age::gb_lcd::is_video_ram_accessible()
@@ -77,6 +90,32 @@ bool age::gb_lcd::is_video_ram_accessible()
 
 
 
+void age::gb_lcd::before_video_ram_write()
+{
+    if (!m_line.lcd_is_on())
+    {
+        return;
+    }
+
+    // During mode 2 the current line is not affected by the old video ram
+    // contents.
+    // Rendering only the previous lines keeps the current line from being
+    // fifo-rendered just because of this write.
+    auto line = calculate_line();
+    if (!m_render.render_previous_lines(line, m_line.is_first_frame()))
+    {
+        update_state();
+        m_render.switch_to_fifo_renderer();
+    }
+}
+
+void age::gb_lcd::after_video_ram_write(int vram_offset)
+{
+    m_render.after_video_ram_write(vram_offset);
+}
+
+
+
 void age::gb_lcd::after_speed_change()
 {
     if (m_line.lcd_is_on() && m_clock.is_double_speed())
@@ -111,9 +150,30 @@ void age::gb_lcd::set_back_clock(int clock_cycle_offset)
 {
     m_line.set_back_clock(clock_cycle_offset);
     m_lcd_irqs.set_back_clock(clock_cycle_offset);
+    gb_set_back_clock_cycle(m_clk_next_empty_frame, clock_cycle_offset);
+}
+
+
+
+void age::gb_lcd::set_indexed_screen_enabled(bool enabled)
+{
+    m_render.set_indexed_screen_enabled(enabled);
 }
 
+void age::gb_lcd::set_rendering_enabled(bool enabled)
+{
+    m_render.set_rendering_enabled(enabled);
+}
 
+age::gb_indexed_screen age::gb_lcd::get_indexed_screen() const
+{
+    return m_render.get_indexed_screen();
+}
+
+age::gb_render_stats age::gb_lcd::get_render_stats() const
+{
+    return m_render.get_render_stats();
+}
 
 void age::gb_lcd::update_state()
 {
@@ -124,6 +184,7 @@ void age::gb_lcd::check_for_finished_frame()
 {
     if (!m_line.lcd_is_on())
     {
+        check_for_empty_frames();
         return;
     }
     auto line = m_line.current_line();
@@ -133,10 +194,22 @@ void age::gb_lcd::check_for_finished_frame()
     }
 }
 
-void age::gb_lcd::next_empty_frame()
+void age::gb_lcd::check_for_empty_frames()
 {
-    m_render.new_frame(true);
-    m_events.schedule_event(gb_event::next_empty_frame, gb_clock_cycles_per_lcd_frame);
+    // To keep up the framerate while the LCD is switched off,
+    // we create a stream of empty frames.
+    // As the screen does not change, the empty frame rendered when
+    // switching off the LCD is just repeated.
+    // Repeated frames are counted here instead of scheduling an event for
+    // each frame, which allows for fast-forwarding HALT over multiple frames.
+    int clk_current = m_clock.get_clock_cycle();
+    if ((m_clk_next_empty_frame == gb_no_clock_cycle) || (clk_current < m_clk_next_empty_frame))
+    {
+        return;
+    }
+    int frames = 1 + (clk_current - m_clk_next_empty_frame) / gb_clock_cycles_per_lcd_frame;
+    m_render.repeat_frame(frames);
+    m_clk_next_empty_frame += frames * gb_clock_cycles_per_lcd_frame;
 }
 
 
@@ -173,7 +246,15 @@ bool age::gb_lcd::update_frame(int line_clock_offset)
     // begin a new frame, if the current frame is finished
     // (we do NOT start rendering the new frame here,
     // call update_frame() a second time to do this)
-    m_line.fast_forward_frames();
+    int frames = m_line.fast_forward_frames();
     m_render.new_frame(is_first_frame);
+
+    // Frames passed without any LCD related change since then
+    // look like the frame just finished.
+    // Repeat it to keep up the framerate.
+    if (frames > 1)
+    {
+        m_render.repeat_frame(frames - 1);
+    }
     return true;
 }
@@ -55,6 +55,8 @@ namespace age
         gb_lcd_line(const gb_device& device, const gb_clock& clock);
         ~gb_lcd_line() = default;
 
+        void reset(const gb_device& device);
+
         void align_after_speed_change(int clock_cycle_offset);
         void set_back_clock(int clock_cycle_offset);
 
@@ -65,7 +67,7 @@ namespace age
         int  clk_frame_start() const;
         bool is_first_frame() const;
         bool is_odd_alignment() const;
-        void fast_forward_frames();
+        int  fast_forward_frames();
 
         gb_current_line current_line() const;
         gb_current_line calculate_line(int clock_cycle) const;
@@ -105,6 +107,8 @@ namespace age
 
         ~gb_lcd_irqs() = default;
 
+        void reset();
+
         [[nodiscard]] uint8_t read_stat() const;
         void                  write_stat(uint8_t value, int scx);
         void                  on_lyc_change();
@@ -158,6 +162,10 @@ namespace age
 
         ~gb_lcd() = default;
 
+        void reset(std::span<uint8_t const> video_ram,
+                   std::span<uint8_t const> rom_header,
+                   gb_colors_hint           colors_hint);
+
         uint8_t read_lcdc() const;
         uint8_t read_stat();
         uint8_t read_scy() const;
@@ -193,6 +201,8 @@ namespace age
         void    write_oam(int offset, uint8_t value);
         void    write_oam_dma(int offset, uint8_t value);
         bool    is_video_ram_accessible();
+        void    before_video_ram_write();
+        void    after_video_ram_write(int vram_offset);
 
         void after_speed_change();
         void trigger_irq_vblank();
@@ -201,9 +211,13 @@ namespace age
         void trigger_irq_mode0();
         void set_back_clock(int clock_cycle_offset);
 
+        void                            set_indexed_screen_enabled(bool enabled);
+        void                            set_rendering_enabled(bool enabled);
+        [[nodiscard]] gb_indexed_screen get_indexed_screen() const;
+        [[nodiscard]] gb_render_stats   get_render_stats() const;
+
         void update_state();
         void check_for_finished_frame();
-        void next_empty_frame();
 
     private:
         // logging code is header-only to allow for compile time optimization
@@ -216,6 +230,8 @@ namespace age
         bool is_oam_writable(gb_current_line& line);
         void update_state(int line_clock_offset);
         bool update_frame(int line_clock_offset = 0);
+        void check_for_empty_frames();
+        bool is_same_value(const char* register_name, uint8_t current_value, uint8_t value) const;
 
         //! This function should be used when update_state() has not been
         //! called before.
@@ -227,14 +243,14 @@ namespace age
 
         const gb_device& m_device;
         const gb_clock&  m_clock;
-        gb_events&       m_events;
         gb_lcd_line      m_line;
         gb_lcd_irqs      m_lcd_irqs;
         gb_lcd_palettes  m_palettes;
         gb_lcd_sprites   m_sprites;
         gb_lcd_renderer  m_render;
 
-        uint8_t m_retained_ly_match = 0;
+        uint8_t m_retained_ly_match    = 0;
+        int     m_clk_next_empty_frame = gb_no_clock_cycle;
     };
 
 } // namespace age
@@ -47,6 +47,16 @@ age::gb_lcd_irqs::gb_lcd_irqs(const gb_device&      device,
       m_events(events),
       m_interrupts(interrupts)
 {
+    reset();
+}
+
+void age::gb_lcd_irqs::reset()
+{
+    m_clk_next_irq_lyc   = gb_no_clock_cycle;
+    m_clk_next_irq_mode2 = gb_no_clock_cycle;
+    m_clk_next_irq_mode0 = gb_no_clock_cycle;
+    m_stat               = 0x80;
+
     int clk_current     = m_clock.get_clock_cycle();
     int clk_frame_start = m_line.clk_frame_start();
     assert(m_line.lcd_is_on());
@@ -30,9 +30,18 @@ namespace
 
 age::gb_lcd_line::gb_lcd_line(const gb_device& device,
                               const gb_clock&  clock)
-    : m_clock(clock),
-      m_clk_frame_start(m_clock.get_clock_cycle())
+    : m_clock(clock)
 {
+    reset(device);
+}
+
+void age::gb_lcd_line::reset(const gb_device& device)
+{
+    m_clk_frame_start = m_clock.get_clock_cycle();
+    m_line            = 0;
+    m_first_frame     = false;
+    m_lyc             = 0;
+
     if (device.cgb_mode())
     {
         m_clk_frame_start += 4396 - gb_clock_cycles_per_lcd_frame;
@@ -132,7 +141,7 @@ bool age::gb_lcd_line::is_odd_alignment() const
     return (m_clk_frame_start & 1) != 0;
 }
 
-void age::gb_lcd_line::fast_forward_frames()
+int age::gb_lcd_line::fast_forward_frames()
 {
     assert(lcd_is_on());
 
@@ -140,17 +149,20 @@ void age::gb_lcd_line::fast_forward_frames()
     int clk_current = m_clock.get_clock_cycle();
     int clks        = clk_current - m_clk_frame_start;
 
-    if (clks >= gb_clock_cycles_per_lcd_frame)
+    if (clks < gb_clock_cycles_per_lcd_frame)
     {
-        int frames = clks / gb_clock_cycles_per_lcd_frame;
-        m_clk_frame_start += frames * gb_clock_cycles_per_lcd_frame;
+        return 0;
+    }
 
-        m_clk_line_start = m_clk_frame_start;
-        m_line           = 0;
-        m_first_frame    = false;
+    int frames = clks / gb_clock_cycles_per_lcd_frame;
+    m_clk_frame_start += frames * gb_clock_cycles_per_lcd_frame;
 
-        log_frame_alignment();
-    }
+    m_clk_line_start = m_clk_frame_start;
+    m_line           = 0;
+    m_first_frame    = false;
+
+    log_frame_alignment();
+    return frames;
 }
 
 void age::gb_lcd_line::log_frame_alignment() const
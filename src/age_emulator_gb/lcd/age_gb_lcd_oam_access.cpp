@@ -111,6 +111,11 @@ bool age::gb_lcd::is_oam_writable(gb_current_line& line)
 
 void age::gb_lcd::write_oam_dma(int offset, uint8_t value)
 {
+    if (m_sprites.read_oam(offset) == value)
+    {
+        return; // nothing changed, no need to render anything up to now
+    }
     update_state(); // make sure everything is rendered up to now
+    m_render.switch_to_fifo_renderer();
     m_sprites.write_oam(offset, value);
 }
@@ -54,6 +54,7 @@ void age::gb_lcd::write_lcdc(uint8_t value)
 
         // LCD remains on -> update state before updating LCDC
         update_state();
+        m_render.switch_to_fifo_renderer();
         auto line = m_line.current_line(); // update_state() called, no need for calculate_line()
 
         // tile data bit changed
@@ -87,10 +88,14 @@ void age::gb_lcd::write_lcdc(uint8_t value)
     if (value & gb_lcdc_enable)
     {
         msg << "\n    * LCD switched on";
+        // finish all blank frames up to now
+        // (not done by check_for_finished_frame() if the LCD is switched
+        // off and on again during the same emulation step)
+        check_for_empty_frames();
         m_render.set_lcdc(value);
         m_line.lcd_on();
         m_lcd_irqs.lcd_on(m_render.m_scx);
-        m_events.remove_event(gb_event::next_empty_frame);
+        m_clk_next_empty_frame = gb_no_clock_cycle;
     }
 
     // LCD switched off
@@ -113,7 +118,9 @@ void age::gb_lcd::write_lcdc(uint8_t value)
         m_line.lcd_off();
         m_render.set_lcdc(value);
 
-        next_empty_frame(); // start stream of white frames
+        // start stream of white frames
+        m_render.new_frame(true);
+        m_clk_next_empty_frame = m_clock.get_clock_cycle() + gb_clock_cycles_per_lcd_frame;
     }
 }
 
@@ -272,6 +279,23 @@ age::uint8_t age::gb_lcd::read_ly()
 //
 //---------------------------------------------------------
 
+bool age::gb_lcd::is_same_value(const char* register_name, uint8_t current_value, uint8_t value) const
+{
+    // Writing the current value does not change anything rendering related,
+    // so we don't have to render the current frame up to now.
+    // If nothing else changes, the whole frame will be rendered at once
+    // after the last visible line.
+    if (current_value != value)
+    {
+        return false;
+    }
+    log_reg() << "write " << register_name << " = " << log_hex8(value) << log_line_clks(m_line)
+              << "\n    * same value as before";
+    return true;
+}
+
+
+
 age::uint8_t age::gb_lcd::read_scy() const
 {
     log_reg() << "read SCY == " << log_hex8(m_render.m_scy);
@@ -358,9 +382,14 @@ age::uint8_t age::gb_lcd::read_ocpd() const
 
 void age::gb_lcd::write_scy(uint8_t value)
 {
+    if (is_same_value("SCY", m_render.m_scy, value))
+    {
+        return;
+    }
     if (m_line.lcd_is_on())
     {
         update_state(m_device.is_cgb_device() ? 1 : 0);
+        m_render.switch_to_fifo_renderer();
     }
     log_reg() << "write SCY = " << log_hex8(value) << log_line_clks(m_line);
     m_render.m_scy = value;
@@ -368,7 +397,12 @@ void age::gb_lcd::write_scy(uint8_t value)
 
 void age::gb_lcd::write_scx(uint8_t value)
 {
+    if (is_same_value("SCX", m_render.m_scx, value))
+    {
+        return;
+    }
     update_state();
+    m_render.switch_to_fifo_renderer();
     log_reg() << "write SCX = " << log_hex8(value) << log_line_clks(m_line);
     m_render.m_scx = value;
 }
@@ -405,6 +439,10 @@ void age::gb_lcd::write_bgp(uint8_t value)
 
 void age::gb_lcd::write_obp0(uint8_t value)
 {
+    if (is_same_value("OBP0", m_palettes.read_obp0(), value))
+    {
+        return;
+    }
     update_state();
     log_reg() << "write OBP0 = " << log_hex8(value) << log_line_clks(m_line);
     m_palettes.write_obp0(value);
@@ -412,6 +450,10 @@ void age::gb_lcd::write_obp0(uint8_t value)
 
 void age::gb_lcd::write_obp1(uint8_t value)
 {
+    if (is_same_value("OBP1", m_palettes.read_obp1(), value))
+    {
+        return;
+    }
     update_state();
     log_reg() << "write OBP1 = " << log_hex8(value) << log_line_clks(m_line);
     m_palettes.write_obp1(value);
@@ -440,6 +482,10 @@ void age::gb_lcd::write_wy(uint8_t value)
 
 void age::gb_lcd::write_wx(uint8_t value)
 {
+    if (is_same_value("WX", m_render.m_wx, value))
+    {
+        return;
+    }
     if (m_line.lcd_is_on())
     {
         update_state(m_device.is_dmg_device() ? 0 : 1);
@@ -25,6 +25,8 @@
 
 #include <age_types.hpp>
 
+#include <cstring> // memcpy
+
 namespace age
 {
     constexpr int16_t gb_clock_cycles_per_lcd_line  = 456;
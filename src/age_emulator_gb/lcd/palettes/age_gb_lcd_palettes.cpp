@@ -16,6 +16,7 @@
 
 #include "age_gb_lcd_palettes.hpp"
 
+#include <algorithm> // std::fill
 #include <cassert>
 
 
@@ -41,14 +42,33 @@ age::gb_lcd_palettes::gb_lcd_palettes(const gb_device&         device,
                                       std::span<uint8_t const> rom_header,
                                       gb_colors_hint           colors_hint)
     : m_device(device),
-      m_colors_hint(colors_hint),
-      m_obp0(m_device.is_cgb_device() ? 0x00 : 0xFF),
-      m_obp1(m_device.is_cgb_device() ? 0x00 : 0xFF)
+      m_colors_hint(colors_hint)
 {
+    reset(rom_header, colors_hint);
+}
+
+void age::gb_lcd_palettes::reset(std::span<uint8_t const> rom_header, gb_colors_hint colors_hint)
+{
+    m_colors_hint = colors_hint;
+
+    std::fill(begin(m_cpd), end(m_cpd), 0);
+    std::fill(begin(m_colors), end(m_colors), pixel(0, 0, 0));
+
+    m_bgp_colors  = {{pixel(0x98C00F), pixel(0x70980F), pixel(0x30600F), pixel(0x0F380F)}};
+    m_obp0_colors = m_bgp_colors;
+    m_obp1_colors = m_bgp_colors;
+
+    m_bgp          = 0xFC;
+    m_previous_bgp = 0xFC;
+    m_obp0         = m_device.is_cgb_device() ? 0x00 : 0xFF;
+    m_obp1         = m_device.is_cgb_device() ? 0x00 : 0xFF;
+    m_bcps         = 0xC0;
+    m_ocps         = 0xC1;
+
     if (!m_device.cgb_mode())
     {
         // setup DMG palettes
-        if (device.non_cgb_mode())
+        if (m_device.non_cgb_mode())
         {
             init_dmg_colors(rom_header);
         }
@@ -67,6 +87,11 @@ age::gb_lcd_palettes::gb_lcd_palettes(const gb_device&         device,
 
 
 
+std::span<const age::pixel, age::gb_total_color_count> age::gb_lcd_palettes::get_colors() const
+{
+    return std::span<const age::pixel, gb_total_color_count>{m_colors.begin(), gb_total_color_count};
+}
+
 std::span<const age::pixel, 4> age::gb_lcd_palettes::get_palette(unsigned palette_index) const
 {
     assert(palette_index < gb_palette_count);
@@ -81,10 +106,7 @@ age::pixel age::gb_lcd_palettes::get_color(unsigned color_index) const
 
 age::pixel age::gb_lcd_palettes::get_color_bgp_glitch(unsigned int color_index) const
 {
-    assert(color_index < 4);
-    uint8_t glitched_bgp = m_bgp | m_previous_bgp;
-    glitched_bgp >>= color_index * 2;
-    return m_bgp_colors[glitched_bgp & 0x03];
+    return m_bgp_colors[get_dmg_shade_bgp_glitch(color_index)];
 }
 
 age::pixel age::gb_lcd_palettes::get_color_zero_dmg() const
@@ -92,6 +114,19 @@ age::pixel age::gb_lcd_palettes::get_color_zero_dmg() const
     return m_bgp_colors[0];
 }
 
+std::span<const age::pixel, 4> age::gb_lcd_palettes::get_dmg_shades() const
+{
+    return m_bgp_colors;
+}
+
+unsigned age::gb_lcd_palettes::get_dmg_shade_bgp_glitch(unsigned color_index) const
+{
+    assert(color_index < 4);
+    uint8_t glitched_bgp = m_bgp | m_previous_bgp;
+    glitched_bgp >>= color_index * 2;
+    return glitched_bgp & 0x03;
+}
+
 age::uint8_t age::gb_lcd_palettes::read_bgp() const
 {
     return m_bgp;
@@ -61,10 +61,18 @@ namespace age
 
         ~gb_lcd_palettes() = default;
 
-        [[nodiscard]] std::span<const pixel, 4> get_palette(unsigned palette_index) const;
-        [[nodiscard]] pixel                     get_color(unsigned color_index) const;
-        [[nodiscard]] pixel                     get_color_bgp_glitch(unsigned color_index) const;
-        [[nodiscard]] pixel                     get_color_zero_dmg() const;
+        void reset(std::span<uint8_t const> rom_header, gb_colors_hint colors_hint);
+
+        [[nodiscard]] std::span<const pixel, gb_total_color_count> get_colors() const;
+        [[nodiscard]] std::span<const pixel, 4>                    get_palette(unsigned palette_index) const;
+        [[nodiscard]] pixel                                        get_color(unsigned color_index) const;
+        [[nodiscard]] pixel                                        get_color_bgp_glitch(unsigned color_index) const;
+        [[nodiscard]] pixel                                        get_color_zero_dmg() const;
+
+        //! The 4 DMG shades BGP maps color indexes to.
+        [[nodiscard]] std::span<const pixel, 4> get_dmg_shades() const;
+        //! The DMG shade used for the BGP glitch (see get_color_bgp_glitch()).
+        [[nodiscard]] unsigned get_dmg_shade_bgp_glitch(unsigned color_index) const;
 
         [[nodiscard]] uint8_t read_bgp() const;
         [[nodiscard]] uint8_t read_obp0() const;
@@ -85,12 +93,12 @@ namespace age
     private:
         void init_dmg_colors(std::span<uint8_t const> rom_header);
 
-        void  update_dmg_palette(unsigned palette_index, uint8_t value);
-        void  update_cgb_color(unsigned color_index);
-        pixel lookup_cgb_color(unsigned cgb_rgb15);
+        void         update_dmg_palette(unsigned palette_index, uint8_t value);
+        void         update_cgb_color(unsigned color_index);
+        static pixel lookup_cgb_color(unsigned cgb_rgb15);
 
-        const gb_device&     m_device;
-        const gb_colors_hint m_colors_hint;
+        const gb_device& m_device;
+        gb_colors_hint   m_colors_hint;
 
         // CGB:     0x00 - 0x3F  BG
         //          0x40 - 0x7F  OBJ
@@ -109,8 +117,6 @@ namespace age
         std::array<pixel, 4> m_obp0_colors{{pixel(0x98C00F), pixel(0x70980F), pixel(0x30600F), pixel(0x0F380F)}};
         std::array<pixel, 4> m_obp1_colors{{pixel(0x98C00F), pixel(0x70980F), pixel(0x30600F), pixel(0x0F380F)}};
 
-        pixel_vector m_cgb_color_lut{};
-
         uint8_t m_bgp          = 0xFC;
         uint8_t m_previous_bgp = 0xFC;
         uint8_t m_obp0         = 0xFF;
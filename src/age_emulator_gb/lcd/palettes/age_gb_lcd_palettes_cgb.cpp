@@ -103,15 +103,20 @@ namespace
 
 age::pixel age::gb_lcd_palettes::lookup_cgb_color(unsigned cgb_rgb15)
 {
-    if (m_cgb_color_lut.empty())
-    {
-        m_cgb_color_lut.reserve(0x8000);
+    // The lookup table is calculated once and shared by all instances
+    // (thread-safe initialization of function-local statics).
+    // It's not calculated at compile time as std::pow() is not constexpr.
+    static const pixel_vector cgb_color_lut = []() {
+        pixel_vector lut;
+        lut.reserve(0x8000);
         for (int gb_rgb15 = 0; gb_rgb15 < 0x8000; ++gb_rgb15)
         {
-            m_cgb_color_lut.emplace_back(cgb_color_correction(gb_rgb15));
+            lut.emplace_back(cgb_color_correction(gb_rgb15));
         }
-    }
-    return m_cgb_color_lut[cgb_rgb15 & 0x7FFFU];
+        return lut;
+    }();
+
+    return cgb_color_lut[cgb_rgb15 & 0x7FFFU];
 }
 
 
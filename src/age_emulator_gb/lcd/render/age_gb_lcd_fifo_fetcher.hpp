@@ -27,8 +27,8 @@
 
 #include <age_types.hpp>
 
+#include <array>
 #include <cassert>
-#include <deque>
 #include <span>
 
 
@@ -49,7 +49,63 @@ namespace age
         uint8_t  m_attributes;
     };
 
-    using gb_sp_fifo = std::deque<gb_sp_dot>;
+    //!
+    //! The sprite fifo holds up to 8 dots.
+    //! It is implemented as fixed size ring buffer so that pushing
+    //! and popping dots does not allocate any memory.
+    //!
+    class gb_sp_fifo
+    {
+    public:
+        [[nodiscard]] bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        [[nodiscard]] int size() const
+        {
+            return m_size;
+        }
+
+        gb_sp_dot& operator[](int index)
+        {
+            assert((index >= 0) && (index < m_size));
+            return m_dots[(m_first + index) & fifo_mask];
+        }
+
+        gb_sp_dot pop_front()
+        {
+            assert(m_size > 0);
+            auto dot = m_dots[m_first];
+            m_first  = (m_first + 1) & fifo_mask;
+            --m_size;
+            return dot;
+        }
+
+        void clear()
+        {
+            m_first = 0;
+            m_size  = 0;
+        }
+
+        //! Fill up the fifo with transparent dots.
+        void fill()
+        {
+            for (int i = m_size; i < fifo_size; ++i)
+            {
+                m_dots[(m_first + i) & fifo_mask] = {};
+            }
+            m_size = fifo_size;
+        }
+
+    private:
+        static constexpr int fifo_size = 8;
+        static constexpr int fifo_mask = fifo_size - 1;
+
+        std::array<gb_sp_dot, fifo_size> m_dots{};
+        int                              m_first = 0;
+        int                              m_size  = 0;
+    };
 
 
 
@@ -74,10 +130,25 @@ namespace age
 
         ~gb_lcd_fifo_fetcher() = default;
 
+        void set_video_ram(std::span<uint8_t const> video_ram)
+        {
+            m_video_ram = video_ram;
+        }
+
 
 
+        void reset()
+        {
+            m_line           = gb_no_line.m_line;
+            m_next_step_clks = gb_no_clock_cycle;
+            m_sp_fifo.clear();
+        }
+
         void init_for_line(int line, bool is_line_zero)
         {
+            // sprite dots of an unfinished line must not show up on this line
+            m_sp_fifo.clear();
+
             m_line           = line;
             m_next_step      = fetcher_step::fetch_bg_name;
             m_next_step_clks = is_line_zero ? 87 : 85;
@@ -177,13 +248,7 @@ namespace age
 
         age::gb_sp_dot pop_sp_dot()
         {
-            if (m_sp_fifo.empty())
-            {
-                return {};
-            }
-            auto sp_px = m_sp_fifo[0];
-            m_sp_fifo.pop_front();
-            return sp_px;
+            return m_sp_fifo.empty() ? gb_sp_dot{} : m_sp_fifo.pop_front();
         }
 
 
@@ -397,8 +462,7 @@ namespace age
 
         void apply_sp_bitplane()
         {
-            assert(m_sp_fifo.size() <= 8);
-            m_sp_fifo.resize(8);
+            m_sp_fifo.fill();
 
             uint16_t priority = m_device.cgb_mode()
                                     ? m_spr_to_fetch_id
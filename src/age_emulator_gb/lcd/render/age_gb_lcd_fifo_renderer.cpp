@@ -33,12 +33,14 @@ age::gb_lcd_fifo_renderer::gb_lcd_fifo_renderer(const gb_device&              de
                                                 const gb_lcd_sprites&         sprites,
                                                 std::span<uint8_t const>      video_ram,
                                                 gb_window_check&              window,
+                                                gb_lcd_indexed_screen&        indexed_screen,
                                                 screen_buffer&                screen_buffer)
     : m_device(device),
       m_common(common),
       m_palettes(palettes),
       m_sprites(sprites),
       m_window(window),
+      m_indexed_screen(indexed_screen),
       m_screen_buffer(screen_buffer),
       m_fetcher(device, common, video_ram, sprites, window)
 {
@@ -76,18 +78,47 @@ void age::gb_lcd_fifo_renderer::set_clks_bgp_change(gb_current_line at_line)
 void age::gb_lcd_fifo_renderer::reset()
 {
     m_line = gb_no_line;
+    m_fetcher.reset();
+}
+
+void age::gb_lcd_fifo_renderer::set_video_ram(std::span<uint8_t const> video_ram)
+{
+    m_fetcher.set_video_ram(video_ram);
 }
 
 void age::gb_lcd_fifo_renderer::begin_new_line(gb_current_line line, bool is_first_frame)
+{
+    init_line(line, is_first_frame);
+    m_line_indexes   = m_indexed_screen.begin_line(line.m_line);
+    m_plotted_pixels = 0;
+    continue_line(line);
+}
+
+void age::gb_lcd_fifo_renderer::take_over_line(gb_current_line until, int plotted_pixels)
+{
+    assert((plotted_pixels >= 0) && (plotted_pixels < gb_screen_width));
+    if (!plotted_pixels)
+    {
+        begin_new_line(until, false);
+        return;
+    }
+    // keep the palette assigned to the line's color indexes
+    init_line(until, false);
+    m_line_indexes   = m_indexed_screen.continue_line(until.m_line);
+    m_plotted_pixels = plotted_pixels;
+    continue_line(until);
+}
+
+void age::gb_lcd_fifo_renderer::init_line(gb_current_line line, bool is_first_frame)
 {
     assert(!in_progress());
     bool is_line_zero = is_first_frame && (line.m_line == 0);
 
     //! \todo sprites should be searched step by step in mode 2
-    m_sorted_sprites = m_sprites.get_line_sprites(line.m_line, true);
-    // first sprite last in vector (so that we can easily pop_back() to the next sprite)
+    m_sorted_sprites = m_sprites.get_line_sprites(line.m_line, true, m_line_sprites);
+    // first sprite last in span (so that we can easily drop the last element to get to the next sprite)
     std::reverse(m_sorted_sprites.begin(), m_sorted_sprites.end());
-    m_next_sprite_x = m_sorted_sprites.empty() ? -1 : m_sorted_sprites.back().m_x;
+    m_next_sprite_x  = m_sorted_sprites.empty() ? -1 : m_sorted_sprites.back().m_x;
 
     m_line                 = {.m_line = line.m_line, .m_line_clks = 0};
     m_line_stage           = line_stage::mode2;
@@ -101,8 +132,6 @@ void age::gb_lcd_fifo_renderer::begin_new_line(gb_current_line line, bool is_fir
     // m_alignment_scx = 0;
 
     m_fetcher.init_for_line(line.m_line, is_line_zero);
-
-    continue_line(line);
 }
 
 bool age::gb_lcd_fifo_renderer::continue_line(gb_current_line until)
@@ -117,6 +146,12 @@ bool age::gb_lcd_fifo_renderer::continue_line(gb_current_line until)
         m_x_pos_win_start = int_max;
     }
 
+    // the palette might have changed since the last call
+    if (!m_line_indexes.empty())
+    {
+        m_color_index_offset = m_indexed_screen.get_color_index_offset(m_line.m_line);
+    }
+
     // finish line?
     int current_line_clks = (until.m_line > m_line.m_line)
                                 ? gb_clock_cycles_per_lcd_line
@@ -336,22 +371,44 @@ void age::gb_lcd_fifo_renderer::plot_pixel()
         uint8_t bg_prio_flag = (m_fetcher.get_bg_attributes() | sp_dot.m_attributes) & gb_tile_attrib_priority;
         uint8_t prio         = ((bg_color & 0b11) | bg_prio_flag) & m_common.m_priority_mask;
 
-        pixel color;
         if ((prio <= 0x80) && (sp_dot.m_color & 0b11))
         {
-            color = m_palettes.get_color(sp_dot.m_color);
+            plot_pixel(m_palettes.get_color(sp_dot.m_color), sp_dot.m_color);
+            return;
         }
-        else
-        {
-            // BGP glitch not on the first pixel, see age-test-roms/m3-bg-bgp
-            bool bgp_glitch = (m_clks_bgp_change.m_line_clks == m_line.m_line_clks + 1)
-                              && (m_x_pos > gb_x_pos_first_px);
 
-            color = bgp_glitch ? m_palettes.get_color_bgp_glitch(bg_color)
-                               : m_palettes.get_color(bg_color);
+        // BGP glitch not on the first pixel, see age-test-roms/m3-bg-bgp
+        bool bgp_glitch = (m_clks_bgp_change.m_line_clks == m_line.m_line_clks + 1)
+                          && (m_x_pos > gb_x_pos_first_px);
+
+        if (bgp_glitch)
+        {
+            plot_pixel(m_palettes.get_color_bgp_glitch(bg_color),
+                       gb_total_color_count + m_palettes.get_dmg_shade_bgp_glitch(bg_color));
+            return;
         }
+        plot_pixel(m_palettes.get_color(bg_color), bg_color);
+    }
+}
+
+void age::gb_lcd_fifo_renderer::plot_pixel(pixel color, unsigned color_index)
+{
+    // color_index: see gb_indexed_screen
+    int line_x = m_x_pos - gb_x_pos_first_px;
+    if (line_x < m_plotted_pixels)
+    {
+        return; // plotted by the line renderer
+    }
+    auto x = static_cast<unsigned>(line_x);
 
-        m_line_buffer[m_x_pos - gb_x_pos_first_px] = color;
+    // indexed frames replace RGBA frames
+    if (m_line_indexes.empty())
+    {
+        m_line_buffer[x] = color;
+    }
+    else
+    {
+        m_line_indexes[x] = static_cast<uint8_t>(color_index + m_color_index_offset);
     }
 }
 
@@ -367,7 +424,7 @@ bool age::gb_lcd_fifo_renderer::dmg_wx_glitch()
         return false;
     }
 
-    m_line_buffer[m_x_pos - gb_x_pos_first_px] = m_palettes.get_color_zero_dmg();
+    plot_pixel(m_palettes.get_color_zero_dmg(), gb_total_color_count); // DMG shade 0
     m_fetcher.restart_bg_fetch(m_line.m_line_clks + 1);
     return true;
 }
@@ -415,8 +472,8 @@ bool age::gb_lcd_fifo_renderer::fetch_next_sprite()
     {
         while (m_next_sprite_x == m_x_pos)
         {
-            m_sorted_sprites.pop_back();
-            m_next_sprite_x = m_sorted_sprites.empty() ? -1 : m_sorted_sprites.back().m_x;
+            m_sorted_sprites = m_sorted_sprites.first(m_sorted_sprites.size() - 1);
+            m_next_sprite_x  = m_sorted_sprites.empty() ? -1 : m_sorted_sprites.back().m_x;
         }
         return false;
     }
@@ -431,8 +488,8 @@ bool age::gb_lcd_fifo_renderer::fetch_next_sprite()
     m_fetcher.trigger_sprite_fetch(sprite.m_sprite_id, sprite.m_x, m_line.m_line_clks, spx0_delay);
 
     // watch out for the next sprite
-    m_sorted_sprites.pop_back();
-    m_next_sprite_x = m_sorted_sprites.empty() ? -1 : m_sorted_sprites.back().m_x;
+    m_sorted_sprites = m_sorted_sprites.first(m_sorted_sprites.size() - 1);
+    m_next_sprite_x  = m_sorted_sprites.empty() ? -1 : m_sorted_sprites.back().m_x;
 
     return true;
 }
@@ -24,6 +24,7 @@
 #include "../../common/age_gb_device.hpp"
 #include "../palettes/age_gb_lcd_palettes.hpp"
 #include "age_gb_lcd_fifo_fetcher.hpp"
+#include "age_gb_lcd_indexed_screen.hpp"
 #include "age_gb_lcd_renderer_common.hpp"
 #include "age_gb_lcd_sprites.hpp"
 #include "age_gb_lcd_window_check.hpp"
@@ -52,6 +53,7 @@ namespace age
                              const gb_lcd_sprites&         sprites,
                              std::span<uint8_t const>      video_ram,
                              gb_window_check&              window,
+                             gb_lcd_indexed_screen&        indexed_screen,
                              screen_buffer&                screen_buffer);
 
         ~gb_lcd_fifo_renderer() = default;
@@ -62,9 +64,21 @@ namespace age
         void set_clks_tile_data_change(gb_current_line at_line);
         void set_clks_bgp_change(gb_current_line at_line);
         void reset();
+        void set_video_ram(std::span<uint8_t const> video_ram);
         void begin_new_line(gb_current_line line, bool is_first_frame);
         bool continue_line(gb_current_line until);
 
+        //!
+        //! \brief Continue a line of which the line renderer already
+        //! plotted the specified number of pixels.
+        //!
+        //! Except for palettes, everything the line depends on must not
+        //! have changed since mode 3 started.
+        //! The line is fifo-rendered from its start without plotting the
+        //! pixels again.
+        //!
+        void take_over_line(gb_current_line until, int plotted_pixels);
+
     private:
         enum class line_stage
         {
@@ -75,6 +89,7 @@ namespace age
             mode3_wait_for_sprite,
             rendering_finished,
         };
+        void init_line(gb_current_line line, bool is_first_frame);
         void update_line_stage(int until_line_clks);
         void line_stage_mode2(int until_line_clks);
         void line_stage_mode3_align_scx(int until_line_clks);
@@ -82,6 +97,7 @@ namespace age
         void line_stage_mode3_init_window(int until_line_clks);
         void line_stage_mode3_wait_for_sprite(int until_line_clks);
         void plot_pixel();
+        void plot_pixel(pixel color, unsigned color_index);
         bool dmg_wx_glitch();
         bool init_window();
         bool fetch_next_sprite();
@@ -91,21 +107,26 @@ namespace age
         const gb_lcd_palettes&        m_palettes;
         const gb_lcd_sprites&         m_sprites;
         gb_window_check&              m_window;
+        gb_lcd_indexed_screen&        m_indexed_screen;
         screen_buffer&                m_screen_buffer;
 
-        std::vector<gb_sprite> m_sorted_sprites{};
-        gb_lcd_fifo_fetcher    m_fetcher;
-
-        gb_current_line  m_line       = gb_no_line;
-        line_stage       m_line_stage = line_stage::mode2;
-        std::span<pixel> m_line_buffer;
-        int              m_clks_begin_align_scx = 0;
-        int              m_clks_end_window_init = 0;
-        int              m_x_pos                = 0;
-        int              m_x_pos_win_start      = 0;
-        int              m_alignment_x          = 0;
-        gb_current_line  m_clks_bgp_change      = gb_no_line;
-        int              m_next_sprite_x        = -1;
+        gb_line_sprites      m_line_sprites{};
+        std::span<gb_sprite> m_sorted_sprites{};
+        gb_lcd_fifo_fetcher  m_fetcher;
+
+        gb_current_line    m_line       = gb_no_line;
+        line_stage         m_line_stage = line_stage::mode2;
+        std::span<pixel>   m_line_buffer;
+        std::span<uint8_t> m_line_indexes; //!< empty if the current frame is not indexed
+        uint8_t            m_color_index_offset   = 0;
+        int                m_clks_begin_align_scx = 0;
+        int                m_clks_end_window_init = 0;
+        int                m_x_pos                = 0;
+        int                m_x_pos_win_start      = 0;
+        int                m_alignment_x          = 0;
+        gb_current_line    m_clks_bgp_change      = gb_no_line;
+        int                m_next_sprite_x        = -1;
+        int                m_plotted_pixels       = 0; //!< pixels plotted by the line renderer
     };
 
 } // namespace age
@@ -0,0 +1,187 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "age_gb_lcd_indexed_screen.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility> // std::swap
+
+namespace
+{
+    constexpr unsigned screen_pixels = age::gb_screen_width * age::gb_screen_height;
+    constexpr unsigned palette_size  = age::gb_indexed_palette_size;
+
+    constexpr unsigned max_line_palettes  = 3; //!< color indexes are stored as uint8_t
+    constexpr unsigned max_frame_palettes = max_line_palettes * age::gb_screen_height;
+
+    static_assert(age::gb_indexed_palette_size == age::gb_total_color_count + 4);
+    static_assert(max_line_palettes * palette_size <= 256);
+
+} // namespace
+
+
+
+age::gb_lcd_indexed_screen::gb_lcd_indexed_screen(const gb_lcd_palettes& palettes)
+    : m_palettes(palettes)
+{
+}
+
+void age::gb_lcd_indexed_screen::reset()
+{
+    for (auto* frame : {&m_front, &m_back})
+    {
+        frame->m_color_indexes.clear();
+        frame->m_line_palettes.clear();
+        frame->m_palettes.clear();
+    }
+    m_enabled  = false;
+    m_indexing = false;
+}
+
+bool age::gb_lcd_indexed_screen::is_enabled() const
+{
+    return m_enabled;
+}
+
+bool age::gb_lcd_indexed_screen::is_indexing() const
+{
+    return m_indexing;
+}
+
+void age::gb_lcd_indexed_screen::set_enabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (enabled && m_front.m_color_indexes.empty())
+    {
+        for (auto* frame : {&m_front, &m_back})
+        {
+            frame->m_color_indexes.resize(screen_pixels, 0);
+            frame->m_line_palettes.resize(gb_screen_height, 0);
+            // no allocation when storing palettes
+            frame->m_palettes.reserve(max_frame_palettes * palette_size);
+        }
+        // black screen until the first indexed frame is finished
+        m_front.m_palettes.resize(palette_size, pixel(0, 0, 0));
+    }
+}
+
+age::gb_indexed_screen age::gb_lcd_indexed_screen::get_front_buffer() const
+{
+    return {
+        .m_color_indexes = m_front.m_color_indexes,
+        .m_line_palettes = m_front.m_line_palettes,
+        .m_palettes      = m_front.m_palettes,
+    };
+}
+
+
+
+std::span<age::uint8_t> age::gb_lcd_indexed_screen::begin_line(int line)
+{
+    if (!m_indexing)
+    {
+        return {};
+    }
+    assert((line >= 0) && (line < gb_screen_height));
+    auto line_idx = static_cast<unsigned>(line);
+
+    m_back.m_line_palettes[line_idx] = static_cast<uint16_t>(update_palette(max_frame_palettes - 1));
+    return std::span<uint8_t>(m_back.m_color_indexes).subspan(line_idx * gb_screen_width, gb_screen_width);
+}
+
+std::span<age::uint8_t> age::gb_lcd_indexed_screen::continue_line(int line)
+{
+    if (!m_indexing)
+    {
+        return {};
+    }
+    assert((line >= 0) && (line < gb_screen_height));
+    auto line_idx = static_cast<unsigned>(line);
+    return std::span<uint8_t>(m_back.m_color_indexes).subspan(line_idx * gb_screen_width, gb_screen_width);
+}
+
+age::uint8_t age::gb_lcd_indexed_screen::get_color_index_offset(int line)
+{
+    assert(m_indexing);
+    assert((line >= 0) && (line < gb_screen_height));
+
+    unsigned line_palette_id = m_back.m_line_palettes[static_cast<unsigned>(line)];
+    unsigned palette_id      = update_palette(line_palette_id + max_line_palettes - 1);
+    return static_cast<uint8_t>((palette_id - line_palette_id) * palette_size);
+}
+
+void age::gb_lcd_indexed_screen::blank_frame(pixel blank_color)
+{
+    // a blank frame is indexed even if it was not rendered
+    m_indexing = m_enabled;
+    if (!m_indexing)
+    {
+        return;
+    }
+    m_back.m_palettes.assign(palette_size, blank_color);
+    std::fill(begin(m_back.m_line_palettes), end(m_back.m_line_palettes), 0);
+    std::fill(begin(m_back.m_color_indexes), end(m_back.m_color_indexes), 0);
+}
+
+void age::gb_lcd_indexed_screen::switch_buffers()
+{
+    if (m_indexing)
+    {
+        std::swap(m_front, m_back);
+    }
+}
+
+void age::gb_lcd_indexed_screen::begin_frame(bool frame_is_rendered)
+{
+    m_indexing = m_enabled && frame_is_rendered;
+    m_back.m_palettes.clear(); // keeps the allocated memory
+}
+
+
+
+unsigned age::gb_lcd_indexed_screen::update_palette(unsigned max_palette_id)
+{
+    auto& palettes      = m_back.m_palettes;
+    auto  palette_count = static_cast<unsigned>(palettes.size() / palette_size);
+    auto  colors        = m_palettes.get_colors();
+    auto  dmg_shades    = m_palettes.get_dmg_shades();
+
+    if (palette_count > 0)
+    {
+        auto last_palette = std::span<pixel>(palettes).last(palette_size);
+        auto last_shades  = last_palette.subspan(colors.size());
+
+        // colors unchanged => use the last palette
+        if (std::equal(begin(colors), end(colors), begin(last_palette))
+            && std::equal(begin(dmg_shades), end(dmg_shades), begin(last_shades)))
+        {
+            return palette_count - 1;
+        }
+
+        // no more palettes allowed => overwrite the last palette
+        if (palette_count > max_palette_id)
+        {
+            std::copy(begin(colors), end(colors), begin(last_palette));
+            std::copy(begin(dmg_shades), end(dmg_shades), begin(last_shades));
+            return palette_count - 1;
+        }
+    }
+
+    palettes.insert(end(palettes), begin(colors), end(colors));
+    palettes.insert(end(palettes), begin(dmg_shades), end(dmg_shades));
+    return palette_count;
+}
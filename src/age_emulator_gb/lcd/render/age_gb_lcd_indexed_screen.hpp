@@ -0,0 +1,130 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_GB_LCD_INDEXED_SCREEN_HPP
+#define AGE_GB_LCD_INDEXED_SCREEN_HPP
+
+//!
+//! \file
+//!
+
+#include "../common/age_gb_lcd_common.hpp"
+#include "../palettes/age_gb_lcd_palettes.hpp"
+
+#include <emulator/age_gb_types.hpp>
+
+#include <age_types.hpp>
+#include <gfx/age_pixel.hpp>
+
+#include <span>
+#include <vector>
+
+
+
+namespace age
+{
+    //!
+    //! Holds the color indexes written by line- and fifo-renderer
+    //! (see gb_indexed_screen for details).
+    //! The renderers write a frame's color indexes instead of its RGBA pixels.
+    //!
+    //! The current Game Boy colors are stored as new palette only if they
+    //! changed since the last palette was stored.
+    //! This is checked whenever a renderer begins or continues a line.
+    //!
+    //! A line can refer to at most three palettes,
+    //! as color indexes are stored as uint8_t
+    //! (3 * gb_indexed_palette_size = 204 color indexes).
+    //! If the colors change more than twice while a line is rendered,
+    //! the line's third palette is overwritten with the latest colors.
+    //! Pixels already written using the third palette then show the
+    //! latest colors, which makes the indexed screen differ from the
+    //! RGBA screen.
+    //! This requires palette writes during mode 3 of the same line
+    //! and does not happen for most roms.
+    //!
+    class gb_lcd_indexed_screen
+    {
+        AGE_DISABLE_COPY(gb_lcd_indexed_screen);
+        AGE_DISABLE_MOVE(gb_lcd_indexed_screen);
+
+    public:
+        explicit gb_lcd_indexed_screen(const gb_lcd_palettes& palettes);
+        ~gb_lcd_indexed_screen() = default;
+
+        //! Disable indexing and clear all buffers without releasing their memory.
+        void reset();
+
+        [[nodiscard]] bool              is_enabled() const;
+        [[nodiscard]] bool              is_indexing() const; //!< the current frame is indexed
+        void                            set_enabled(bool enabled); //!< takes effect with the next frame
+        [[nodiscard]] gb_indexed_screen get_front_buffer() const;
+
+        //!
+        //! Assign the current palette to the specified line and return
+        //! the line's color indexes for writing.
+        //! The returned span is empty, if the current frame is not indexed.
+        //!
+        std::span<uint8_t> begin_line(int line);
+
+        //!
+        //! Return the color indexes of a line already begun with
+        //! begin_line() without assigning the current palette to it.
+        //! The returned span is empty, if the current frame is not indexed.
+        //!
+        std::span<uint8_t> continue_line(int line);
+
+        //!
+        //! Get the offset to add to the color indexes written for the
+        //! specified line, which is not zero if the palette changed since
+        //! the line has been begun.
+        //!
+        uint8_t get_color_index_offset(int line);
+
+        //!
+        //! Index all lines of the current frame with the specified color
+        //! (if indexing is enabled, even if the frame was not rendered).
+        //!
+        void blank_frame(pixel blank_color);
+
+        //! Make the current frame the front buffer, if it has been indexed.
+        void switch_buffers();
+
+        //! Start a new frame, which is indexed only if indexing is enabled and the frame is rendered.
+        void begin_frame(bool frame_is_rendered);
+
+    private:
+        struct indexed_frame
+        {
+            uint8_vector          m_color_indexes;
+            std::vector<uint16_t> m_line_palettes;
+            pixel_vector          m_palettes;
+        };
+
+        unsigned update_palette(unsigned max_palette_id);
+
+        const gb_lcd_palettes& m_palettes;
+        indexed_frame          m_front{};
+        indexed_frame          m_back{};
+        bool                   m_enabled  = false;
+        bool                   m_indexing = false; //!< the current frame is indexed
+    };
+
+} // namespace age
+
+
+
+#endif // AGE_GB_LCD_INDEXED_SCREEN_HPP
@@ -0,0 +1,194 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "../../common/age_gb_device.hpp"
+#include "age_gb_lcd_indexed_screen.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+
+
+namespace
+{
+    constexpr unsigned palette_size = age::gb_indexed_palette_size;
+
+    class gb_lcd_indexed_screen_fixture
+    {
+    public:
+        gb_lcd_indexed_screen_fixture()
+            : m_rom(0x8000, 0),
+              m_device(m_rom, age::gb_device_type::dmg),
+              m_palettes(m_device, std::span(m_rom).first(0x150), age::gb_colors_hint::dmg_greyscale),
+              m_indexed_screen(m_palettes)
+        {
+        }
+
+        age::uint8_vector          m_rom;
+        age::gb_device             m_device;
+        age::gb_lcd_palettes       m_palettes;
+        age::gb_lcd_indexed_screen m_indexed_screen;
+    };
+
+    age::pixel color_of(const age::gb_indexed_screen& indexed, int x, int y)
+    {
+        auto palette = indexed.m_line_palettes[static_cast<unsigned>(y)];
+        auto index   = indexed.m_color_indexes[static_cast<unsigned>(y * age::gb_screen_width + x)];
+        return indexed.m_palettes[palette * palette_size + index];
+    }
+
+} // namespace
+
+
+
+TEST(AgeGbLcdIndexedScreen, DisabledByDefault)
+{
+    gb_lcd_indexed_screen_fixture fixture;
+    auto&                         indexed_screen = fixture.m_indexed_screen;
+    indexed_screen.begin_frame(true);
+
+    EXPECT_FALSE(indexed_screen.is_enabled());
+    EXPECT_TRUE(indexed_screen.begin_line(0).empty());
+    EXPECT_TRUE(indexed_screen.get_front_buffer().m_color_indexes.empty());
+}
+
+TEST(AgeGbLcdIndexedScreen, EnablingTakesEffectWithNextFrame)
+{
+    gb_lcd_indexed_screen_fixture fixture;
+    auto&                         indexed_screen = fixture.m_indexed_screen;
+    indexed_screen.begin_frame(true);
+    indexed_screen.set_enabled(true);
+    EXPECT_TRUE(indexed_screen.begin_line(0).empty());
+
+    // black screen until the first indexed frame is finished
+    auto indexed = indexed_screen.get_front_buffer();
+    EXPECT_EQ(indexed.m_color_indexes.size(), age::gb_screen_width * age::gb_screen_height);
+    EXPECT_EQ(color_of(indexed, 0, 0), age::pixel(0, 0, 0));
+
+    indexed_screen.begin_frame(true);
+    EXPECT_EQ(indexed_screen.begin_line(0).size(), age::gb_screen_width);
+
+    // frames not rendered are not indexed
+    indexed_screen.begin_frame(false);
+    EXPECT_TRUE(indexed_screen.begin_line(0).empty());
+}
+
+TEST(AgeGbLcdIndexedScreen, StoresPaletteOnlyIfChanged)
+{
+    gb_lcd_indexed_screen_fixture fixture;
+    auto&                         indexed_screen = fixture.m_indexed_screen;
+    indexed_screen.set_enabled(true);
+    indexed_screen.begin_frame(true);
+
+    for (int line = 0; line < age::gb_screen_height; ++line)
+    {
+        // change BGP every 16 lines
+        if (!(line & 15))
+        {
+            fixture.m_palettes.write_bgp(static_cast<age::uint8_t>(0xE4 + line));
+        }
+        auto indexes = indexed_screen.begin_line(line);
+        std::fill(begin(indexes), end(indexes), age::gb_palette_bgp * 4 + 1);
+    }
+    indexed_screen.switch_buffers();
+
+    auto indexed = indexed_screen.get_front_buffer();
+    EXPECT_EQ(indexed.m_palettes.size(), 9 * palette_size);
+    EXPECT_EQ(indexed.m_line_palettes[15], 0);
+    EXPECT_EQ(indexed.m_line_palettes[16], 1);
+    EXPECT_EQ(indexed.m_line_palettes[143], 8);
+
+    for (int line = 0; line < age::gb_screen_height; ++line)
+    {
+        fixture.m_palettes.write_bgp(static_cast<age::uint8_t>(0xE4 + (line & ~15)));
+        EXPECT_EQ(color_of(indexed, 0, line), fixture.m_palettes.get_color(age::gb_palette_bgp * 4 + 1));
+    }
+}
+
+TEST(AgeGbLcdIndexedScreen, OffsetsColorIndexesAfterMidLinePaletteChange)
+{
+    gb_lcd_indexed_screen_fixture fixture;
+    auto&                         indexed_screen = fixture.m_indexed_screen;
+    indexed_screen.set_enabled(true);
+    indexed_screen.begin_frame(true);
+
+    auto indexes = indexed_screen.begin_line(10);
+    EXPECT_EQ(indexed_screen.get_color_index_offset(10), 0);
+
+    fixture.m_palettes.write_bgp(0x1B);
+    auto offset = indexed_screen.get_color_index_offset(10);
+    EXPECT_EQ(offset, palette_size);
+    indexes[1] = static_cast<age::uint8_t>(offset + 3);
+    auto color1 = fixture.m_palettes.get_color(3);
+
+    fixture.m_palettes.write_bgp(0x27);
+    offset = indexed_screen.get_color_index_offset(10);
+    EXPECT_EQ(offset, 2 * palette_size);
+    indexes[2] = static_cast<age::uint8_t>(offset + 3);
+
+    // no more palettes for this line
+    fixture.m_palettes.write_bgp(0x4E);
+    EXPECT_EQ(indexed_screen.get_color_index_offset(10), 2 * palette_size);
+    indexes[3] = static_cast<age::uint8_t>(offset + 3);
+    auto color3 = fixture.m_palettes.get_color(3);
+
+    indexed_screen.switch_buffers();
+    auto indexed = indexed_screen.get_front_buffer();
+    EXPECT_EQ(indexed.m_palettes.size(), 3 * palette_size);
+    EXPECT_EQ(color_of(indexed, 1, 10), color1);
+    EXPECT_EQ(color_of(indexed, 2, 10), color3); // palette overwritten
+    EXPECT_EQ(color_of(indexed, 3, 10), color3);
+}
+
+TEST(AgeGbLcdIndexedScreen, IndexesDmgShades)
+{
+    gb_lcd_indexed_screen_fixture fixture;
+    auto&                         indexed_screen = fixture.m_indexed_screen;
+    indexed_screen.set_enabled(true);
+    indexed_screen.begin_frame(true);
+
+    auto indexes = indexed_screen.begin_line(0);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        indexes[i] = static_cast<age::uint8_t>(age::gb_total_color_count + i);
+    }
+    indexed_screen.switch_buffers();
+
+    auto indexed = indexed_screen.get_front_buffer();
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(color_of(indexed, i, 0), fixture.m_palettes.get_dmg_shades()[static_cast<unsigned>(i)]);
+    }
+}
+
+TEST(AgeGbLcdIndexedScreen, IndexesBlankFrame)
+{
+    gb_lcd_indexed_screen_fixture fixture;
+    auto&                         indexed_screen = fixture.m_indexed_screen;
+    indexed_screen.set_enabled(true);
+    indexed_screen.begin_frame(true);
+
+    auto indexes = indexed_screen.begin_line(5);
+    std::fill(begin(indexes), end(indexes), 3);
+    indexed_screen.blank_frame(age::pixel(0x123456));
+    indexed_screen.switch_buffers();
+
+    auto indexed = indexed_screen.get_front_buffer();
+    EXPECT_EQ(indexed.m_palettes.size(), palette_size);
+    EXPECT_EQ(color_of(indexed, 7, 5), age::pixel(0x123456));
+    EXPECT_EQ(color_of(indexed, 159, 143), age::pixel(0x123456));
+}
@@ -0,0 +1,318 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_GB_LCD_LINE_COMPOSITOR_HPP
+#define AGE_GB_LCD_LINE_COMPOSITOR_HPP
+
+//!
+//! \file
+//!
+//! Pixel composition used by gb_lcd_line_renderer.
+//!
+//! Tile rows are expected to be decoded by gb_lcd_tile_cache
+//! (8 color indexes, leftmost pixel in the least significant byte).
+//! The pixel alpha channel holds priority information during
+//! composition, see gb_lcd_line_renderer::render_line().
+//!
+//! Depending on the target architecture, AVX2 or SSE2 instructions are
+//! used with a scalar fallback for all other platforms (e.g. WebAssembly).
+//! Since SSE2 is part of x86-64, AVX2 has to be enabled explicitly
+//! (see the USE_AVX2 CMake option).
+//! All implementations available for the target architecture are compiled
+//! to allow for comparing them (see age_gb_lcd_line_compositor.test.cpp).
+//!
+
+#include <age_types.hpp>
+#include <gfx/age_pixel.hpp>
+
+#include <cassert>
+#include <span>
+
+#if defined(__AVX2__)
+#define AGE_GB_LCD_COMPOSITOR_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define AGE_GB_LCD_COMPOSITOR_SSE2
+#include <emmintrin.h>
+#endif
+
+
+
+namespace age
+{
+
+    namespace scalar
+    {
+        inline void compose_bg_tile(std::span<pixel, 8>       dst,
+                                    uint64_t                  tile_row,
+                                    std::span<const pixel, 4> palette,
+                                    uint8_t                   priority)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                int   color_idx = static_cast<int>(tile_row & 0b11);
+                pixel color     = palette[color_idx];
+                color.m_a       = color_idx + priority;
+                dst[i]          = color;
+
+                tile_row >>= 8;
+            }
+        }
+
+        inline void compose_sprite_tile(std::span<pixel, 8>       dst,
+                                        uint64_t                  tile_row,
+                                        std::span<const pixel, 4> palette,
+                                        uint8_t                   priority,
+                                        uint8_t                   priority_mask)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                pixel px = dst[i];
+
+                // sprite pixel visible?
+                int color_idx = static_cast<int>(tile_row & 0b11);
+
+                int px_priority = (px.m_a | priority) & priority_mask;
+                if ((px_priority <= 0x80) && color_idx)
+                {
+                    pixel color = palette[color_idx];
+                    color.m_a   = px.m_a;
+                    dst[i]      = color;
+                }
+
+                // next pixel
+                tile_row >>= 8;
+            }
+        }
+
+        inline void copy_line(std::span<pixel> dst, std::span<const pixel> src)
+        {
+            auto alpha_bits = pixel{0, 0, 0, 255}.get_32bits();
+            for (std::size_t i = 0; i < src.size(); ++i)
+            {
+                dst[i].set_32bits(src[i].get_32bits() | alpha_bits);
+            }
+        }
+
+    } // namespace scalar
+
+
+
+#if defined(AGE_GB_LCD_COMPOSITOR_SSE2)
+
+    namespace sse2
+    {
+        //! look up 4 colors by the color indexes in the lower byte of each 32 bit lane
+        inline __m128i gather_colors(__m128i color_idx, __m128i palette)
+        {
+            __m128i c0 = _mm_and_si128(_mm_cmpeq_epi32(color_idx, _mm_setzero_si128()), _mm_shuffle_epi32(palette, 0x00));
+            __m128i c1 = _mm_and_si128(_mm_cmpeq_epi32(color_idx, _mm_set1_epi32(1)), _mm_shuffle_epi32(palette, 0x55));
+            __m128i c2 = _mm_and_si128(_mm_cmpeq_epi32(color_idx, _mm_set1_epi32(2)), _mm_shuffle_epi32(palette, 0xAA));
+            __m128i c3 = _mm_and_si128(_mm_cmpeq_epi32(color_idx, _mm_set1_epi32(3)), _mm_shuffle_epi32(palette, 0xFF));
+            return _mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+        }
+
+        //! expand 8 color indexes (one per byte) to two vectors of 32 bit lanes
+        inline void expand_color_indexes(uint64_t tile_row, __m128i& low, __m128i& high)
+        {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&tile_row)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m128i words = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+            low           = _mm_unpacklo_epi16(words, _mm_setzero_si128());
+            high          = _mm_unpackhi_epi16(words, _mm_setzero_si128());
+        }
+
+        inline __m128i compose_bg(__m128i color_idx, __m128i palette, __m128i priority)
+        {
+            __m128i color = _mm_and_si128(gather_colors(color_idx, palette), _mm_set1_epi32(0x00FFFFFF));
+            return _mm_or_si128(color, _mm_slli_epi32(_mm_add_epi32(color_idx, priority), 24));
+        }
+
+        inline __m128i compose_sprite(__m128i dst, __m128i color_idx, __m128i palette, __m128i priority, __m128i priority_mask)
+        {
+            // sprite pixel visible if: color_idx > 0 && ((dst_alpha | priority) & priority_mask) <= 0x80
+            __m128i dst_alpha   = _mm_srli_epi32(dst, 24);
+            __m128i px_priority = _mm_and_si128(_mm_or_si128(dst_alpha, priority), priority_mask);
+            __m128i hidden      = _mm_or_si128(_mm_cmpgt_epi32(px_priority, _mm_set1_epi32(0x80)),
+                                               _mm_cmpeq_epi32(color_idx, _mm_setzero_si128()));
+
+            // keep the alpha channel (priority information)
+            __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+            __m128i color      = _mm_or_si128(_mm_andnot_si128(alpha_mask, gather_colors(color_idx, palette)),
+                                              _mm_and_si128(alpha_mask, dst));
+
+            return _mm_or_si128(_mm_and_si128(hidden, dst), _mm_andnot_si128(hidden, color));
+        }
+
+        inline void compose_bg_tile(std::span<pixel, 8>       dst,
+                                    uint64_t                  tile_row,
+                                    std::span<const pixel, 4> palette,
+                                    uint8_t                   priority)
+        {
+            __m128i pal  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(palette.data())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m128i prio = _mm_set1_epi32(priority);
+            __m128i idx_low;
+            __m128i idx_high;
+            expand_color_indexes(tile_row, idx_low, idx_high);
+
+            auto* dst128 = reinterpret_cast<__m128i*>(dst.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            _mm_storeu_si128(dst128, compose_bg(idx_low, pal, prio));
+            _mm_storeu_si128(dst128 + 1, compose_bg(idx_high, pal, prio));
+        }
+
+        inline void compose_sprite_tile(std::span<pixel, 8>       dst,
+                                        uint64_t                  tile_row,
+                                        std::span<const pixel, 4> palette,
+                                        uint8_t                   priority,
+                                        uint8_t                   priority_mask)
+        {
+            __m128i pal  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(palette.data())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m128i prio = _mm_set1_epi32(priority);
+            __m128i mask = _mm_set1_epi32(priority_mask);
+            __m128i idx_low;
+            __m128i idx_high;
+            expand_color_indexes(tile_row, idx_low, idx_high);
+
+            auto* dst128 = reinterpret_cast<__m128i*>(dst.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            _mm_storeu_si128(dst128, compose_sprite(_mm_loadu_si128(dst128), idx_low, pal, prio, mask));
+            _mm_storeu_si128(dst128 + 1, compose_sprite(_mm_loadu_si128(dst128 + 1), idx_high, pal, prio, mask));
+        }
+
+        inline void copy_line(std::span<pixel> dst, std::span<const pixel> src)
+        {
+            __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+            for (std::size_t i = 0; i < src.size(); i += 4)
+            {
+                __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), _mm_or_si128(px, alpha)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            }
+        }
+
+    } // namespace sse2
+
+#endif
+
+
+
+#if defined(AGE_GB_LCD_COMPOSITOR_AVX2)
+
+    namespace avx2
+    {
+        inline void compose_bg_tile(std::span<pixel, 8>       dst,
+                                    uint64_t                  tile_row,
+                                    std::span<const pixel, 4> palette,
+                                    uint8_t                   priority)
+        {
+            __m128i pal128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(palette.data())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m256i pal    = _mm256_broadcastsi128_si256(pal128);
+            __m256i idx    = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<int64_t>(tile_row)));
+
+            __m256i color = _mm256_and_si256(_mm256_permutevar8x32_epi32(pal, idx), _mm256_set1_epi32(0x00FFFFFF));
+            __m256i alpha = _mm256_slli_epi32(_mm256_add_epi32(idx, _mm256_set1_epi32(priority)), 24);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst.data()), _mm256_or_si256(color, alpha)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        }
+
+        inline void compose_sprite_tile(std::span<pixel, 8>       dst,
+                                        uint64_t                  tile_row,
+                                        std::span<const pixel, 4> palette,
+                                        uint8_t                   priority,
+                                        uint8_t                   priority_mask)
+        {
+            auto*   dst256 = reinterpret_cast<__m256i*>(dst.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m256i px     = _mm256_loadu_si256(dst256);
+
+            __m128i pal128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(palette.data())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m256i pal    = _mm256_broadcastsi128_si256(pal128);
+            __m256i idx    = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<int64_t>(tile_row)));
+
+            // sprite pixel visible if: color_idx > 0 && ((dst_alpha | priority) & priority_mask) <= 0x80
+            __m256i px_priority = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi32(px, 24), _mm256_set1_epi32(priority)),
+                                                   _mm256_set1_epi32(priority_mask));
+            __m256i hidden      = _mm256_or_si256(_mm256_cmpgt_epi32(px_priority, _mm256_set1_epi32(0x80)),
+                                                  _mm256_cmpeq_epi32(idx, _mm256_setzero_si256()));
+
+            // keep the alpha channel (priority information)
+            __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000U));
+            __m256i color      = _mm256_blendv_epi8(_mm256_permutevar8x32_epi32(pal, idx), px, alpha_mask);
+
+            _mm256_storeu_si256(dst256, _mm256_blendv_epi8(color, px, hidden));
+        }
+
+        inline void copy_line(std::span<pixel> dst, std::span<const pixel> src)
+        {
+            __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000U));
+            for (std::size_t i = 0; i < src.size(); i += 8)
+            {
+                __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[i])); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i]), _mm256_or_si256(px, alpha)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            }
+        }
+
+    } // namespace avx2
+
+#endif
+
+
+
+    inline void gb_compose_bg_tile(std::span<pixel, 8>       dst,
+                                   uint64_t                  tile_row,
+                                   std::span<const pixel, 4> palette,
+                                   uint8_t                   priority)
+    {
+#if defined(AGE_GB_LCD_COMPOSITOR_AVX2)
+        avx2::compose_bg_tile(dst, tile_row, palette, priority);
+#elif defined(AGE_GB_LCD_COMPOSITOR_SSE2)
+        sse2::compose_bg_tile(dst, tile_row, palette, priority);
+#else
+        scalar::compose_bg_tile(dst, tile_row, palette, priority);
+#endif
+    }
+
+    inline void gb_compose_sprite_tile(std::span<pixel, 8>       dst,
+                                       uint64_t                  tile_row,
+                                       std::span<const pixel, 4> palette,
+                                       uint8_t                   priority,
+                                       uint8_t                   priority_mask)
+    {
+#if defined(AGE_GB_LCD_COMPOSITOR_AVX2)
+        avx2::compose_sprite_tile(dst, tile_row, palette, priority, priority_mask);
+#elif defined(AGE_GB_LCD_COMPOSITOR_SSE2)
+        sse2::compose_sprite_tile(dst, tile_row, palette, priority, priority_mask);
+#else
+        scalar::compose_sprite_tile(dst, tile_row, palette, priority, priority_mask);
+#endif
+    }
+
+    //! copy pixels replacing the priority information with an opaque alpha value
+    inline void gb_copy_line(std::span<pixel> dst, std::span<const pixel> src)
+    {
+        assert(dst.size() == src.size());
+        assert((src.size() & 0b111) == 0);
+
+#if defined(AGE_GB_LCD_COMPOSITOR_AVX2)
+        avx2::copy_line(dst, src);
+#elif defined(AGE_GB_LCD_COMPOSITOR_SSE2)
+        sse2::copy_line(dst, src);
+#else
+        scalar::copy_line(dst, src);
+#endif
+    }
+
+} // namespace age
+
+
+
+#endif // AGE_GB_LCD_LINE_COMPOSITOR_HPP
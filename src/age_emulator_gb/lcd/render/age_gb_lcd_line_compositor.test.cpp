@@ -0,0 +1,202 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "../common/age_gb_lcd_common.hpp"
+#include "age_gb_lcd_line_compositor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+
+namespace
+{
+    constexpr int iterations = 10000;
+
+    //! one color index (0-3) per byte, leftmost pixel in the least significant byte
+    uint64_t random_tile_row(std::mt19937& random)
+    {
+        uint64_t tile_row = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            tile_row |= static_cast<uint64_t>(random() & 0b11) << (i * 8);
+        }
+        return tile_row;
+    }
+
+    age::pixel random_pixel(std::mt19937& random)
+    {
+        return age::pixel(static_cast<int>(random() & 0xFF),
+                          static_cast<int>(random() & 0xFF),
+                          static_cast<int>(random() & 0xFF),
+                          static_cast<int>(random() & 0xFF));
+    }
+
+    std::array<age::pixel, 4> random_palette(std::mt19937& random)
+    {
+        return {random_pixel(random), random_pixel(random), random_pixel(random), random_pixel(random)};
+    }
+
+    std::array<age::pixel, 8> random_line(std::mt19937& random)
+    {
+        std::array<age::pixel, 8> line{};
+        for (auto& px : line)
+        {
+            px = random_pixel(random);
+        }
+        return line;
+    }
+
+    uint8_t random_priority(std::mt19937& random)
+    {
+        return (random() & 1) ? 0x80 : 0x00;
+    }
+
+    uint8_t random_priority_mask(std::mt19937& random)
+    {
+        return (random() & 1) ? 0xFF : 0x00;
+    }
+
+
+
+    template<typename ComposeBgTile>
+    void expect_bg_tile_equal_to_scalar(ComposeBgTile compose_bg_tile)
+    {
+        std::mt19937 random(0x1234);
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto tile_row = random_tile_row(random);
+            auto palette  = random_palette(random);
+            auto priority = random_priority(random);
+            auto initial  = random_line(random);
+
+            auto expected = initial;
+            auto actual   = initial;
+            age::scalar::compose_bg_tile(expected, tile_row, palette, priority);
+            compose_bg_tile(actual, tile_row, palette, priority);
+            ASSERT_EQ(actual, expected) << "tile row 0x" << std::hex << tile_row;
+        }
+    }
+
+    template<typename ComposeSpriteTile>
+    void expect_sprite_tile_equal_to_scalar(ComposeSpriteTile compose_sprite_tile)
+    {
+        std::mt19937 random(0x5678);
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto tile_row      = random_tile_row(random);
+            auto palette       = random_palette(random);
+            auto priority      = random_priority(random);
+            auto priority_mask = random_priority_mask(random);
+            // the alpha channel contains the bg priority information
+            auto initial = random_line(random);
+
+            auto expected = initial;
+            auto actual   = initial;
+            age::scalar::compose_sprite_tile(expected, tile_row, palette, priority, priority_mask);
+            compose_sprite_tile(actual, tile_row, palette, priority, priority_mask);
+            ASSERT_EQ(actual, expected) << "tile row 0x" << std::hex << tile_row;
+        }
+    }
+
+    template<typename CopyLine>
+    void expect_copy_line_equal_to_scalar(CopyLine copy_line)
+    {
+        std::mt19937 random(0x9ABC);
+
+        age::pixel_vector src(age::gb_screen_width);
+        for (auto& px : src)
+        {
+            px = random_pixel(random);
+        }
+
+        age::pixel_vector expected(src.size());
+        age::pixel_vector actual(src.size());
+        age::scalar::copy_line(expected, src);
+        copy_line(actual, src);
+        EXPECT_EQ(actual, expected);
+    }
+
+} // namespace
+
+
+
+TEST(AgeGbLcdLineCompositor, ScalarComposesBgTile)
+{
+    std::array<age::pixel, 4> palette{age::pixel(0x101010), age::pixel(0x202020), age::pixel(0x303030), age::pixel(0x404040)};
+    std::array<age::pixel, 8> line{};
+
+    age::scalar::compose_bg_tile(line, 0x0003020100030201ULL, palette, 0x80);
+
+    EXPECT_EQ(line[0], age::pixel(0x20, 0x20, 0x20, 0x81));
+    EXPECT_EQ(line[1], age::pixel(0x30, 0x30, 0x30, 0x82));
+    EXPECT_EQ(line[2], age::pixel(0x40, 0x40, 0x40, 0x83));
+    EXPECT_EQ(line[3], age::pixel(0x10, 0x10, 0x10, 0x80));
+}
+
+TEST(AgeGbLcdLineCompositor, ScalarComposesSpriteTile)
+{
+    std::array<age::pixel, 4> palette{age::pixel(0x101010), age::pixel(0x202020), age::pixel(0x303030), age::pixel(0x404040)};
+    std::array<age::pixel, 8> line{};
+    line.fill(age::pixel(0, 0, 0, 0x81)); // bg priority set
+
+    // bg priority ignored (e.g. CGB with LCDC bit 0 cleared)
+    age::scalar::compose_sprite_tile(line, 0x0000000000000100ULL, palette, 0x00, 0x00);
+    EXPECT_EQ(line[0], age::pixel(0, 0, 0, 0x81)); // transparent sprite pixel
+    EXPECT_EQ(line[1], age::pixel(0x20, 0x20, 0x20, 0x81));
+
+    // bg priority respected
+    age::scalar::compose_sprite_tile(line, 0x0000000000000001ULL, palette, 0x00, 0xFF);
+    EXPECT_EQ(line[0], age::pixel(0, 0, 0, 0x81));
+}
+
+#if defined(AGE_GB_LCD_COMPOSITOR_SSE2)
+
+TEST(AgeGbLcdLineCompositor, Sse2ComposesBgTileLikeScalar)
+{
+    expect_bg_tile_equal_to_scalar(age::sse2::compose_bg_tile);
+}
+
+TEST(AgeGbLcdLineCompositor, Sse2ComposesSpriteTileLikeScalar)
+{
+    expect_sprite_tile_equal_to_scalar(age::sse2::compose_sprite_tile);
+}
+
+TEST(AgeGbLcdLineCompositor, Sse2CopiesLineLikeScalar)
+{
+    expect_copy_line_equal_to_scalar(age::sse2::copy_line);
+}
+
+#endif
+
+#if defined(AGE_GB_LCD_COMPOSITOR_AVX2)
+
+TEST(AgeGbLcdLineCompositor, Avx2ComposesBgTileLikeScalar)
+{
+    expect_bg_tile_equal_to_scalar(age::avx2::compose_bg_tile);
+}
+
+TEST(AgeGbLcdLineCompositor, Avx2ComposesSpriteTileLikeScalar)
+{
+    expect_sprite_tile_equal_to_scalar(age::avx2::compose_sprite_tile);
+}
+
+TEST(AgeGbLcdLineCompositor, Avx2CopiesLineLikeScalar)
+{
+    expect_copy_line_equal_to_scalar(age::avx2::copy_line);
+}
+
+#endif
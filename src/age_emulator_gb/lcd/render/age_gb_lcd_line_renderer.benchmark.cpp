@@ -0,0 +1,147 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "../../common/age_gb_device.hpp"
+#include "../palettes/age_gb_lcd_palettes.hpp"
+#include "age_gb_lcd_indexed_screen.hpp"
+#include "age_gb_lcd_line_renderer.hpp"
+#include "age_gb_lcd_renderer_common.hpp"
+#include "age_gb_lcd_sprites.hpp"
+#include "age_gb_lcd_tile_cache.hpp"
+#include "age_gb_lcd_window_check.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+
+
+namespace
+{
+    //!
+    //! A line renderer rendering random video ram and OAM
+    //! (the arguments' first value selects DMG (0) or CGB (1)).
+    //!
+    class line_renderer_setup
+    {
+    public:
+        explicit line_renderer_setup(bool cgb)
+            : m_rom(create_rom(cgb)),
+              m_device(m_rom, cgb ? age::gb_device_type::cgb_e : age::gb_device_type::dmg),
+              m_palettes(m_device, std::span(m_rom).first(0x150), age::gb_colors_hint::default_colors),
+              m_sprites(m_device.cgb_mode()),
+              m_common(m_device, m_sprites),
+              m_video_ram(0x4000, 0),
+              m_tile_cache(m_video_ram),
+              m_window(m_device.is_dmg_device()),
+              m_indexed_screen(m_palettes),
+              m_screen_buffer(age::gb_screen_width, age::gb_screen_height),
+              m_line_renderer(m_device, m_common, m_palettes, m_sprites, m_video_ram, m_tile_cache, m_window, m_indexed_screen, m_screen_buffer)
+        {
+            std::mt19937 random(0x4711);
+            for (auto& byte : m_video_ram)
+            {
+                byte = static_cast<age::uint8_t>(random());
+            }
+            // roughly every fourth OAM byte is a visible y-coordinate
+            for (int i = 0; i < 160; ++i)
+            {
+                m_sprites.write_oam(i, static_cast<age::uint8_t>((i % 4) ? random() : (random() % 160 + 16)));
+            }
+            m_common.set_lcdc(0x93); // BG, sprites, tile data at 0x8000
+        }
+
+        void render_frame()
+        {
+            for (int line = 0; line < age::gb_screen_height; ++line)
+            {
+                m_line_renderer.render_line(line);
+            }
+            m_screen_buffer.switch_buffers();
+            m_common.m_scx = static_cast<age::uint8_t>(m_common.m_scx + 1);
+        }
+
+        void invalidate_tile_cache()
+        {
+            m_tile_cache.reset(m_video_ram);
+        }
+
+        [[nodiscard]] const age::pixel_vector& front_buffer() const
+        {
+            return m_screen_buffer.get_front_buffer();
+        }
+
+    private:
+        static age::uint8_vector create_rom(bool cgb)
+        {
+            age::uint8_vector rom(0x8000, 0);
+            rom[0x143] = cgb ? 0x80 : 0x00;
+            return rom;
+        }
+
+        age::uint8_vector           m_rom;
+        age::gb_device              m_device;
+        age::gb_lcd_palettes        m_palettes;
+        age::gb_lcd_sprites         m_sprites;
+        age::gb_lcd_renderer_common m_common;
+        age::uint8_vector           m_video_ram;
+        age::gb_lcd_tile_cache      m_tile_cache;
+        age::gb_window_check        m_window;
+        age::gb_lcd_indexed_screen  m_indexed_screen;
+        age::screen_buffer          m_screen_buffer;
+        age::gb_lcd_line_renderer   m_line_renderer;
+    };
+
+} // namespace
+
+
+
+//!
+//! Render frames with all tile rows already decoded,
+//! as it is the case for frames without video ram writes.
+//!
+void BM_LineRendererFrame(benchmark::State& state)
+{
+    line_renderer_setup setup(state.range(0) != 0);
+    setup.render_frame();
+
+    for (auto _ : state)
+    {
+        setup.render_frame();
+        benchmark::DoNotOptimize(setup.front_buffer().data());
+    }
+    state.SetItemsProcessed(state.iterations() * age::gb_screen_height);
+}
+BENCHMARK(BM_LineRendererFrame)->ArgName("cgb")->Arg(0)->Arg(1);
+
+//!
+//! Render frames after the whole video ram has been written,
+//! i.e. every tile row is decoded on first access
+//! (the worst case for the tile cache).
+//!
+void BM_LineRendererFrameColdTileCache(benchmark::State& state)
+{
+    line_renderer_setup setup(state.range(0) != 0);
+
+    for (auto _ : state)
+    {
+        setup.invalidate_tile_cache();
+        setup.render_frame();
+        benchmark::DoNotOptimize(setup.front_buffer().data());
+    }
+    state.SetItemsProcessed(state.iterations() * age::gb_screen_height);
+}
+BENCHMARK(BM_LineRendererFrameColdTileCache)->ArgName("cgb")->Arg(0)->Arg(1);
@@ -15,9 +15,11 @@
 //
 
 #include "age_gb_lcd_line_renderer.hpp"
+#include "age_gb_lcd_line_compositor.hpp"
 
-#include <algorithm> // std::fill
+#include <algorithm> // std::copy_n, std::fill, std::transform
 #include <cassert>
+#include <cstring>   // memcpy
 
 
 
@@ -26,22 +28,38 @@ age::gb_lcd_line_renderer::gb_lcd_line_renderer(const gb_device&              de
                                                 const gb_lcd_palettes&        palettes,
                                                 const gb_lcd_sprites&         sprites,
                                                 std::span<uint8_t const>      video_ram,
+                                                gb_lcd_tile_cache&            tile_cache,
                                                 gb_window_check&              window,
+                                                gb_lcd_indexed_screen&        indexed_screen,
                                                 screen_buffer&                screen_buffer)
     : m_device(device),
       m_common(common),
       m_palettes(palettes),
       m_sprites(sprites),
       m_video_ram(video_ram),
+      m_tile_cache(tile_cache),
       m_window(window),
+      m_indexed_screen(indexed_screen),
       m_screen_buffer(screen_buffer)
 {
 }
 
+void age::gb_lcd_line_renderer::set_video_ram(std::span<uint8_t const> video_ram)
+{
+    m_video_ram = video_ram;
+}
+
 
 
 void age::gb_lcd_line_renderer::render_line(int line)
 {
+    render_line_segment(line, 0, gb_screen_width, false);
+}
+
+void age::gb_lcd_line_renderer::render_line_segment(int line, int from_x, int to_x, bool bgp_glitch)
+{
+    assert((from_x >= 0) && (from_x < to_x) && (to_x <= gb_screen_width));
+
     // We use the pixel alpha channel temporary for priority
     // information.
     // When the line is finished, during copying to the
@@ -53,6 +71,16 @@ void age::gb_lcd_line_renderer::render_line(int line)
     //  7       BG priority flag (OAM | CGB tile attribute)
     //
     //  => render sprite pixel only for priority <= 0x80
+    //
+    // Color indexes (see gb_indexed_screen) are written to
+    // m_line_indexes alongside.
+    // If the frame is indexed, only the color indexes are copied to the
+    // indexed screen, the screen buffer is not written.
+    // The palette may have changed since the line's first segment,
+    // which requires an offset for the segment's color indexes.
+
+    auto line_indexes = from_x ? m_indexed_screen.continue_line(line) : m_indexed_screen.begin_line(line);
+    m_index_line      = !line_indexes.empty();
 
     // first visible pixel
     int px0 = 8 + (m_common.m_scx & 0b111);
@@ -63,6 +91,10 @@ void age::gb_lcd_line_renderer::render_line(int line)
         pixel fill_color = m_palettes.get_palette(gb_palette_bgp)[0];
         fill_color.m_a   = 0; // sprites are prioritized
         std::fill(begin(m_line), end(m_line), fill_color);
+        if (m_index_line)
+        {
+            std::fill(begin(m_line_indexes), end(m_line_indexes), gb_palette_bgp << 2);
+        }
     }
 
     // render BG & window
@@ -84,9 +116,7 @@ void age::gb_lcd_line_renderer::render_line(int line)
 
         for (int tx = m_common.m_scx >> 3, max = tx + tiles; tx < max; ++tx)
         {
-            render_bg_tile(std::span<pixel, 8>{m_line.begin() + line_px_ofs, 8},
-                           tile_line,
-                           tile_vram_ofs + (tx & 0b11111));
+            render_bg_tile(line_px_ofs, tile_line, tile_vram_ofs + (tx & 0b11111));
             line_px_ofs += 8;
         }
 
@@ -100,9 +130,7 @@ void age::gb_lcd_line_renderer::render_line(int line)
 
             for (int tx = 0, max = ((gb_screen_width + 7 - m_common.m_wx) >> 3) + 1; tx < max; ++tx)
             {
-                render_bg_tile(std::span<pixel, 8>{m_line.begin() + line_px_ofs, 8},
-                               tile_line,
-                               tile_vram_ofs + tx);
+                render_bg_tile(line_px_ofs, tile_line, tile_vram_ofs + tx);
                 line_px_ofs += 8;
             }
         }
@@ -111,38 +139,80 @@ void age::gb_lcd_line_renderer::render_line(int line)
     // render sprites
     if (m_common.get_lcdc() & gb_lcdc_obj_enable)
     {
-        auto sprites = m_sprites.get_line_sprites(line, !m_device.cgb_mode());
+        gb_line_sprites buffer;
+        auto            sprites = m_sprites.get_line_sprites(line, !m_device.cgb_mode(), buffer);
         std::for_each(rbegin(sprites),
                       rend(sprites),
                       [this, &px0, &line](const gb_sprite& sprite) {
                           if (sprite.m_x && (sprite.m_x < gb_screen_width + 8))
                           {
                               assert((px0 + sprite.m_x) < gb_screen_width + 24);
-                              render_sprite_tile(
-                                  std::span<pixel, 8>{m_line.begin() + px0 + sprite.m_x - 8, 8},
-                                  line - (sprite.m_y - 16),
-                                  sprite);
+                              render_sprite_tile(px0 + sprite.m_x - 8, line - (sprite.m_y - 16), sprite);
                           }
                       });
     }
 
-    // copy line
-    auto             dst = m_screen_buffer.get_back_buffer_line(line);
-    std::span<pixel> src{m_line.begin() + px0, gb_screen_width};
+    // the BGP glitch affects only DMG background pixels
+    // (color index in the priority bits)
+    auto     glitch_px    = static_cast<unsigned>(px0 + from_x);
+    unsigned glitch_color = m_line[glitch_px].m_a & 0b11U;
+    assert(!bgp_glitch || (m_device.is_dmg_device() && from_x));
 
-    auto alpha_bits = pixel{0, 0, 0, 255}.get_32bits();
-    for (int i = 0; i < gb_screen_width; ++i)
+    // copy line segment
+    auto segment_px = static_cast<unsigned>(to_x - from_x);
+    if (m_index_line)
     {
-        // replace priority information with alpha value
-        dst[i].set_32bits(src[i].get_32bits() | alpha_bits);
+        auto src = m_line_indexes.begin() + px0 + from_x;
+        auto dst = line_indexes.begin() + from_x;
+        if (!from_x)
+        {
+            std::copy_n(src, segment_px, dst);
+            return;
+        }
+        uint8_t offset = m_indexed_screen.get_color_index_offset(line);
+        std::transform(src, src + segment_px, dst, [offset](uint8_t index) {
+            return static_cast<uint8_t>(index + offset);
+        });
+        if (bgp_glitch)
+        {
+            *dst = static_cast<uint8_t>(gb_total_color_count + m_palettes.get_dmg_shade_bgp_glitch(glitch_color) + offset);
+        }
+        return;
+    }
+    auto             dst = m_screen_buffer.get_back_buffer_line(line).subspan(static_cast<unsigned>(from_x), segment_px);
+    std::span<pixel> src{m_line.begin() + px0 + from_x, segment_px};
+
+    // replace priority information with alpha value
+    // (gb_copy_line() copies multiples of 8 pixels)
+    auto aligned_px = segment_px & ~0b111U;
+    gb_copy_line(dst.first(aligned_px), src.first(aligned_px));
+    scalar::copy_line(dst.subspan(aligned_px), src.subspan(aligned_px));
+    if (bgp_glitch)
+    {
+        dst[0] = m_palettes.get_color_bgp_glitch(glitch_color);
     }
 }
 
+void age::gb_lcd_line_renderer::skip_line(int line)
+{
+    // keep this in sync with render_line()
+    if (!m_device.cgb_mode() && !(m_common.get_lcdc() & gb_lcdc_bg_enable))
+    {
+        return;
+    }
+    m_window.check_for_wy_match(m_common.get_lcdc(), m_common.m_wy, line);
+    bool winx_visible = ((m_common.get_lcdc() & gb_lcdc_win_enable) != 0) && (m_common.m_wx < 167);
+    if (m_window.is_enabled_and_wy_matched(m_common.get_lcdc()) && winx_visible)
+    {
+        m_window.next_window_line();
+    }
+}
 
 
-void age::gb_lcd_line_renderer::render_bg_tile(std::span<pixel, 8> dst,
-                                               int                 tile_line,
-                                               int                 tile_vram_ofs)
+
+void age::gb_lcd_line_renderer::render_bg_tile(int px_ofs,
+                                               int tile_line,
+                                               int tile_vram_ofs)
 {
     assert((tile_vram_ofs >= 0x1800) && (tile_vram_ofs < 0x2000));
     assert((tile_line >= 0) && (tile_line < 8));
@@ -164,45 +234,32 @@ void age::gb_lcd_line_renderer::render_bg_tile(std::span<pixel, 8> dst,
     tile_data_ofs += (attributes & gb_tile_attrib_vram_bank) << 10;
     tile_data_ofs += tile_line << 1; // 2 bytes per line
 
-    int tile_byte1 = m_video_ram[tile_data_ofs];
-    int tile_byte2 = m_video_ram[tile_data_ofs + 1];
-
-    // x-flip
-    // (we invert the x-flip for easier rendering:
-    // this way bit 0 is used for the leftmost pixel)
-    if (!(attributes & gb_tile_attrib_flip_x))
-    {
-        tile_byte1 = m_common.m_xflip_cache[tile_byte1];
-        tile_byte2 = m_common.m_xflip_cache[tile_byte2];
-    }
+    // decoded tile line (leftmost pixel in the least significant byte)
+    uint64_t tile_row = m_tile_cache.get_row(tile_data_ofs, (attributes & gb_tile_attrib_flip_x) != 0);
 
     // bg palette
-    auto palette = m_palettes.get_palette(attributes & gb_tile_attrib_cgb_palette);
+    unsigned palette_idx = attributes & gb_tile_attrib_cgb_palette;
+    auto     palette     = m_palettes.get_palette(palette_idx);
 
     // bg priority
     uint8_t priority = attributes & gb_tile_attrib_priority;
 
     // render tile line
-    // (least significant bit in byte1)
-    tile_byte2 <<= 1;
+    gb_compose_bg_tile(std::span<pixel, 8>{m_line.begin() + px_ofs, 8}, tile_row, palette, priority);
 
-    for (int i = 0; i < 8; ++i)
+    // color indexes: palette * 4 + color (one byte per pixel, no carry)
+    if (m_index_line)
     {
-        int   color_idx = (tile_byte1 & 0b01) + (tile_byte2 & 0b10);
-        pixel color     = palette[color_idx];
-        color.m_a       = color_idx + priority;
-        dst[i]          = color;
-
-        tile_byte1 >>= 1;
-        tile_byte2 >>= 1;
+        uint64_t indexes = tile_row + (palette_idx << 2) * 0x0101010101010101ULL;
+        memcpy(&m_line_indexes[static_cast<unsigned>(px_ofs)], &indexes, sizeof(indexes));
     }
 }
 
 
 
-void age::gb_lcd_line_renderer::render_sprite_tile(std::span<pixel, 8> dst,
-                                                   int                 tile_line,
-                                                   const gb_sprite&    sprite)
+void age::gb_lcd_line_renderer::render_sprite_tile(int              px_ofs,
+                                                   int              tile_line,
+                                                   const gb_sprite& sprite)
 {
     assert((tile_line >= 0) && (tile_line < 16));
 
@@ -219,17 +276,8 @@ void age::gb_lcd_line_renderer::render_sprite_tile(std::span<pixel, 8> dst,
     tile_data_ofs += (oam_attr & gb_tile_attrib_vram_bank) << 10;
     tile_data_ofs += tile_line << 1; // 2 bytes per line
 
-    int tile_byte1 = m_video_ram[tile_data_ofs];
-    int tile_byte2 = m_video_ram[tile_data_ofs + 1];
-
-    // x-flip
-    // (we invert the x-flip for easier rendering:
-    // this way bit 0 is used for the leftmost pixel)
-    if (!(oam_attr & gb_tile_attrib_flip_x))
-    {
-        tile_byte1 = m_common.m_xflip_cache[tile_byte1];
-        tile_byte2 = m_common.m_xflip_cache[tile_byte2];
-    }
+    // decoded tile line (leftmost pixel in the least significant byte)
+    uint64_t tile_row = m_tile_cache.get_row(tile_data_ofs, (oam_attr & gb_tile_attrib_flip_x) != 0);
 
     // palette
     auto palette = m_palettes.get_palette(sprite.m_palette_idx);
@@ -237,27 +285,22 @@ void age::gb_lcd_line_renderer::render_sprite_tile(std::span<pixel, 8> dst,
     // bg priority
     uint8_t priority = oam_attr & gb_tile_attrib_priority;
 
-    // render tile sprite
-    // (the least significant bit in byte1)
-    tile_byte2 <<= 1;
-
-    for (int i = 0; i < 8; ++i)
+    // color indexes of visible sprite pixels
+    // (same check as gb_compose_sprite_tile(), the alpha channel is not modified by it)
+    std::span<pixel, 8> dst{m_line.begin() + px_ofs, 8};
+    if (m_index_line)
     {
-        pixel px = dst[i];
-
-        // sprite pixel visible?
-        int color_idx = (tile_byte1 & 0b01) + (tile_byte2 & 0b10);
-
-        int px_priority = (px.m_a | priority) & m_common.m_priority_mask;
-        if ((px_priority <= 0x80) && color_idx)
+        uint64_t row = tile_row;
+        for (unsigned i = 0; i < 8; ++i, row >>= 8)
         {
-            pixel color = palette[color_idx];
-            color.m_a   = px.m_a;
-            dst[i]      = color;
+            unsigned color_idx = row & 0b11;
+            if (color_idx && (((dst[i].m_a | priority) & m_common.m_priority_mask) <= 0x80))
+            {
+                m_line_indexes[static_cast<unsigned>(px_ofs) + i] = static_cast<uint8_t>((sprite.m_palette_idx << 2) + color_idx);
+            }
         }
-
-        // next pixel
-        tile_byte1 >>= 1;
-        tile_byte2 >>= 1;
     }
+
+    // render tile sprite
+    gb_compose_sprite_tile(dst, tile_row, palette, priority, m_common.m_priority_mask);
 }
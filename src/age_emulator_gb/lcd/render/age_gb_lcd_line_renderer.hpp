@@ -23,8 +23,10 @@
 
 #include "../../common/age_gb_device.hpp"
 #include "../palettes/age_gb_lcd_palettes.hpp"
+#include "age_gb_lcd_indexed_screen.hpp"
 #include "age_gb_lcd_renderer_common.hpp"
 #include "age_gb_lcd_sprites.hpp"
+#include "age_gb_lcd_tile_cache.hpp"
 #include "age_gb_lcd_window_check.hpp"
 
 #include <age_types.hpp>
@@ -49,27 +51,53 @@ namespace age
                              const gb_lcd_palettes&        palettes,
                              const gb_lcd_sprites&         sprites,
                              std::span<uint8_t const>      video_ram,
+                             gb_lcd_tile_cache&            tile_cache,
                              gb_window_check&              window,
+                             gb_lcd_indexed_screen&        indexed_screen,
                              screen_buffer&                screen_buffer);
 
         ~gb_lcd_line_renderer() = default;
 
+        void set_video_ram(std::span<uint8_t const> video_ram);
+
         void render_line(int line);
 
+        //!
+        //! \brief Render the pixels [from_x, to_x) of the specified line
+        //! using the current palettes.
+        //!
+        //! This allows for palette changes during mode 3, if the line is
+        //! rendered in segments from left to right.
+        //! If bgp_glitch is set, the segment's first pixel is rendered with
+        //! the colors of the DMG BGP glitch
+        //! (see gb_lcd_palettes::get_color_bgp_glitch()).
+        //!
+        void render_line_segment(int line, int from_x, int to_x, bool bgp_glitch);
+
+        //!
+        //! Update the window state like render_line() would,
+        //! but don't render any pixels.
+        //!
+        void skip_line(int line);
+
     private:
-        void render_bg_tile(std::span<pixel, 8> dst, int tile_line, int tile_vram_ofs);
-        void render_sprite_tile(std::span<pixel, 8> dst, int tile_line, const gb_sprite& sprite);
+        void render_bg_tile(int px_ofs, int tile_line, int tile_vram_ofs);
+        void render_sprite_tile(int px_ofs, int tile_line, const gb_sprite& sprite);
 
         const gb_device&              m_device;
         const gb_lcd_renderer_common& m_common;
         const gb_lcd_palettes&        m_palettes;
         const gb_lcd_sprites&         m_sprites;
         std::span<uint8_t const>      m_video_ram;
+        gb_lcd_tile_cache&            m_tile_cache;
         gb_window_check&              m_window;
+        gb_lcd_indexed_screen&        m_indexed_screen;
         screen_buffer&                m_screen_buffer;
 
         // 160px + 3 tiles (8px + scx + last window/sprite tile)
         pixel_vector m_line{gb_screen_width + 24, pixel(0, 0, 0)};
+        uint8_vector m_line_indexes = uint8_vector(gb_screen_width + 24, 0);
+        bool         m_index_line   = false; //!< write m_line_indexes for the current line
     };
 
 } // namespace age
@@ -16,7 +16,7 @@
 
 #include "age_gb_lcd_renderer.hpp"
 
-#include <algorithm> // std::fill
+#include <algorithm> // std::min
 #include <cassert>
 
 
@@ -27,19 +27,64 @@ age::gb_lcd_renderer::gb_lcd_renderer(const gb_device&         device,
                                       std::span<uint8_t const> video_ram,
                                       screen_buffer&           screen_buffer)
     : gb_lcd_renderer_common(device, sprites),
+      m_indexed_screen(palettes),
+      m_tile_cache(video_ram),
       m_window(device.is_dmg_device()),
-      m_fifo_renderer(device, *this, palettes, sprites, video_ram, m_window, screen_buffer),
-      m_line_renderer(device, *this, palettes, sprites, video_ram, m_window, screen_buffer),
+      m_fifo_renderer(device, *this, palettes, sprites, video_ram, m_window, m_indexed_screen, screen_buffer),
+      m_line_renderer(device, *this, palettes, sprites, video_ram, m_tile_cache, m_window, m_indexed_screen, screen_buffer),
       m_screen_buffer(screen_buffer),
-      m_palettes(palettes)
+      m_palettes(palettes),
+      m_sprites(sprites)
 {
 }
 
+void age::gb_lcd_renderer::reset(std::span<uint8_t const> video_ram)
+{
+    gb_lcd_renderer_common::reset();
+    m_indexed_screen.reset();
+    m_tile_cache.reset(video_ram);
+    m_window.reset(m_device.is_dmg_device());
+    m_fifo_renderer.set_video_ram(video_ram);
+    m_fifo_renderer.reset();
+    m_line_renderer.set_video_ram(video_ram);
+
+    m_rendered_lines    = 0;
+    m_segments_until    = gb_no_line;
+    m_segments_px       = 0;
+    m_bgp_glitch        = false;
+    m_rendering_enabled = true;
+    m_skip_frame        = false;
+    m_frame_stats       = {};
+    m_last_frame_stats  = {};
+}
+
+
+
+void age::gb_lcd_renderer::set_indexed_screen_enabled(bool enabled)
+{
+    m_indexed_screen.set_enabled(enabled);
+}
+
+void age::gb_lcd_renderer::set_rendering_enabled(bool enabled)
+{
+    // takes effect with the next frame
+    m_rendering_enabled = enabled;
+}
+
+age::gb_indexed_screen age::gb_lcd_renderer::get_indexed_screen() const
+{
+    return m_indexed_screen.get_front_buffer();
+}
 
+age::gb_render_stats age::gb_lcd_renderer::get_render_stats() const
+{
+    return m_last_frame_stats;
+}
 
 bool age::gb_lcd_renderer::stat_mode0() const
 {
-    return m_fifo_renderer.stat_mode0();
+    // line segments are rendered only during mode 3
+    return m_fifo_renderer.stat_mode0() && (m_segments_until.m_line < 0);
 }
 
 void age::gb_lcd_renderer::set_clks_tile_data_change(gb_current_line at_line)
@@ -47,9 +92,24 @@ void age::gb_lcd_renderer::set_clks_tile_data_change(gb_current_line at_line)
     m_fifo_renderer.set_clks_tile_data_change(at_line);
 }
 
+void age::gb_lcd_renderer::after_video_ram_write(int vram_offset)
+{
+    m_tile_cache.invalidate(vram_offset);
+}
+
 void age::gb_lcd_renderer::set_clks_bgp_change(gb_current_line at_line)
 {
     m_fifo_renderer.set_clks_bgp_change(at_line);
+
+    // The BGP glitch affects the pixel plotted on the line cycle before the
+    // BGP change, i.e. the first pixel not yet plotted
+    // (BGP writes render up to that line cycle),
+    // but not the line's first pixel.
+    if (m_segments_until.m_line >= 0)
+    {
+        assert(m_segments_until.m_line == at_line.m_line);
+        m_bgp_glitch = m_segments_px > 0;
+    }
 }
 
 void age::gb_lcd_renderer::check_for_wy_match(gb_current_line at_line, uint8_t wy)
@@ -59,23 +119,104 @@ void age::gb_lcd_renderer::check_for_wy_match(gb_current_line at_line, uint8_t w
 
 void age::gb_lcd_renderer::new_frame(bool frame_is_blank)
 {
+    // Blank frames (e.g. the LCD being switched off) are shown even if
+    // rendering is disabled.
+    // Otherwise keep the last rendered frame, if this frame was not rendered.
     if (frame_is_blank)
     {
-        auto  blank       = m_device.is_dmg_device() ? m_palettes.get_color_zero_dmg() : pixel(0xFFFFFF);
-        auto& back_buffer = m_screen_buffer.get_back_buffer();
-        std::fill(begin(back_buffer), end(back_buffer), blank);
+        auto blank = m_device.is_dmg_device() ? m_palettes.get_color_zero_dmg() : pixel(0xFFFFFF);
+        m_indexed_screen.blank_frame(blank);
+        if (!m_indexed_screen.is_indexing())
+        {
+            m_screen_buffer.fill_back_buffer(blank);
+        }
+    }
+    // Indexed frames replace RGBA frames,
+    // the screen buffer keeps the last RGBA frame.
+    m_indexed_screen.switch_buffers();
+    if ((m_skip_frame && !frame_is_blank) || m_indexed_screen.is_indexing())
+    {
+        m_screen_buffer.repeat_front_buffer(1);
     }
-    m_screen_buffer.switch_buffers();
+    else
+    {
+        m_screen_buffer.switch_buffers();
+    }
+    m_skip_frame = !m_rendering_enabled;
+    m_indexed_screen.begin_frame(!m_skip_frame);
 
     m_window.new_frame();
-    m_rendered_lines = 0;
+    m_rendered_lines   = 0;
+    m_segments_until   = gb_no_line;
+    m_segments_px      = 0;
+    m_bgp_glitch       = false;
+    m_last_frame_stats = m_frame_stats;
+    m_frame_stats      = {};
     m_fifo_renderer.reset();
     assert(!m_fifo_renderer.in_progress());
 }
 
+void age::gb_lcd_renderer::repeat_frame(int frame_count)
+{
+    assert(m_rendered_lines == 0);
+    assert(!m_fifo_renderer.in_progress());
+    assert(m_segments_until.m_line < 0);
+    m_screen_buffer.repeat_front_buffer(frame_count);
+    m_last_frame_stats = {};
+}
+
 
 
 void age::gb_lcd_renderer::render(gb_current_line until, bool is_first_frame)
+{
+    render_lines(until, is_first_frame);
+    if (!m_skip_frame && !m_indexed_screen.is_indexing())
+    {
+        m_screen_buffer.hash_back_buffer_lines(m_rendered_lines);
+    }
+}
+
+bool age::gb_lcd_renderer::render_previous_lines(gb_current_line at_line, bool is_first_frame)
+{
+    // We can skip the current line only if none of its pixels has been
+    // plotted yet (mode 2) and if the line renderer will produce the same
+    // result later on.
+#ifdef AGE_FORCE_FIFO_RENDERER
+    constexpr bool use_line_renderer = false;
+#else
+    constexpr bool use_line_renderer = true;
+#endif
+    if (!use_line_renderer
+        || (at_line.m_line >= gb_screen_height)
+        || (at_line.m_line_clks >= 80)
+        || m_fifo_renderer.in_progress()
+        || !is_simple_line(at_line.m_line, is_first_frame))
+    {
+        return false;
+    }
+    if (at_line.m_line > 0)
+    {
+        render({.m_line = at_line.m_line - 1, .m_line_clks = gb_clock_cycles_per_lcd_line - 1}, is_first_frame);
+    }
+    return true;
+}
+
+void age::gb_lcd_renderer::switch_to_fifo_renderer()
+{
+    if (m_segments_until.m_line < 0)
+    {
+        return;
+    }
+    // A pending BGP glitch can be ignored:
+    // the glitched pixel has already been plotted by the time of any
+    // later write.
+    m_fifo_renderer.take_over_line(m_segments_until, m_segments_px);
+    m_segments_until = gb_no_line;
+    m_segments_px    = 0;
+    m_bgp_glitch     = false;
+}
+
+void age::gb_lcd_renderer::render_lines(gb_current_line until, bool is_first_frame)
 {
     // finish fifo-rendered line
     if (m_fifo_renderer.in_progress())
@@ -85,6 +226,7 @@ void age::gb_lcd_renderer::render(gb_current_line until, bool is_first_frame)
             return; // line not yet finished
         }
         ++m_rendered_lines;
+        ++m_frame_stats.m_fifo_rendered_lines;
     }
 
 #ifdef AGE_FORCE_FIFO_RENDERER
@@ -95,6 +237,7 @@ void age::gb_lcd_renderer::render(gb_current_line until, bool is_first_frame)
     {
         gb_current_line line{.m_line = m_rendered_lines, .m_line_clks = gb_clock_cycles_per_lcd_line};
         m_fifo_renderer.begin_new_line(line, is_first_frame);
+        ++m_frame_stats.m_fifo_rendered_lines;
     }
 
 #else
@@ -106,7 +249,8 @@ void age::gb_lcd_renderer::render(gb_current_line until, bool is_first_frame)
 
     for (; m_rendered_lines < sanitized; ++m_rendered_lines)
     {
-        m_line_renderer.render_line(m_rendered_lines);
+        render_simple_line(m_rendered_lines);
+        ++m_frame_stats.m_line_rendered_lines;
     }
 
 #endif
@@ -119,6 +263,80 @@ void age::gb_lcd_renderer::render(gb_current_line until, bool is_first_frame)
     assert(m_rendered_lines >= until.m_line);
     if (m_rendered_lines == until.m_line)
     {
+#ifndef AGE_FORCE_FIFO_RENDERER
+        // During mode 3 of a simple line we know which pixels have been
+        // plotted, so the line renderer can render them right away.
+        // The line is thus rendered in segments, if palettes change during
+        // mode 3.
+        if (is_simple_line(until.m_line, is_first_frame))
+        {
+            int plotted_px = gb_screen_width - (simple_line_mode3_end(m_scx) - until.m_line_clks);
+            if (plotted_px >= gb_screen_width)
+            {
+                render_simple_line(m_rendered_lines);
+                ++m_rendered_lines;
+                ++m_frame_stats.m_line_rendered_lines;
+                return;
+            }
+            if (plotted_px > m_segments_px)
+            {
+                render_line_segment(m_rendered_lines, plotted_px);
+            }
+            m_segments_until = until;
+            return;
+        }
+        assert(m_segments_until.m_line < 0);
+#endif
         m_fifo_renderer.begin_new_line(until, is_first_frame);
     }
 }
+
+
+
+void age::gb_lcd_renderer::render_simple_line(int line)
+{
+    render_line_segment(line, gb_screen_width);
+    m_segments_until = gb_no_line;
+    m_segments_px    = 0;
+}
+
+void age::gb_lcd_renderer::render_line_segment(int line, int to_x)
+{
+    assert(to_x > m_segments_px);
+
+    // The fifo renderer is still required for skipped frames
+    // as it affects the emulation (e.g. mode 3 duration),
+    // the line renderer just has to keep track of the window.
+    if (m_skip_frame)
+    {
+        if (to_x == gb_screen_width)
+        {
+            m_line_renderer.skip_line(line);
+        }
+    }
+    else
+    {
+        m_line_renderer.render_line_segment(line, m_segments_px, to_x, m_bgp_glitch);
+    }
+    m_segments_px = to_x;
+    m_bgp_glitch  = false;
+}
+
+bool age::gb_lcd_renderer::is_simple_line(int line, bool is_first_frame) const
+{
+    // Without sprites and window the duration of mode 3 depends only
+    // on SCX.
+    // The first line after switching on the LCD is rendered with
+    // a different timing, leave that one to the fifo renderer.
+    return !is_window_enabled(get_lcdc())
+           && !m_sprites.has_line_sprites(line)
+           && !(is_first_frame && (line == 0));
+}
+
+int age::gb_lcd_renderer::simple_line_mode3_end(uint8_t scx)
+{
+    // mode 3 ends after 172 T4 cycles plus the SCX alignment,
+    // the last pixel being plotted on line cycle 252 + (SCX & 7)
+    // (verified against the fifo renderer by age_gb_lcd_renderer.test.cpp)
+    return 80 + 172 + 1 + (scx & 7);
+}
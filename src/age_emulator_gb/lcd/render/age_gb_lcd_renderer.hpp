@@ -24,11 +24,14 @@
 #include "../../common/age_gb_device.hpp"
 #include "../palettes/age_gb_lcd_palettes.hpp"
 #include "age_gb_lcd_fifo_renderer.hpp"
+#include "age_gb_lcd_indexed_screen.hpp"
 #include "age_gb_lcd_line_renderer.hpp"
 #include "age_gb_lcd_renderer_common.hpp"
+#include "age_gb_lcd_tile_cache.hpp"
 #include "age_gb_lcd_window_check.hpp"
 
 #include <age_types.hpp>
+#include <emulator/age_gb_types.hpp>
 #include <gfx/age_screen_buffer.hpp>
 
 #include <span>
@@ -52,13 +55,32 @@ namespace age
 
         ~gb_lcd_renderer() = default;
 
-        [[nodiscard]] bool stat_mode0() const;
+        void reset(std::span<uint8_t const> video_ram);
+
+        void                            set_indexed_screen_enabled(bool enabled);
+        void                            set_rendering_enabled(bool enabled);
+        [[nodiscard]] gb_indexed_screen get_indexed_screen() const;
+        [[nodiscard]] gb_render_stats   get_render_stats() const;
+        [[nodiscard]] bool              stat_mode0() const;
 
         void set_clks_tile_data_change(gb_current_line at_line);
+        void after_video_ram_write(int vram_offset);
         void set_clks_bgp_change(gb_current_line at_line);
         void check_for_wy_match(gb_current_line at_line, uint8_t wy);
         void new_frame(bool frame_is_blank);
+        void repeat_frame(int frame_count);
         void render(gb_current_line until, bool is_first_frame);
+        bool render_previous_lines(gb_current_line at_line, bool is_first_frame);
+
+        //!
+        //! \brief Let the fifo renderer continue the current line,
+        //! if the line renderer is rendering it in segments.
+        //!
+        //! The line renderer handles only palette changes during mode 3.
+        //! This has to be called before changing anything else the
+        //! current line depends on (e.g. SCX, LCDC, OAM, video ram).
+        //!
+        void switch_to_fifo_renderer();
 
         using gb_lcd_renderer_common::get_lcdc;
         using gb_lcd_renderer_common::set_lcdc;
@@ -68,14 +90,38 @@ namespace age
         using gb_lcd_renderer_common::m_wx;
         using gb_lcd_renderer_common::m_wy;
 
+        //!
+        //! \brief Calculate the line cycle, at which mode 3 of a line
+        //! without sprites and window has finished.
+        //!
+        //! Lines this applies to can be rendered by the line renderer
+        //! as soon as this line cycle is reached.
+        //!
+        [[nodiscard]] static int simple_line_mode3_end(uint8_t scx);
+
     private:
+        void               render_lines(gb_current_line until, bool is_first_frame);
+        void               render_simple_line(int line);
+        void               render_line_segment(int line, int to_x);
+        [[nodiscard]] bool is_simple_line(int line, bool is_first_frame) const;
+
+        gb_lcd_indexed_screen  m_indexed_screen;
+        gb_lcd_tile_cache      m_tile_cache;
         gb_window_check        m_window;
         gb_lcd_fifo_renderer   m_fifo_renderer;
         gb_lcd_line_renderer   m_line_renderer;
         screen_buffer&         m_screen_buffer;
         const gb_lcd_palettes& m_palettes;
-
-        int m_rendered_lines = 0;
+        const gb_lcd_sprites&  m_sprites;
+
+        int             m_rendered_lines    = 0;
+        gb_current_line m_segments_until    = gb_no_line; //!< the current line is line-rendered in segments up to here
+        int             m_segments_px       = 0;          //!< pixels of the current line plotted by the line renderer
+        bool            m_bgp_glitch        = false;      //!< the next segment starts with the DMG BGP glitch
+        bool            m_rendering_enabled = true;
+        bool            m_skip_frame        = false; //!< rendering disabled at the start of the current frame
+        gb_render_stats m_frame_stats{};
+        gb_render_stats m_last_frame_stats{};
     };
 
 } // namespace age
@@ -0,0 +1,533 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "../../common/age_gb_device.hpp"
+#include "../palettes/age_gb_lcd_palettes.hpp"
+#include "age_gb_lcd_fifo_renderer.hpp"
+#include "age_gb_lcd_indexed_screen.hpp"
+#include "age_gb_lcd_renderer.hpp"
+#include "age_gb_lcd_renderer_common.hpp"
+#include "age_gb_lcd_sprites.hpp"
+#include "age_gb_lcd_window_check.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace
+{
+    age::uint8_vector create_rom(bool cgb_rom)
+    {
+        age::uint8_vector rom(0x8000, 0);
+        rom[0x143] = cgb_rom ? 0x80 : 0x00;
+        return rom;
+    }
+
+    age::uint8_vector random_video_ram()
+    {
+        std::mt19937      random(0x4711);
+        age::uint8_vector video_ram(0x4000, 0);
+        for (auto& byte : video_ram)
+        {
+            byte = static_cast<age::uint8_t>(random());
+        }
+        return video_ram;
+    }
+
+    //!
+    //! The gb_lcd_renderer to test and a separate fifo renderer
+    //! sharing device, palettes, sprites and video ram
+    //! for comparison.
+    //!
+    class gb_lcd_renderer_fixture
+    {
+    public:
+        gb_lcd_renderer_fixture(age::gb_device_type device_type, bool cgb_rom)
+            : m_rom(create_rom(cgb_rom)),
+              m_device(m_rom, device_type),
+              m_palettes(m_device, std::span(m_rom).first(0x150), age::gb_colors_hint::default_colors),
+              m_sprites(m_device.cgb_mode()),
+              m_video_ram(random_video_ram()),
+              m_screen_buffer(age::gb_screen_width, age::gb_screen_height),
+              m_renderer(m_device, m_palettes, m_sprites, m_video_ram, m_screen_buffer),
+              m_fifo_common(m_device, m_sprites),
+              m_fifo_window(m_device.is_dmg_device()),
+              m_fifo_indexed_screen(m_palettes),
+              m_fifo_screen_buffer(age::gb_screen_width, age::gb_screen_height),
+              m_fifo_renderer(m_device, m_fifo_common, m_palettes, m_sprites, m_video_ram, m_fifo_window, m_fifo_indexed_screen, m_fifo_screen_buffer)
+        {
+        }
+
+        void set_lcdc(age::uint8_t lcdc)
+        {
+            m_renderer.set_lcdc(lcdc);
+            m_fifo_common.set_lcdc(lcdc);
+        }
+
+        void set_scx(age::uint8_t scx)
+        {
+            m_renderer.m_scx    = scx;
+            m_fifo_common.m_scx = scx;
+        }
+
+        void set_scy(age::uint8_t scy)
+        {
+            m_renderer.m_scy    = scy;
+            m_fifo_common.m_scy = scy;
+        }
+
+        //! fifo-render the specified line from start to end
+        void fifo_render_line(int line)
+        {
+            m_fifo_renderer.begin_new_line({.m_line = line, .m_line_clks = 0}, false);
+            m_fifo_renderer.continue_line({.m_line = line + 1, .m_line_clks = 0});
+        }
+
+        //! fifo-render the specified line and return the line cycle
+        //! at which mode 3 has finished
+        int fifo_mode3_end(int line)
+        {
+            int mode3_end = -1;
+            m_fifo_renderer.begin_new_line({.m_line = line, .m_line_clks = 0}, false);
+            for (int clks = 1; clks < age::gb_clock_cycles_per_lcd_line; ++clks)
+            {
+                m_fifo_renderer.continue_line({.m_line = line, .m_line_clks = clks});
+                if (m_fifo_renderer.stat_mode0())
+                {
+                    mode3_end = clks;
+                    break;
+                }
+            }
+            // finish the line
+            m_fifo_renderer.continue_line({.m_line = line + 1, .m_line_clks = 0});
+            return mode3_end;
+        }
+
+        age::uint8_vector      m_rom;
+        age::gb_device         m_device;
+        age::gb_lcd_palettes   m_palettes;
+        age::gb_lcd_sprites    m_sprites;
+        age::uint8_vector      m_video_ram;
+        age::screen_buffer     m_screen_buffer;
+        age::gb_lcd_renderer   m_renderer;
+
+        age::gb_lcd_renderer_common m_fifo_common;
+        age::gb_window_check        m_fifo_window;
+        age::gb_lcd_indexed_screen  m_fifo_indexed_screen;
+        age::screen_buffer          m_fifo_screen_buffer;
+        age::gb_lcd_fifo_renderer   m_fifo_renderer;
+    };
+
+    struct device_config
+    {
+        age::gb_device_type m_device_type;
+        bool                m_cgb_rom;
+    };
+
+    constexpr std::array<device_config, 3> device_configs{
+        device_config{age::gb_device_type::dmg, false},
+        device_config{age::gb_device_type::cgb_abcd, false}, // non-CGB mode
+        device_config{age::gb_device_type::cgb_abcd, true},
+    };
+
+    //! a video ram write scheduled for a specific line cycle
+    struct video_ram_write
+    {
+        age::gb_current_line m_at_line;
+        int                  m_offset;
+        age::uint8_t         m_value;
+    };
+
+    //!
+    //! Schedule bursts of random video ram writes during mode 2 and mode 0
+    //! of random lines (video ram is not accessible during mode 3).
+    //!
+    std::vector<video_ram_write> random_video_ram_writes(bool cgb_mode)
+    {
+        std::mt19937 random(0x0815);
+        int          vram_size = cgb_mode ? 0x4000 : 0x2000;
+
+        std::vector<video_ram_write> writes;
+        for (int line = 0; line < age::gb_screen_height; ++line)
+        {
+            for (int line_clks : {8, 40, 76, 380, 420})
+            {
+                if (random() % 3)
+                {
+                    continue;
+                }
+                for (int i = 0; i < 64; ++i)
+                {
+                    writes.push_back({
+                        .m_at_line = {.m_line = line, .m_line_clks = line_clks},
+                        .m_offset  = static_cast<int>(random() % static_cast<unsigned>(vram_size)),
+                        .m_value   = static_cast<age::uint8_t>(random()),
+                    });
+                }
+            }
+        }
+        return writes;
+    }
+
+    //! a palette or SCX write scheduled for a specific line cycle
+    struct mid_line_write
+    {
+        age::gb_current_line m_at_line;
+        bool                 m_scx;         //!< SCX write instead of palette write
+        age::uint8_t         m_palette_ofs; //!< CGB palette byte (BCPS)
+        age::uint8_t         m_value;
+    };
+
+    //!
+    //! Schedule palette writes during mode 3 of random lines,
+    //! followed by an SCX write on some of these lines.
+    //!
+    std::vector<mid_line_write> random_mid_line_writes()
+    {
+        std::mt19937 random(0x2501);
+
+        std::vector<mid_line_write> writes;
+        for (int line = 0; line < age::gb_screen_height; ++line)
+        {
+            if (random() % 2)
+            {
+                continue;
+            }
+            // at most two palette changes per line
+            // (see gb_lcd_indexed_screen)
+            int line_clks = 80 + static_cast<int>(random() % 120);
+            for (int i = 0, max = 1 + static_cast<int>(random() % 2); i < max; ++i)
+            {
+                writes.push_back({
+                    .m_at_line     = {.m_line = line, .m_line_clks = line_clks},
+                    .m_scx         = false,
+                    .m_palette_ofs = static_cast<age::uint8_t>(random() % 64),
+                    .m_value       = static_cast<age::uint8_t>(random()),
+                });
+                line_clks += 4 + static_cast<int>(random() % 60);
+            }
+            if (!(random() % 8))
+            {
+                writes.push_back({
+                    .m_at_line     = {.m_line = line, .m_line_clks = line_clks},
+                    .m_scx         = true,
+                    .m_palette_ofs = 0,
+                    .m_value       = static_cast<age::uint8_t>(random()),
+                });
+            }
+        }
+        return writes;
+    }
+
+    age::pixel_vector indexed_colors(const age::gb_indexed_screen& indexed)
+    {
+        age::pixel_vector colors;
+        for (unsigned i = 0; i < indexed.m_color_indexes.size(); ++i)
+        {
+            unsigned palette = indexed.m_line_palettes[i / age::gb_screen_width];
+            colors.push_back(indexed.m_palettes[palette * age::gb_indexed_palette_size + indexed.m_color_indexes[i]]);
+        }
+        return colors;
+    }
+
+} // namespace
+
+
+
+TEST(AgeGbLcdRenderer, MidFrameVideoRamWritesMatchFifoRenderer)
+{
+    // lines without window and sprites are rendered by the line renderer,
+    // unless a video ram write forces the fifo renderer
+    constexpr std::array<age::uint8_t, 4> lcdc_values{0x91, 0x81, 0x99, 0x89};
+
+    for (const auto& config : device_configs)
+    {
+        for (auto lcdc : lcdc_values)
+        {
+            gb_lcd_renderer_fixture fixture(config.m_device_type, config.m_cgb_rom);
+            fixture.set_lcdc(lcdc);
+            fixture.set_scx(0x13);
+            fixture.set_scy(0x27);
+
+            auto writes    = random_video_ram_writes(fixture.m_device.cgb_mode());
+            auto video_ram = fixture.m_video_ram;
+
+            // render while writing to video ram, like gb_lcd does
+            for (const auto& write : writes)
+            {
+                if (!fixture.m_renderer.render_previous_lines(write.m_at_line, false))
+                {
+                    fixture.m_renderer.render(write.m_at_line, false);
+                }
+                fixture.m_video_ram[static_cast<unsigned>(write.m_offset)] = write.m_value;
+                fixture.m_renderer.after_video_ram_write(write.m_offset);
+            }
+            fixture.m_renderer.render({.m_line = age::gb_screen_height, .m_line_clks = 0}, false);
+            fixture.m_renderer.new_frame(false);
+            EXPECT_GT(fixture.m_renderer.get_render_stats().m_line_rendered_lines, 0);
+
+            // fifo-render the same frame line by line, starting with the
+            // initial video ram contents
+            fixture.m_video_ram = video_ram;
+            auto next_write     = writes.begin();
+
+            auto write_until = [&](int line, int line_clks) {
+                while ((next_write != writes.end())
+                       && (next_write->m_at_line.m_line == line)
+                       && (next_write->m_at_line.m_line_clks < line_clks))
+                {
+                    fixture.m_video_ram[static_cast<unsigned>(next_write->m_offset)] = next_write->m_value;
+                    ++next_write;
+                }
+            };
+
+            for (int line = 0; line < age::gb_screen_height; ++line)
+            {
+                write_until(line, 80); // mode 2 writes precede mode 3
+                fixture.fifo_render_line(line);
+                write_until(line, age::gb_clock_cycles_per_lcd_line); // mode 0 writes follow mode 3
+            }
+            fixture.m_fifo_screen_buffer.switch_buffers();
+
+            ASSERT_EQ(fixture.m_screen_buffer.get_front_buffer(), fixture.m_fifo_screen_buffer.get_front_buffer())
+                << "cgb device " << fixture.m_device.is_cgb_device()
+                << ", cgb mode " << fixture.m_device.cgb_mode()
+                << ", lcdc 0x" << std::hex << static_cast<int>(lcdc);
+        }
+    }
+}
+
+TEST(AgeGbLcdRenderer, BlanksScreenWithRenderingDisabled)
+{
+    gb_lcd_renderer_fixture fixture(age::gb_device_type::dmg, false);
+    fixture.set_lcdc(0x91);
+    fixture.m_renderer.set_indexed_screen_enabled(true);
+    fixture.m_renderer.new_frame(false); // indexing starts with the next frame
+
+    auto blank     = fixture.m_palettes.get_color_zero_dmg();
+    auto all_blank = [&](const age::pixel_vector& pixels) {
+        return std::all_of(begin(pixels), end(pixels), [&](const age::pixel& p) {
+            return p == blank;
+        });
+    };
+    auto front_indexed = [&] {
+        auto              indexed = fixture.m_renderer.get_indexed_screen();
+        age::pixel_vector colors;
+        for (unsigned i = 0; i < indexed.m_color_indexes.size(); ++i)
+        {
+            unsigned palette = indexed.m_line_palettes[i / age::gb_screen_width];
+            colors.push_back(indexed.m_palettes[palette * age::gb_indexed_palette_size + indexed.m_color_indexes[i]]);
+        }
+        return colors;
+    };
+
+    // rendered frame (random video ram),
+    // the indexed frame replaces the RGBA frame
+    auto rgba = fixture.m_screen_buffer.get_front_buffer();
+    fixture.m_renderer.render({.m_line = age::gb_screen_height, .m_line_clks = 0}, false);
+    fixture.m_renderer.set_rendering_enabled(false); // takes effect with the next frame
+    fixture.m_renderer.new_frame(false);
+    ASSERT_FALSE(all_blank(front_indexed()));
+    ASSERT_EQ(fixture.m_screen_buffer.get_front_buffer(), rgba);
+
+    // skipped frame: the last rendered frame is kept
+    auto rendered = front_indexed();
+    fixture.m_renderer.render({.m_line = age::gb_screen_height, .m_line_clks = 0}, false);
+    fixture.m_renderer.new_frame(false);
+    EXPECT_EQ(front_indexed(), rendered);
+
+    // skipped blank frame (e.g. LCD switched off): the screen is blanked
+    fixture.m_renderer.render({.m_line = 50, .m_line_clks = 0}, false);
+    fixture.m_renderer.new_frame(true);
+    EXPECT_TRUE(all_blank(front_indexed()));
+    EXPECT_EQ(fixture.m_screen_buffer.get_front_buffer(), rgba);
+
+    // RGBA frames are rendered again after disabling the indexed screen
+    fixture.m_renderer.set_indexed_screen_enabled(false);
+    fixture.m_renderer.new_frame(true);
+    EXPECT_TRUE(all_blank(fixture.m_screen_buffer.get_front_buffer()));
+    EXPECT_TRUE(all_blank(front_indexed()));
+}
+
+TEST(AgeGbLcdRenderer, SimpleLineMode3EndMatchesFifoRenderer)
+{
+    // lines without window and sprites, see gb_lcd_renderer::is_simple_line()
+    constexpr std::array<age::uint8_t, 5> lcdc_values{0x91, 0x90, 0x81, 0x8B, 0x97};
+
+    for (const auto& config : device_configs)
+    {
+        gb_lcd_renderer_fixture fixture(config.m_device_type, config.m_cgb_rom);
+
+        // sprites enabled, but not on the lines checked below
+        fixture.m_sprites.write_oam(age::gb_oam_ofs_y, 16 + 100);
+        fixture.m_sprites.write_oam(age::gb_oam_ofs_x, 8 + 50);
+
+        for (auto lcdc : lcdc_values)
+        {
+            fixture.set_lcdc(lcdc);
+
+            for (int scx = 0; scx < 256; ++scx)
+            {
+                fixture.set_scx(static_cast<age::uint8_t>(scx));
+
+                for (int line : {0, 1, 99, 143})
+                {
+                    ASSERT_FALSE(fixture.m_sprites.has_line_sprites(line));
+                    ASSERT_EQ(age::gb_lcd_renderer::simple_line_mode3_end(static_cast<age::uint8_t>(scx)),
+                              fixture.fifo_mode3_end(line))
+                        << "cgb device " << fixture.m_device.is_cgb_device()
+                        << ", cgb mode " << fixture.m_device.cgb_mode()
+                        << ", lcdc 0x" << std::hex << static_cast<int>(lcdc)
+                        << ", scx 0x" << scx
+                        << ", line " << std::dec << line;
+                }
+            }
+        }
+    }
+}
+
+TEST(AgeGbLcdRenderer, MidLinePaletteWritesMatchFifoRenderer)
+{
+    // lines without window and sprites are rendered in segments
+    // by the line renderer, unless SCX is written during mode 3
+    constexpr std::array<age::uint8_t, 2> lcdc_values{0x91, 0x90};
+    constexpr std::array<age::uint8_t, 2> scx_values{0x00, 0x2D};
+
+    auto writes = random_mid_line_writes();
+    int  scx_writes = static_cast<int>(std::count_if(begin(writes), end(writes), [](const auto& write) {
+        return write.m_scx;
+    }));
+
+    for (const auto& config : device_configs)
+    {
+        for (auto lcdc : lcdc_values)
+        {
+            for (auto scx : scx_values)
+            {
+                for (bool indexed : {false, true})
+                {
+                    gb_lcd_renderer_fixture fixture(config.m_device_type, config.m_cgb_rom);
+                    fixture.set_lcdc(lcdc);
+                    fixture.set_scx(scx);
+                    fixture.m_renderer.set_indexed_screen_enabled(indexed);
+                    fixture.m_renderer.new_frame(false); // indexing starts with the next frame
+
+                    bool  cgb_mode   = fixture.m_device.cgb_mode();
+                    bool  bgp_glitch = fixture.m_device.is_dmg_device();
+                    auto& palettes   = fixture.m_palettes;
+
+                    // DMG video ram has no tile attributes
+                    if (fixture.m_device.is_dmg_device())
+                    {
+                        std::fill(fixture.m_video_ram.begin() + 0x2000, fixture.m_video_ram.end(), 0);
+                    }
+
+                    auto write_palette = [&](const mid_line_write& write) {
+                        if (cgb_mode)
+                        {
+                            palettes.write_bcps(write.m_palette_ofs);
+                            palettes.write_bcpd(write.m_value);
+                        }
+                        else
+                        {
+                            palettes.write_bgp(write.m_value);
+                        }
+                    };
+                    auto reset_palettes = [&] {
+                        for (int i = 0; i < 64; ++i)
+                        {
+                            write_palette({.m_palette_ofs = static_cast<age::uint8_t>(i), .m_value = static_cast<age::uint8_t>(i * 37)});
+                        }
+                        write_palette({.m_value = 0xE4}); // DMG: previous BGP for the glitch
+                    };
+
+                    // render while writing palettes and SCX, like gb_lcd does
+                    reset_palettes();
+                    for (const auto& write : writes)
+                    {
+                        if (write.m_scx)
+                        {
+                            fixture.m_renderer.render(write.m_at_line, false);
+                            fixture.m_renderer.switch_to_fifo_renderer();
+                            fixture.m_renderer.m_scx = write.m_value;
+                            continue;
+                        }
+                        auto at_line = write.m_at_line;
+                        at_line.m_line_clks -= bgp_glitch ? 1 : 0;
+                        fixture.m_renderer.render(at_line, false);
+                        if (bgp_glitch)
+                        {
+                            fixture.m_renderer.set_clks_bgp_change(write.m_at_line);
+                        }
+                        write_palette(write);
+                    }
+                    fixture.m_renderer.render({.m_line = age::gb_screen_height, .m_line_clks = 0}, false);
+                    fixture.m_renderer.new_frame(false);
+
+                    auto stats = fixture.m_renderer.get_render_stats();
+                    EXPECT_GT(stats.m_fifo_rendered_lines, 0);
+                    EXPECT_LE(stats.m_fifo_rendered_lines, scx_writes);
+                    EXPECT_EQ(stats.m_fifo_rendered_lines + stats.m_line_rendered_lines, age::gb_screen_height);
+
+                    // fifo-render the same frame line by line
+                    fixture.m_fifo_indexed_screen.set_enabled(indexed);
+                    fixture.m_fifo_indexed_screen.begin_frame(true);
+                    fixture.m_fifo_common.m_scx = scx;
+                    reset_palettes();
+                    auto next_write = writes.begin();
+
+                    for (int line = 0; line < age::gb_screen_height; ++line)
+                    {
+                        fixture.m_fifo_renderer.begin_new_line({.m_line = line, .m_line_clks = 0}, false);
+                        for (; (next_write != writes.end()) && (next_write->m_at_line.m_line == line); ++next_write)
+                        {
+                            auto at_line = next_write->m_at_line;
+                            if (next_write->m_scx)
+                            {
+                                fixture.m_fifo_renderer.continue_line(at_line);
+                                fixture.m_fifo_common.m_scx = next_write->m_value;
+                                continue;
+                            }
+                            at_line.m_line_clks -= bgp_glitch ? 1 : 0;
+                            fixture.m_fifo_renderer.continue_line(at_line);
+                            if (bgp_glitch)
+                            {
+                                fixture.m_fifo_renderer.set_clks_bgp_change(next_write->m_at_line);
+                            }
+                            write_palette(*next_write);
+                        }
+                        fixture.m_fifo_renderer.continue_line({.m_line = line + 1, .m_line_clks = 0});
+                    }
+                    fixture.m_fifo_screen_buffer.switch_buffers();
+                    fixture.m_fifo_indexed_screen.switch_buffers();
+
+                    auto screen      = indexed ? indexed_colors(fixture.m_renderer.get_indexed_screen()) : fixture.m_screen_buffer.get_front_buffer();
+                    auto fifo_screen = indexed ? indexed_colors(fixture.m_fifo_indexed_screen.get_front_buffer()) : fixture.m_fifo_screen_buffer.get_front_buffer();
+
+                    ASSERT_EQ(screen, fifo_screen)
+                        << "cgb device " << fixture.m_device.is_cgb_device()
+                        << ", cgb mode " << cgb_mode
+                        << ", indexed " << indexed
+                        << ", lcdc 0x" << std::hex << static_cast<int>(lcdc)
+                        << ", scx 0x" << static_cast<int>(scx);
+                }
+            }
+        }
+    }
+}
@@ -49,6 +49,17 @@ namespace age
 
         ~gb_lcd_renderer_common() = default;
 
+        void reset()
+        {
+            m_scy = 0;
+            m_scx = 0;
+            m_wy  = 0;
+            m_wx  = 0;
+
+            m_priority_mask = 0xFF;
+            set_lcdc(0x91);
+        }
+
 
 
         const uint8_array<256> m_xflip_cache;
@@ -21,12 +21,16 @@
 //! \file
 //!
 
+#include "../common/age_gb_lcd_common.hpp"
 #include "../palettes/age_gb_lcd_palettes.hpp"
 
 #include <age_types.hpp>
 
-#include <algorithm> // std::sort
+#include <algorithm> // std::fill, std::sort
+#include <array>
+#include <bit>
 #include <cassert>
+#include <span>
 
 
 
@@ -45,6 +49,8 @@ namespace age
     constexpr uint8_t gb_oam_ofs_tile       = 2;
     constexpr uint8_t gb_oam_ofs_attributes = 3;
 
+    constexpr int gb_max_sprites_per_line = 10;
+
 
 
     struct gb_sprite
@@ -66,6 +72,8 @@ namespace age
                    : gb_palette_obp0;
     }
 
+    using gb_line_sprites = std::array<gb_sprite, gb_max_sprites_per_line>;
+
 
 
     class gb_lcd_sprites
@@ -81,6 +89,16 @@ namespace age
 
         ~gb_lcd_sprites() = default;
 
+        void reset(bool cgb_mode)
+        {
+            std::fill(begin(m_oam), end(m_oam), 0);
+            std::fill(begin(m_line_index), end(m_line_index), 0);
+            m_sprite_size    = 8;
+            m_tile_nr_mask   = 0xFF;
+            m_cgb_mode       = cgb_mode;
+            m_attribute_mask = cgb_mode ? 0xFF : 0xF0;
+        }
+
 
 
         [[nodiscard]] uint8_t read_oam(int offset) const
@@ -92,6 +110,12 @@ namespace age
         void write_oam(int offset, uint8_t value)
         {
             assert((offset >= 0) && (offset < 160));
+            if ((offset & 0b11) == gb_oam_ofs_y)
+            {
+                int sprite_id = offset >> 2;
+                update_line_index(sprite_id, m_oam[offset], false);
+                update_line_index(sprite_id, value, true);
+            }
             m_oam[offset] = value;
         }
 
@@ -110,42 +134,59 @@ namespace age
         void set_sprite_size(uint8_t sprite_size)
         {
             assert((sprite_size == 8) || (sprite_size == 16));
+            if (m_sprite_size == sprite_size)
+            {
+                return;
+            }
             m_sprite_size  = sprite_size;
             m_tile_nr_mask = (sprite_size == 16) ? 0xFE : 0xFF;
+
+            // rebuild line index
+            m_line_index.fill(0);
+            for (int sprite_id = 0; sprite_id < 40; ++sprite_id)
+            {
+                update_line_index(sprite_id, m_oam[sprite_id * 4 + gb_oam_ofs_y], true);
+            }
         }
 
 
 
-        [[nodiscard]] std::vector<gb_sprite> get_line_sprites(int line, bool sort_by_x) const
+        [[nodiscard]] bool has_line_sprites(int line) const
         {
-            // find the first 10 sprites on this line
-            std::vector<gb_sprite> sprites;
+            assert((line >= 0) && (line < gb_screen_height));
+            return m_line_index[line] != 0;
+        }
 
-            for (uint8_t sprite_id = 0; sprite_id < 40; ++sprite_id)
-            {
-                unsigned oam_ofs = sprite_id * 4U;
+        //!
+        //! Find the first 10 sprites on the specified line (in OAM order).
+        //! No memory is allocated, the sprites are stored in the specified
+        //! buffer.
+        //!
+        //! \return The part of the buffer holding the line's sprites.
+        //!
+        [[nodiscard]] std::span<gb_sprite> get_line_sprites(int line, bool sort_by_x, gb_line_sprites& buffer) const
+        {
+            assert((line >= 0) && (line < gb_screen_height));
+
+            // bit N set for sprite N being on this line
+            uint64_t line_sprites = m_line_index[line];
 
-                uint8_t y      = m_oam[oam_ofs + gb_oam_ofs_y];
-                int     y_diff = line + 16 - y;
-                if ((y_diff < 0) || (y_diff >= m_sprite_size))
-                {
-                    continue;
-                }
+            std::size_t count = 0;
+            while (line_sprites && (count < buffer.size()))
+            {
+                auto     sprite_id = static_cast<uint8_t>(std::countr_zero(line_sprites));
+                unsigned oam_ofs   = sprite_id * 4U;
+                line_sprites &= line_sprites - 1;
 
-                gb_sprite sprite{};
-                sprite.m_y           = y;
+                gb_sprite& sprite    = buffer[count++];
+                sprite.m_y           = m_oam[oam_ofs + gb_oam_ofs_y];
                 sprite.m_x           = m_oam[oam_ofs + gb_oam_ofs_x];
                 sprite.m_tile_nr     = m_oam[oam_ofs + gb_oam_ofs_tile];
                 sprite.m_attributes  = m_oam[oam_ofs + gb_oam_ofs_attributes] & m_attribute_mask;
                 sprite.m_sprite_id   = sprite_id;
                 sprite.m_palette_idx = gb_get_sprite_palette_idx(sprite.m_attributes, m_cgb_mode);
-
-                sprites.push_back(sprite);
-                if (sprites.size() >= 10)
-                {
-                    break;
-                }
             }
+            std::span<gb_sprite> sprites{buffer.data(), count};
 
             // non-CGB mode: sort sprites by X coordinate
             if (sort_by_x)
@@ -163,13 +204,31 @@ namespace age
         }
 
     private:
+        void update_line_index(int sprite_id, uint8_t y, bool on_line)
+        {
+            // sprite lines clipped to visible lines
+            int first_line = std::max(0, y - 16);
+            int last_line  = std::min<int>(gb_screen_height, y - 16 + m_sprite_size);
+
+            uint64_t sprite_bit = uint64_t{1} << sprite_id;
+            for (int line = first_line; line < last_line; ++line)
+            {
+                auto& line_sprites = m_line_index[static_cast<unsigned>(line)];
+                line_sprites       = on_line ? (line_sprites | sprite_bit) : (line_sprites & ~sprite_bit);
+            }
+        }
+
         uint8_array<160> m_oam{};
 
+        // one bit per sprite for every visible line,
+        // updated on OAM Y writes and sprite size changes
+        std::array<uint64_t, gb_screen_height> m_line_index{};
+
         uint8_t m_sprite_size  = 8;
         uint8_t m_tile_nr_mask = 0xFF;
 
-        const bool    m_cgb_mode;
-        const uint8_t m_attribute_mask;
+        bool    m_cgb_mode;
+        uint8_t m_attribute_mask;
     };
 
 } // namespace age
@@ -0,0 +1,80 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "age_gb_lcd_sprites.hpp"
+
+#include <gtest/gtest.h>
+
+
+
+namespace
+{
+    std::vector<int> line_sprite_ids(const age::gb_lcd_sprites& sprites, int line)
+    {
+        age::gb_line_sprites buffer;
+        std::vector<int>     ids;
+        for (const auto& sprite : sprites.get_line_sprites(line, false, buffer))
+        {
+            ids.push_back(sprite.m_sprite_id);
+        }
+        return ids;
+    }
+
+} // namespace
+
+
+
+TEST(AgeGbLcdSprites, FindsSpritesAfterYChange)
+{
+    age::gb_lcd_sprites sprites(false);
+    sprites.write_oam(5 * 4 + age::gb_oam_ofs_y, 16 + 20);
+
+    EXPECT_EQ(line_sprite_ids(sprites, 19), std::vector<int>{});
+    EXPECT_EQ(line_sprite_ids(sprites, 20), std::vector<int>{5});
+    EXPECT_EQ(line_sprite_ids(sprites, 27), std::vector<int>{5});
+    EXPECT_EQ(line_sprite_ids(sprites, 28), std::vector<int>{});
+
+    sprites.write_oam(5 * 4 + age::gb_oam_ofs_y, 16 + 24);
+    EXPECT_EQ(line_sprite_ids(sprites, 20), std::vector<int>{});
+    EXPECT_EQ(line_sprite_ids(sprites, 31), std::vector<int>{5});
+}
+
+TEST(AgeGbLcdSprites, FindsSpritesAfterSizeChange)
+{
+    age::gb_lcd_sprites sprites(false);
+    sprites.write_oam(0 * 4 + age::gb_oam_ofs_y, 16);
+    sprites.write_oam(1 * 4 + age::gb_oam_ofs_y, 12);
+    EXPECT_EQ(line_sprite_ids(sprites, 3), (std::vector<int>{0, 1}));
+    EXPECT_EQ(line_sprite_ids(sprites, 7), (std::vector<int>{0}));
+    EXPECT_EQ(line_sprite_ids(sprites, 8), std::vector<int>{});
+
+    sprites.set_sprite_size(16);
+    EXPECT_EQ(line_sprite_ids(sprites, 8), (std::vector<int>{0, 1}));
+    EXPECT_EQ(line_sprite_ids(sprites, 15), (std::vector<int>{0}));
+
+    sprites.set_sprite_size(8);
+    EXPECT_EQ(line_sprite_ids(sprites, 8), std::vector<int>{});
+}
+
+TEST(AgeGbLcdSprites, FindsFirstTenSprites)
+{
+    age::gb_lcd_sprites sprites(false);
+    for (int sprite_id = 39; sprite_id >= 0; sprite_id -= 3)
+    {
+        sprites.write_oam(sprite_id * 4 + age::gb_oam_ofs_y, 16 + 100);
+    }
+    EXPECT_EQ(line_sprite_ids(sprites, 100), (std::vector<int>{0, 3, 6, 9, 12, 15, 18, 21, 24, 27}));
+}
@@ -0,0 +1,128 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_GB_LCD_TILE_CACHE_HPP
+#define AGE_GB_LCD_TILE_CACHE_HPP
+
+//!
+//! \file
+//!
+
+#include <age_types.hpp>
+
+#include <algorithm> // std::fill
+#include <array>
+#include <cassert>
+#include <span>
+
+
+
+namespace age
+{
+    //!
+    //! Tile data rows decoded to color indexes.
+    //!
+    //! A row is decoded on first access and stays valid until the
+    //! respective video ram bytes are written.
+    //! Each row holds 8 color indexes (one byte per pixel),
+    //! the leftmost pixel in the least significant byte.
+    //!
+    class gb_lcd_tile_cache
+    {
+        AGE_DISABLE_COPY(gb_lcd_tile_cache);
+        AGE_DISABLE_MOVE(gb_lcd_tile_cache);
+
+    public:
+        explicit gb_lcd_tile_cache(std::span<uint8_t const> video_ram)
+            : m_video_ram(video_ram)
+        {}
+
+        ~gb_lcd_tile_cache() = default;
+
+        void reset(std::span<uint8_t const> video_ram)
+        {
+            m_video_ram = video_ram;
+            std::fill(begin(m_row_valid), end(m_row_valid), false);
+        }
+
+        //!
+        //! \param vram_offset The video ram offset including the bank:
+        //! 0x0000 - 0x1FFF for bank 0, 0x2000 - 0x3FFF for bank 1.
+        //!
+        void invalidate(int vram_offset)
+        {
+            assert((vram_offset >= 0) && (vram_offset < 0x4000));
+            if ((vram_offset & 0x1FFF) < 0x1800)
+            {
+                m_row_valid[row_index(vram_offset)] = false;
+            }
+        }
+
+        //!
+        //! \param tile_data_ofs The video ram offset of the row's first byte,
+        //! including the bank (see invalidate()).
+        //!
+        [[nodiscard]] uint64_t get_row(int tile_data_ofs, bool flip_x)
+        {
+            assert((tile_data_ofs & 1) == 0);
+            auto idx = row_index(tile_data_ofs);
+            if (!m_row_valid[idx])
+            {
+                m_rows[idx]      = decode_row(m_video_ram[tile_data_ofs], m_video_ram[tile_data_ofs + 1]);
+                m_row_valid[idx] = true;
+            }
+            return flip_x ? reverse_bytes(m_rows[idx]) : m_rows[idx];
+        }
+
+        static constexpr uint64_t decode_row(uint8_t tile_byte1, uint8_t tile_byte2)
+        {
+            // bit 7 holds the leftmost pixel
+            uint64_t row = 0;
+            for (int px = 0; px < 8; ++px)
+            {
+                uint64_t color_idx = ((tile_byte1 >> (7 - px)) & 1) + (((tile_byte2 >> (7 - px)) & 1) << 1);
+                row |= color_idx << (px * 8);
+            }
+            return row;
+        }
+
+    private:
+        static unsigned row_index(int vram_offset)
+        {
+            assert((vram_offset >= 0) && (vram_offset < 0x4000));
+            assert((vram_offset & 0x1FFF) < 0x1800);
+            // 0x1800 bytes of tile data per bank, 2 bytes per row
+            return static_cast<unsigned>(((vram_offset >> 13) * 0xC00) + ((vram_offset & 0x1FFF) >> 1));
+        }
+
+        static constexpr uint64_t reverse_bytes(uint64_t value)
+        {
+            // usually compiled to a single byte swap instruction
+            value = ((value & 0x00FF00FF00FF00FFULL) << 8) | ((value >> 8) & 0x00FF00FF00FF00FFULL);
+            value = ((value & 0x0000FFFF0000FFFFULL) << 16) | ((value >> 16) & 0x0000FFFF0000FFFFULL);
+            return (value << 32) | (value >> 32);
+        }
+
+        std::span<uint8_t const>     m_video_ram;
+        std::array<uint64_t, 0x1800> m_rows{};
+        std::array<bool, 0x1800>     m_row_valid{};
+    };
+
+} // namespace age
+
+
+
+#endif // AGE_GB_LCD_TILE_CACHE_HPP
@@ -0,0 +1,58 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "age_gb_lcd_tile_cache.hpp"
+
+#include <gtest/gtest.h>
+
+
+
+TEST(AgeGbLcdTileCache, DecodesRow)
+{
+    // leftmost pixel in the least significant byte
+    EXPECT_EQ(age::gb_lcd_tile_cache::decode_row(0x80, 0x00), 0x0000000000000001ULL);
+    EXPECT_EQ(age::gb_lcd_tile_cache::decode_row(0x00, 0x80), 0x0000000000000002ULL);
+    EXPECT_EQ(age::gb_lcd_tile_cache::decode_row(0x01, 0x01), 0x0300000000000000ULL);
+    EXPECT_EQ(age::gb_lcd_tile_cache::decode_row(0xF0, 0x3C), 0x0000020203030101ULL);
+}
+
+TEST(AgeGbLcdTileCache, FlipsRow)
+{
+    age::uint8_vector      video_ram(0x4000, 0);
+    age::gb_lcd_tile_cache tile_cache(video_ram);
+
+    video_ram[0x2010] = 0xF0;
+    video_ram[0x2011] = 0x3C;
+
+    EXPECT_EQ(tile_cache.get_row(0x2010, false), 0x0000020203030101ULL);
+    EXPECT_EQ(tile_cache.get_row(0x2010, true), 0x0101030302020000ULL);
+}
+
+TEST(AgeGbLcdTileCache, DecodesRowAfterInvalidation)
+{
+    age::uint8_vector      video_ram(0x4000, 0);
+    age::gb_lcd_tile_cache tile_cache(video_ram);
+
+    video_ram[0x17FE] = 0xFF;
+    EXPECT_EQ(tile_cache.get_row(0x17FE, false), 0x0101010101010101ULL);
+
+    // not invalidated => still cached
+    video_ram[0x17FF] = 0xFF;
+    EXPECT_EQ(tile_cache.get_row(0x17FE, false), 0x0101010101010101ULL);
+
+    tile_cache.invalidate(0x17FF);
+    EXPECT_EQ(tile_cache.get_row(0x17FE, false), 0x0303030303030303ULL);
+}
@@ -35,6 +35,12 @@ namespace age
         {
         }
 
+        void reset(bool dmg)
+        {
+            m_dmg = dmg;
+            new_frame();
+        }
+
         void new_frame()
         {
             m_frame_wy_match = false;
@@ -97,7 +103,7 @@ namespace age
         }
 
     private:
-        const bool m_dmg;
+        bool m_dmg;
         bool       m_frame_wy_match = false;
         int        m_current_wline  = -1;
     };
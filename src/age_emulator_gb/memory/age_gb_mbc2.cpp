@@ -60,7 +60,9 @@ void age::gb_memory::mbc2_cart_ram_write(gb_memory& memory, uint16_t address, ui
 {
     if (memory.m_num_cart_ram_banks > 0)
     {
-        memory.m_memory[memory.get_offset(mbc2_ram_address(address))] = value | 0xF0;
+        auto offset             = memory.get_offset(mbc2_ram_address(address));
+        memory.m_memory[offset] = value | 0xF0;
+        memory.set_persistent_ram_dirty(offset);
     }
 }
 
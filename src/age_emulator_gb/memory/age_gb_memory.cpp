@@ -47,13 +47,13 @@ std::span<age::uint8_t const> age::gb_memory::get_video_ram() const
 
 std::span<age::uint8_t const> age::gb_memory::get_rom_header() const
 {
-    return {m_memory.begin(), 150};
+    return {m_cart_rom->begin(), 150};
 }
 
 std::string age::gb_memory::get_cartridge_title() const
 {
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    const char* buffer = reinterpret_cast<const char*>(&m_memory[gb_cia_ofs_title]);
+    const char* buffer = reinterpret_cast<const char*>(&(*m_cart_rom)[gb_cia_ofs_title]);
     std::string result = {buffer, 16};
     return result;
 }
@@ -106,6 +106,39 @@ void age::gb_memory::set_persistent_ram(const uint8_vector& source)
                       0);
         }
     }
+    m_dirty_ram_pages.reset();
+}
+
+bool age::gb_memory::is_persistent_ram_dirty() const
+{
+    return m_dirty_ram_pages.any();
+}
+
+int age::gb_memory::copy_dirty_persistent_ram(std::span<uint8_t> destination)
+{
+    if (m_dirty_ram_pages.none())
+    {
+        return 0;
+    }
+    assert(m_has_battery);
+    assert(destination.size() == static_cast<unsigned>(m_num_cart_ram_banks * gb_cart_ram_bank_size));
+
+    int pages_copied = 0;
+    for (unsigned page = 0; page < m_dirty_ram_pages.size(); ++page)
+    {
+        auto offset = page * gb_persistent_ram_page_size;
+        if (!m_dirty_ram_pages.test(page) || (offset + gb_persistent_ram_page_size > destination.size()))
+        {
+            continue;
+        }
+        std::copy_n(begin(m_memory) + m_cart_ram_offset + offset,
+                    gb_persistent_ram_page_size,
+                    begin(destination) + offset);
+        ++pages_copied;
+    }
+
+    m_dirty_ram_pages.reset();
+    return pages_copied;
 }
 
 
@@ -113,7 +146,12 @@ void age::gb_memory::set_persistent_ram(const uint8_vector& source)
 age::uint8_t age::gb_memory::read_byte(uint16_t address)
 {
     assert(address < 0xFE00);
-    // rom, video ram & work ram
+    // rom
+    if (address < 0x8000)
+    {
+        return (*m_cart_rom)[get_rom_offset(address)];
+    }
+    // video ram & work ram
     if (!is_cartridge_ram(address))
     {
         return m_memory[get_offset(address)];
@@ -128,6 +166,19 @@ age::uint8_t age::gb_memory::read_byte(uint16_t address)
     return m_cart_ram_read(*this, address);
 }
 
+age::uint8_t age::gb_memory::peek_byte(uint16_t address) const
+{
+    assert(address < 0xFE00);
+    if (address < 0x8000)
+    {
+        return (*m_cart_rom)[get_rom_offset(address)];
+    }
+    // cartridge ram is mapped depending on the MBC
+    // (e.g. MBC3 real time clock registers, MBC7 EEPROM),
+    // we don't peek into it to keep this free of side effects
+    return is_cartridge_ram(address) ? 0xFF : m_memory[get_offset(address)];
+}
+
 age::uint8_t age::gb_memory::read_svbk() const
 {
     return m_svbk;
@@ -237,6 +288,28 @@ unsigned age::gb_memory::get_offset(uint16_t address) const
     return static_cast<unsigned>(offset);
 }
 
+unsigned age::gb_memory::get_rom_offset(uint16_t address) const
+{
+    assert(address < 0x8000);
+    auto offset = m_offsets[address >> 12];
+    offset += address;
+
+    assert(offset >= 0);
+    assert(static_cast<unsigned>(offset) < m_cart_rom->size());
+
+    return static_cast<unsigned>(offset);
+}
+
+void age::gb_memory::set_persistent_ram_dirty(unsigned offset)
+{
+    if (m_has_battery)
+    {
+        assert(offset >= static_cast<unsigned>(m_cart_ram_offset));
+        assert(offset < static_cast<unsigned>(m_work_ram_offset));
+        m_dirty_ram_pages.set((offset - m_cart_ram_offset) / gb_persistent_ram_page_size);
+    }
+}
+
 void age::gb_memory::set_cart_ram_enabled(uint8_t value)
 {
     m_cart_ram_enabled = (value & 0x0F) == 0x0A;
@@ -292,7 +365,9 @@ void age::gb_memory::cart_ram_write(gb_memory& memory, uint16_t address, uint8_t
 {
     if (memory.m_num_cart_ram_banks > 0)
     {
-        memory.m_memory[memory.get_offset(address)] = value;
+        auto offset             = memory.get_offset(address);
+        memory.m_memory[offset] = value;
+        memory.set_persistent_ram_dirty(offset);
     }
 }
 
@@ -25,7 +25,9 @@
 
 #include <age_types.hpp>
 
+#include <bitset>
 #include <functional>
+#include <memory>
 #include <span>
 #include <string>
 #include <variant>
@@ -37,6 +39,10 @@ namespace age
 
     constexpr int gb_cart_rom_bank_size  = 0x4000;
     constexpr int gb_cart_ram_bank_size  = 0x2000;
+    constexpr int gb_cart_ram_max_banks  = 16;
+
+    //! persistent ram modifications are tracked per page of this size
+    constexpr int gb_persistent_ram_page_size = 0x200;
 
     constexpr int gb_work_ram_bank_size  = 0x1000;
     constexpr int gb_work_ram_size       = 8 * age::gb_work_ram_bank_size;
@@ -52,17 +58,34 @@ namespace age
         AGE_DISABLE_MOVE(gb_memory);
 
     public:
-        explicit gb_memory(const uint8_vector& cart_rom, const gb_clock& clock, bool is_cgb_device);
+        //!
+        //! The cartridge rom is not copied if it is big enough for the
+        //! number of rom banks specified by the cartridge header.
+        //! This allows multiple emulator instances to share the same rom.
+        //!
+        gb_memory(std::shared_ptr<const uint8_vector> cart_rom,
+                  const gb_clock&                     clock,
+                  bool                                is_cgb_device);
         ~gb_memory() = default;
 
+        //!
+        //! Reinitialize the memory for the specified cartridge rom
+        //! like the constructor does.
+        //! The memory vector is reused to avoid reallocation.
+        //!
+        void reset(std::shared_ptr<const uint8_vector> cart_rom, bool is_cgb_device);
+
         [[nodiscard]] std::span<uint8_t const> get_video_ram() const;
         [[nodiscard]] std::span<uint8_t const> get_rom_header() const;
         [[nodiscard]] std::string              get_cartridge_title() const;
 
         [[nodiscard]] uint8_vector get_persistent_ram() const;
         void                       set_persistent_ram(const uint8_vector& source);
+        [[nodiscard]] bool         is_persistent_ram_dirty() const;
+        int                        copy_dirty_persistent_ram(std::span<uint8_t> destination);
 
         [[nodiscard]] uint8_t read_byte(uint16_t address);
+        [[nodiscard]] uint8_t peek_byte(uint16_t address) const;
         [[nodiscard]] uint8_t read_svbk() const;
         [[nodiscard]] uint8_t read_vbk() const;
 
@@ -147,6 +170,8 @@ namespace age
         }
 
         [[nodiscard]] unsigned get_offset(uint16_t address) const;
+        [[nodiscard]] unsigned get_rom_offset(uint16_t address) const;
+        void                   set_persistent_ram_dirty(unsigned offset);
         void                   set_cart_ram_enabled(uint8_t value);
         void                   set_rom_banks(int low_bank_id, int high_bank_id);
         void                   set_ram_bank(int bank_id);
@@ -164,18 +189,22 @@ namespace age
         gb_fn_write_byte m_cart_ram_write;
         gb_fn_read_byte  m_cart_ram_read;
 
-        const int16_t m_num_cart_rom_banks;
-        const int16_t m_num_cart_ram_banks;
-        const bool    m_has_battery;
-        bool          m_cart_ram_enabled = false; //!< also used as "feature enabled" e.g. for MBC3-RTC
-        uint8_t       m_svbk             = 0xF8;
-        uint8_t       m_vbk              = 0xF8;
-
-        const int           m_cart_ram_offset;
-        const int           m_work_ram_offset;
-        const int           m_video_ram_offset;
-        uint8_vector        m_memory;
-        std::array<int, 16> m_offsets{};
+        int16_t m_num_cart_rom_banks = 0;
+        int16_t m_num_cart_ram_banks = 0;
+        bool    m_has_battery        = false;
+        bool    m_cart_ram_enabled   = false; //!< also used as "feature enabled" e.g. for MBC3-RTC
+        uint8_t m_svbk               = 0xF8;
+        uint8_t m_vbk                = 0xF8;
+
+        int                                 m_cart_ram_offset  = 0;
+        int                                 m_work_ram_offset  = 0;
+        int                                 m_video_ram_offset = 0;
+        std::shared_ptr<const uint8_vector> m_cart_rom; //!< read-only, may be shared with other instances
+        uint8_vector                        m_memory;   //!< cartridge ram, work ram & video ram
+        std::array<int, 16>                 m_offsets{};
+
+        static constexpr int gb_persistent_ram_max_pages = gb_cart_ram_max_banks * gb_cart_ram_bank_size / gb_persistent_ram_page_size;
+        std::bitset<gb_persistent_ram_max_pages> m_dirty_ram_pages; //!< persistent ram pages modified since the last copy
     };
 
 } // namespace age
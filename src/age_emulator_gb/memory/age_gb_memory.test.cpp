@@ -0,0 +1,109 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "../common/age_gb_clock.hpp"
+#include "../common/age_gb_device.hpp"
+#include "../common/age_gb_logger.hpp"
+#include "age_gb_memory.hpp"
+
+#include <memory>
+
+namespace
+{
+    constexpr int cart_ram_size = 4 * age::gb_cart_ram_bank_size;
+
+    //! create an MBC1 rom with 4 cartridge ram banks
+    std::shared_ptr<const age::uint8_vector> create_rom(bool has_battery)
+    {
+        auto rom      = std::make_shared<age::uint8_vector>(2 * age::gb_cart_rom_bank_size, 0);
+        (*rom)[0x147] = has_battery ? 0x03 : 0x02; // cartridge type
+        (*rom)[0x149] = 0x03;                       // ram size
+        return rom;
+    }
+
+    class gb_memory_fixture
+    {
+    public:
+        explicit gb_memory_fixture(bool has_battery)
+            : m_rom(create_rom(has_battery)),
+              m_device(*m_rom, age::gb_device_type::dmg),
+              m_clock(m_logger, m_device),
+              m_memory(m_rom, m_clock, false)
+        {
+            m_memory.write_byte(0x0000, 0x0A); // enable cartridge ram
+        }
+
+        std::shared_ptr<const age::uint8_vector> m_rom;
+        age::gb_logger                           m_logger;
+        age::gb_device                           m_device;
+        age::gb_clock                            m_clock;
+        age::gb_memory                           m_memory;
+    };
+
+} // namespace
+
+
+
+TEST(AgeGbMemory, TracksDirtyPersistentRamPages)
+{
+    gb_memory_fixture fixture(true);
+    auto&             memory = fixture.m_memory;
+    EXPECT_FALSE(memory.is_persistent_ram_dirty());
+
+    memory.write_byte(0xA000, 0x12);
+    memory.write_byte(0xA001, 0x34);
+    memory.write_byte(0xBFFF, 0x56);
+    EXPECT_TRUE(memory.is_persistent_ram_dirty());
+
+    age::uint8_vector ram(cart_ram_size, 0xFF);
+    EXPECT_EQ(memory.copy_dirty_persistent_ram(ram), 2);
+    EXPECT_FALSE(memory.is_persistent_ram_dirty());
+    EXPECT_EQ(ram[0x0000], 0x12);
+    EXPECT_EQ(ram[0x0001], 0x34);
+    EXPECT_EQ(ram[0x1FFF], 0x56);
+    EXPECT_EQ(ram[0x0200], 0xFF); // clean page, not copied
+
+    // nothing changed since the last copy
+    EXPECT_EQ(memory.copy_dirty_persistent_ram(ram), 0);
+
+    // write to the last ram bank (MBC1 ram bank switching requires mode 1)
+    memory.write_byte(0x6000, 0x01);
+    memory.write_byte(0x4000, 0x03);
+    memory.write_byte(0xA200, 0x78);
+    EXPECT_EQ(memory.copy_dirty_persistent_ram(ram), 1);
+    EXPECT_EQ(ram[3 * age::gb_cart_ram_bank_size + 0x200], 0x78);
+}
+
+TEST(AgeGbMemory, SettingPersistentRamClearsDirtyPages)
+{
+    gb_memory_fixture fixture(true);
+    auto&             memory = fixture.m_memory;
+
+    memory.write_byte(0xA000, 0x12);
+    memory.set_persistent_ram(age::uint8_vector(cart_ram_size, 0));
+    EXPECT_FALSE(memory.is_persistent_ram_dirty());
+}
+
+TEST(AgeGbMemory, IgnoresRamWithoutBattery)
+{
+    gb_memory_fixture fixture(false);
+    auto&             memory = fixture.m_memory;
+
+    memory.write_byte(0xA000, 0x12);
+    EXPECT_FALSE(memory.is_persistent_ram_dirty());
+}
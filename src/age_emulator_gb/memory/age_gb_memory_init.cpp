@@ -195,21 +195,38 @@ namespace
 //
 //---------------------------------------------------------
 
-age::gb_memory::gb_memory(const uint8_vector& cart_rom, const gb_clock& clock, bool is_cgb_device)
-    : m_clock(clock),
-      m_num_cart_rom_banks(get_num_cart_rom_banks(cart_rom)),
-      m_num_cart_ram_banks(get_num_cart_ram_banks(cart_rom)),
-      m_has_battery(has_battery(cart_rom)),
-      m_cart_ram_offset(m_num_cart_rom_banks * gb_cart_rom_bank_size),
-      m_work_ram_offset(m_cart_ram_offset + m_num_cart_ram_banks * gb_cart_ram_bank_size),
-      m_video_ram_offset(m_work_ram_offset + gb_work_ram_size)
+age::gb_memory::gb_memory(std::shared_ptr<const uint8_vector> cart_rom,
+                          const gb_clock&                     clock,
+                          bool                                is_cgb_device)
+    : m_clock(clock)
 {
+    reset(std::move(cart_rom), is_cgb_device);
+}
+
+void age::gb_memory::reset(std::shared_ptr<const uint8_vector> shared_cart_rom, bool is_cgb_device)
+{
+    m_num_cart_rom_banks = get_num_cart_rom_banks(*shared_cart_rom);
+    m_num_cart_ram_banks = get_num_cart_ram_banks(*shared_cart_rom);
+    m_has_battery        = has_battery(*shared_cart_rom);
+    m_cart_ram_offset    = 0;
+    m_work_ram_offset    = m_cart_ram_offset + m_num_cart_ram_banks * gb_cart_ram_bank_size;
+    m_video_ram_offset   = m_work_ram_offset + gb_work_ram_size;
+    m_cart_rom           = std::move(shared_cart_rom);
+
+    m_cart_ram_enabled = false;
+    m_svbk             = 0xF8;
+    m_vbk              = 0xF8;
+    m_mbc_data         = gb_mbc_data{};
+    m_offsets          = {};
+    m_dirty_ram_pages.reset();
+
     assert(m_num_cart_rom_banks > 0);
     assert(m_num_cart_ram_banks >= 0);
-    assert(m_cart_ram_offset > 0);
     assert(m_work_ram_offset >= m_cart_ram_offset);
     assert(m_video_ram_offset > m_work_ram_offset);
 
+    const uint8_vector& cart_rom = *m_cart_rom;
+
     switch (safe_get(cart_rom, gb_cia_ofs_type))
     {
         default:
@@ -309,18 +326,23 @@ age::gb_memory::gb_memory(const uint8_vector& cart_rom, const gb_clock& clock, b
     write_svbk(0);
 
     // allocate memory
-    int cart_rom_size = m_num_cart_rom_banks * gb_cart_rom_bank_size;
     int cart_ram_size = m_num_cart_ram_banks * gb_cart_ram_bank_size;
-    int memory_size   = cart_rom_size + cart_ram_size + gb_work_ram_size + gb_video_ram_size;
+    int memory_size   = cart_ram_size + gb_work_ram_size + gb_video_ram_size;
     assert(memory_size > 0);
 
     log() << "allocating " << memory_size << " bytes total";
-    m_memory = uint8_vector(static_cast<unsigned>(memory_size), 0);
+    m_memory.assign(static_cast<unsigned>(memory_size), 0); // reuses the vector's capacity
 
-    // copy rom
-    int copy_rom_bytes = std::min(cart_rom_size, static_cast<int>(cart_rom.size()));
-    log() << "copying " << copy_rom_bytes << " bytes of cartridge rom (rom size is " << cart_rom.size() << " bytes)";
-    std::copy(begin(cart_rom), begin(cart_rom) + copy_rom_bytes, begin(m_memory));
+    // copy rom, if it's smaller than specified by the cartridge header
+    // (we don't need to copy it otherwise as it's read-only)
+    int cart_rom_size = m_num_cart_rom_banks * gb_cart_rom_bank_size;
+    if (static_cast<int>(cart_rom.size()) < cart_rom_size)
+    {
+        log() << "copying " << cart_rom.size() << " bytes of cartridge rom (rom size is " << cart_rom_size << " bytes)";
+        auto padded_rom = std::make_shared<uint8_vector>(static_cast<unsigned>(cart_rom_size), 0);
+        std::copy(begin(cart_rom), end(cart_rom), begin(*padded_rom));
+        m_cart_rom = padded_rom;
+    }
 
     // init vram
     for (uint16_t i = 0, end = gb_sparse_vram_0010_dump.size(); i < end; ++i)
@@ -433,6 +433,28 @@ void age::gb_sound::generate_samples(int for_clk)
     }
     m_clk_current_state += samples_to_generate * 2;
 
+    // just update the channel states, if samples are not required
+    if (!m_samples_enabled)
+    {
+        if (m_master_on)
+        {
+            if (m_c1.active())
+            {
+                m_c1.skip_samples(samples_to_generate);
+            }
+            if (m_c2.active())
+            {
+                m_c2.skip_samples(samples_to_generate);
+            }
+            m_c3.skip_samples(samples_to_generate); // see the todo below
+            if (m_c4.active())
+            {
+                m_c4.skip_samples(samples_to_generate);
+            }
+        }
+        return;
+    }
+
     // allocate silence
     assert(m_samples.size() <= int_max);
     int sample_index = static_cast<int>(m_samples.size());
@@ -464,6 +486,13 @@ void age::gb_sound::generate_samples(int for_clk)
 
 
 
+void age::gb_sound::set_samples_enabled(bool samples_enabled)
+{
+    m_samples_enabled = samples_enabled;
+}
+
+
+
 void age::gb_sound::set_wave_ram_byte(unsigned offset, uint8_t value)
 {
     m_c3_wave_ram[offset] = value;
@@ -485,12 +514,46 @@ age::gb_sound::gb_sound(const gb_device& device,
                         pcm_vector&      samples)
     : gb_sound_logger(device, clock, clock.get_clock_cycle()),
       m_samples(samples),
-      m_device(device),
-      // initialize frame sequencer
-      // (see test rom analysis)
-      m_clk_next_apu_event((m_clk_current_state / gb_apu_event_clock_cycles + 1) * gb_apu_event_clock_cycles),
-      m_next_frame_sequencer_step(m_device.cgb_mode() ? 0 : 1)
+      m_device(device)
 {
+    reset();
+}
+
+void age::gb_sound::reset()
+{
+    m_clk_current_state = m_clock.get_clock_cycle();
+    m_samples_enabled   = true;
+
+    // initialize frame sequencer
+    // (see test rom analysis)
+    m_clk_bits_apu_on           = 0;
+    m_clk_next_apu_event        = (m_clk_current_state / gb_apu_event_clock_cycles + 1) * gb_apu_event_clock_cycles;
+    m_next_frame_sequencer_step = m_device.cgb_mode() ? 0 : 1;
+    m_current_ds_delay          = 0;
+    m_delayed_disable_c1        = false;
+    m_skip_frame_sequencer_step = false;
+
+    m_nr50      = 0x77;
+    m_nr51      = 0xF3;
+    m_master_on = true;
+
+    m_nr10 = 0;
+    m_nr11 = 0x80;
+    m_nr14 = 0;
+    m_c1   = gb_sound_channel1{0x3F, this};
+
+    m_nr21 = 0;
+    m_nr24 = 0;
+    m_c2   = gb_sound_channel2{0x3F, this};
+
+    m_nr30 = 0;
+    m_nr32 = 0;
+    m_nr34 = 0;
+    m_c3   = gb_sound_channel3{0xFF, this};
+
+    m_nr44 = 0;
+    m_c4   = gb_sound_channel4{0x3F, this};
+
     log() << "first frame sequencer step (" << log_dec(m_next_frame_sequencer_step)
           << ") at clock cycle " << m_clk_next_apu_event;
 
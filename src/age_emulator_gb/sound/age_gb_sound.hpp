@@ -56,6 +56,8 @@ namespace age
         gb_sound(const gb_device& device, const gb_clock& clock, pcm_vector& samples);
         ~gb_sound() = default;
 
+        void reset();
+
         [[nodiscard]] uint8_t read_nr10() const;
         [[nodiscard]] uint8_t read_nr11() const;
         [[nodiscard]] uint8_t read_nr12() const;
@@ -105,6 +107,9 @@ namespace age
         void after_speed_change();
         void set_back_clock(int clock_cycle_offset);
 
+        //! If disabled, the sound state is still updated but no samples are generated.
+        void set_samples_enabled(bool samples_enabled);
+
 
 
     private:
@@ -116,6 +121,7 @@ namespace age
         void               set_wave_ram_byte(unsigned offset, uint8_t value);
 
         pcm_vector& m_samples;
+        bool        m_samples_enabled = true;
 
         const gb_device& m_device;
         int              m_clk_bits_apu_on           = 0;
@@ -76,6 +76,32 @@ namespace age
             assert(m_frequency_timer > 0);
         }
 
+        //!
+        //! Update the channel state like generate_samples() does,
+        //! but without writing any samples.
+        //!
+        void skip_samples(int samples_to_skip)
+        {
+            assert(samples_to_skip > 0);
+            assert(m_frequency_timer_period > 0);
+            assert(m_frequency_timer >= 0);
+
+            for (int samples_remaining = samples_to_skip; samples_remaining > 0;)
+            {
+                int samples = std::min(samples_remaining, m_frequency_timer);
+                samples_remaining -= samples;
+                m_frequency_timer -= samples;
+
+                if (m_frequency_timer == 0)
+                {
+                    m_frequency_timer = m_frequency_timer_period;
+                    set_current_pcm_amplitude(static_cast<DerivedClass*>(this)->next_pcm_amplitude());
+                }
+            }
+
+            assert(m_frequency_timer > 0);
+        }
+
         void delay_one_sample()
         {
             assert(m_frequency_timer > 0);
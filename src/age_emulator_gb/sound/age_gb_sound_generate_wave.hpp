@@ -118,6 +118,13 @@ namespace age
             m_wave_ram_just_read &= gb_sample_generator<gb_wave_generator<ChannelId>>::frequency_timer_just_reloaded();
         }
 
+        void skip_samples(int samples_to_skip)
+        {
+            m_wave_ram_just_read = false;
+            gb_sample_generator<gb_wave_generator<ChannelId>>::skip_samples(samples_to_skip);
+            m_wave_ram_just_read &= gb_sample_generator<gb_wave_generator<ChannelId>>::frequency_timer_just_reloaded();
+        }
+
 
 
     private:
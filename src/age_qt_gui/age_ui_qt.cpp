@@ -68,6 +68,7 @@ QString age::get_name_for_qt_downsampler_quality(qt_downsampler_quality quality)
         case qt_downsampler_quality::low: result = qt_downsampler_quality_low; break;
         case qt_downsampler_quality::high: result = qt_downsampler_quality_high; break;
         case qt_downsampler_quality::highest: result = qt_downsampler_quality_highest; break;
+        case qt_downsampler_quality::multistage: result = qt_downsampler_quality_multistage; break;
     }
 
     return result;
@@ -87,6 +88,10 @@ age::qt_downsampler_quality age::get_qt_downsampler_quality_for_name(const QStri
     {
         result = qt_downsampler_quality::highest;
     }
+    else if (0 == name.compare(qt_downsampler_quality_multistage, Qt::CaseInsensitive))
+    {
+        result = qt_downsampler_quality::multistage;
+    }
     else
     {
         result = qt_downsampler_quality::high; // default
@@ -21,6 +21,7 @@
 //! \file
 //!
 
+#include <array>
 #include <ostream>
 #include <string>
 
@@ -67,6 +68,34 @@ namespace age
 
 
 
+    //---------------------------------------------------------
+    //
+    //   emulation
+    //
+    //---------------------------------------------------------
+
+    //!
+    //! \brief The fast-forward speed multiplier for running the emulation
+    //! as fast as possible.
+    //!
+    //! A speed multiplier of 1 disables fast-forwarding.
+    //!
+    constexpr int qt_fast_forward_unbounded = 0;
+
+    //!
+    //! \brief The (exclusive) upper bounds in microseconds of the
+    //! frame jitter histogram's buckets.
+    //!
+    //! The frame jitter is the delay between a frame's scheduled start
+    //! and the actual start of its emulation.
+    //! An additional last bucket counts all frames delayed by at least
+    //! the last bound.
+    //!
+    constexpr std::array<int, 5> qt_frame_jitter_bucket_micros = {50, 100, 250, 500, 1000};
+    constexpr int                qt_frame_jitter_buckets       = static_cast<int>(qt_frame_jitter_bucket_micros.size()) + 1;
+
+
+
     //---------------------------------------------------------
     //
     //   audio
@@ -77,7 +106,8 @@ namespace age
     {
         low,
         high,
-        highest
+        highest,
+        multistage
     };
 
     //!
@@ -94,9 +124,18 @@ namespace age
     static_assert((qt_audio_latency_milliseconds_min % qt_audio_latency_milliseconds_step) == 0, "audio latency step size does not match");
     static_assert((qt_audio_latency_milliseconds_max % qt_audio_latency_milliseconds_step) == 0, "audio latency step size does not match");
 
-    constexpr const char* qt_downsampler_quality_low     = "low";
-    constexpr const char* qt_downsampler_quality_high    = "high";
-    constexpr const char* qt_downsampler_quality_highest = "highest";
+    //!
+    //! \brief The maximal deviation from the nominal audio resampling ratio
+    //! used to keep the audio buffer at its target fill level.
+    //!
+    //! A pitch change of 0.5% is not noticeable.
+    //!
+    constexpr double qt_audio_max_rate_correction = 0.005;
+
+    constexpr const char* qt_downsampler_quality_low        = "low";
+    constexpr const char* qt_downsampler_quality_high       = "high";
+    constexpr const char* qt_downsampler_quality_highest    = "highest";
+    constexpr const char* qt_downsampler_quality_multistage = "multistage";
 
     QString                get_name_for_qt_downsampler_quality(qt_downsampler_quality quality);
     qt_downsampler_quality get_qt_downsampler_quality_for_name(const QString& quality);
@@ -17,11 +17,77 @@
 #include "age_ui_qt_audio.hpp"
 
 #include <cassert>
+#include <cstring> // memcpy, memset
 
 constexpr int sizeof_pcm_frame = sizeof(age::pcm_frame);
 
 
 
+//---------------------------------------------------------
+//
+//   qt_audio_pull_device
+//
+//---------------------------------------------------------
+
+age::qt_audio_pull_device::qt_audio_pull_device(QSharedPointer<pcm_spsc_ring_buffer> buffer, int refill_samples)
+    : m_buffer(std::move(buffer)),
+      m_refill_samples(refill_samples)
+{
+    assert(m_buffer != nullptr);
+    assert(m_refill_samples <= m_buffer->get_capacity());
+}
+
+bool age::qt_audio_pull_device::isSequential() const
+{
+    return true;
+}
+
+qint64 age::qt_audio_pull_device::bytesAvailable() const
+{
+    // we play silence if the ring buffer runs empty
+    return QIODevice::bytesAvailable() + qint64{m_buffer->get_capacity()} * sizeof_pcm_frame;
+}
+
+qint64 age::qt_audio_pull_device::readData(char* data, qint64 max_size)
+{
+    assert(max_size >= 0);
+    int samples_requested = static_cast<int>(qMin(max_size / sizeof_pcm_frame, qint64{int_max}));
+
+    // wait for the ring buffer to fill up after a buffer underflow
+    if (m_refilling && (m_buffer->get_buffered_samples() >= m_refill_samples))
+    {
+        m_refilling = false;
+    }
+
+    int samples_read = 0;
+    if (!m_refilling)
+    {
+        auto spans = m_buffer->get_buffered_samples_spans();
+        for (auto span : {spans.m_first, spans.m_second})
+        {
+            int samples = qMin(static_cast<int>(span.size()), samples_requested - samples_read);
+            memcpy(data + qint64{samples_read} * sizeof_pcm_frame, span.data(), static_cast<size_t>(samples) * sizeof_pcm_frame);
+            samples_read += samples;
+        }
+        m_buffer->discard_buffered_samples(samples_read);
+
+        // buffer underflow?
+        m_refilling = samples_read < samples_requested;
+    }
+
+    // play silence for missing samples
+    memset(data + qint64{samples_read} * sizeof_pcm_frame, 0, static_cast<size_t>(samples_requested - samples_read) * sizeof_pcm_frame);
+
+    return qint64{samples_requested} * sizeof_pcm_frame;
+}
+
+qint64 age::qt_audio_pull_device::writeData(const char* /*data*/, qint64 /*max_size*/)
+{
+    return -1; // read only
+}
+
+
+
 //---------------------------------------------------------
 //
 //   object creation/destruction
@@ -64,6 +130,21 @@ age::size_t age::qt_audio_output::get_downsampler_fir_size() const
     return m_downsampler_fir_size;
 }
 
+int age::qt_audio_output::get_achieved_latency_milliseconds() const
+{
+    if (m_sink == nullptr)
+    {
+        return 0;
+    }
+    double samples = m_average_buffered_samples + m_device_samples;
+    return qRound(samples * 1000 / m_sink->format().sampleRate());
+}
+
+double age::qt_audio_output::get_rate_correction() const
+{
+    return m_rate_correction;
+}
+
 
 
 void age::qt_audio_output::set_volume(int volume_percent)
@@ -118,57 +199,10 @@ void age::qt_audio_output::buffer_samples(const pcm_vector& samples)
         assert(m_downsampler != nullptr);
 
         m_downsampler->add_input_samples(samples);
-        m_buffer.add_samples(m_downsampler->get_output_samples());
+        m_buffer->add_samples(m_downsampler->get_output_samples());
         m_downsampler->clear_output_samples();
-    }
-}
-
-void age::qt_audio_output::buffer_silence()
-{
-    if (m_sink != nullptr)
-    {
-        int bytes_free = m_sink->bytesFree();
-
-        if (bytes_free > 0)
-        {
-            int samples_free = bytes_free / sizeof_pcm_frame;
-
-            if (m_buffer.get_buffered_samples() < samples_free)
-            {
-                int samples_to_add = samples_free - m_buffer.get_buffered_samples();
-                m_buffer.add_samples(m_silence, samples_to_add);
-            }
-        }
-    }
-}
-
-void age::qt_audio_output::stream_audio_data()
-{
-    if (m_sink != nullptr)
-    {
-        // wait for ring buffer to fill up on buffer underflow
-        if (m_sink->bytesFree() == m_sink->bufferSize())
-        {
-            if (m_buffer.get_buffered_samples() == m_buffer.get_max_buffered_samples())
-            {
-                m_pause_streaming = false;
-            }
-            else if (!m_pause_streaming)
-            {
-                m_pause_streaming = true;
-            }
-        }
 
-        // stream to audio output device
-        // (call write_samples twice in case of a ring buffer wrap around)
-        if (!m_pause_streaming)
-        {
-            int samples_written = write_samples();
-            if (samples_written > 0)
-            {
-                write_samples();
-            }
-        }
+        update_rate_correction();
     }
 }
 
@@ -189,38 +223,44 @@ void age::qt_audio_output::reset()
 
         m_downsampler = nullptr;
         m_sink        = nullptr;
-        m_io_device   = nullptr;
+        m_pull_device = nullptr;
+        m_buffer      = nullptr;
     }
+    m_device_samples           = 0;
+    m_target_buffered_samples  = 0;
+    m_average_buffered_samples = 0;
+    m_rate_correction          = 1;
 
     // create a new audio output device
     if (!m_device.isNull() && m_format.isValid())
     {
         m_sink = QSharedPointer<QAudioSink>(new QAudioSink(m_device, m_format));
 
-        // set the audio output buffer size
+        // Split the latency between the audio output buffer and the ring buffer:
+        // the audio output buffer is refilled from the ring buffer whenever
+        // it runs low, which is independent of the emulation timer.
         int sample_rate = m_sink->format().sampleRate();
 
-        int buffered_samples = m_latency_milliseconds * sample_rate / 1000;
-        int buffered_bytes   = buffered_samples * sizeof_pcm_frame;
+        int latency_samples = m_latency_milliseconds * sample_rate / 1000;
+        m_device_samples    = latency_samples / 2;
+        m_sink->setBufferSize(m_device_samples * sizeof_pcm_frame);
 
-        m_sink->setBufferSize(buffered_bytes);
+        // The ring buffer can store the whole latency,
+        // additional samples are dropped.
+        // Dynamic rate control keeps it filled at the remaining latency.
+        m_target_buffered_samples  = latency_samples - m_device_samples;
+        m_average_buffered_samples = m_target_buffered_samples;
+        assert(m_target_buffered_samples > 0);
 
-        // adjust the ring buffer
-        if (buffered_samples != m_buffer.get_max_buffered_samples())
-        {
-            m_buffer = pcm_ring_buffer(buffered_samples);
-        }
-        m_buffer.set_to(pcm_frame());
+        m_buffer      = QSharedPointer<pcm_spsc_ring_buffer>::create(latency_samples);
+        m_pull_device = QSharedPointer<qt_audio_pull_device>::create(m_buffer, m_target_buffered_samples);
+        m_pull_device->open(QIODevice::ReadOnly);
 
         // create a new downsampler
         create_downsampler();
 
         // Start the new audio output device.
-        m_io_device = m_sink->start();
-
-        // create the silence buffer
-        assert(buffered_samples >= 0);
-        m_silence = pcm_vector(static_cast<unsigned>(buffered_samples), pcm_frame());
+        m_sink->start(m_pull_device.data());
     }
 }
 
@@ -241,14 +281,21 @@ void age::qt_audio_output::create_downsampler()
                 break;
 
             case qt_downsampler_quality::high: {
-                auto* ds               = new downsampler_kaiser_low_pass(m_input_sampling_rate, output_sample_rate, 0.1);
+                auto* ds               = new downsampler_polyphase(m_input_sampling_rate, output_sample_rate, 0.1);
                 m_downsampler_fir_size = ds->get_fir_size();
                 d                      = ds;
                 break;
             }
 
             case qt_downsampler_quality::highest: {
-                auto* ds               = new downsampler_kaiser_low_pass(m_input_sampling_rate, output_sample_rate, 0.01);
+                auto* ds               = new downsampler_polyphase(m_input_sampling_rate, output_sample_rate, 0.01);
+                m_downsampler_fir_size = ds->get_fir_size();
+                d                      = ds;
+                break;
+            }
+
+            case qt_downsampler_quality::multistage: {
+                auto* ds               = new downsampler_multistage(m_input_sampling_rate, output_sample_rate, 0.001);
                 m_downsampler_fir_size = ds->get_fir_size();
                 d                      = ds;
                 break;
@@ -257,43 +304,29 @@ void age::qt_audio_output::create_downsampler()
 
         m_downsampler = QSharedPointer<downsampler>(d);
         m_downsampler->set_volume(m_volume);
+        m_downsampler->set_ratio_correction(m_rate_correction);
     }
 }
 
-int age::qt_audio_output::write_samples()
-{
-    assert(m_sink != nullptr);
-
-    int samples_written = 0;
-
-    // don't try to write samples, if no audio device has been opened
-    // (may happen, if there is no audio device available)
-    if (m_io_device != nullptr)
-    {
-        // check how many samples we can stream to the audio output device
-        int bytes_free = m_sink->bytesFree();
-        if (bytes_free > 0)
-        {
-            int samples_free = bytes_free / sizeof_pcm_frame;
 
-            // check how many samples we have available for streaming
-            int              samples_available = 0;
-            const pcm_frame* buffer            = m_buffer.get_buffered_samples_ptr(samples_available);
 
-            // write samples to audio output device
-            int         samples_to_write = qMin(samples_available, samples_free);
-            const char* char_buffer      = reinterpret_cast<const char*>(buffer);
+void age::qt_audio_output::update_rate_correction()
+{
+    assert(m_target_buffered_samples > 0);
 
-            qint64 bytes_written = m_io_device->write(char_buffer, samples_to_write * sizeof_pcm_frame);
+    // The ring buffer is filled and drained in chunks
+    // (emulation timer, audio output device period),
+    // so we smooth its fill level before comparing it to the target.
+    constexpr double smoothing = 1.0 / 32;
 
-            // calculate the number of samples that were written
-            qint64 tmp = bytes_written / sizeof_pcm_frame;
-            assert((tmp >= 0) && (tmp <= samples_to_write));
-            samples_written = static_cast<int>(tmp);
+    int buffered_samples = m_buffer->get_buffered_samples();
+    m_average_buffered_samples += (buffered_samples - m_average_buffered_samples) * smoothing;
 
-            m_buffer.discard_buffered_samples(samples_written);
-        }
-    }
+    // An empty ring buffer results in the maximal number of output samples,
+    // a ring buffer filled at twice the target results in the minimal
+    // number of output samples.
+    double deviation  = (m_average_buffered_samples - m_target_buffered_samples) / m_target_buffered_samples;
+    m_rate_correction = 1 + qBound(-1.0, deviation, 1.0) * qt_audio_max_rate_correction;
 
-    return samples_written;
+    m_downsampler->set_ratio_correction(m_rate_correction);
 }
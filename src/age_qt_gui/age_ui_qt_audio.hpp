@@ -30,7 +30,7 @@
 #include <age_types.hpp>
 #include <pcm/age_downsampler.hpp>
 #include <pcm/age_pcm_frame.hpp>
-#include <pcm/age_pcm_ring_buffer.hpp>
+#include <pcm/age_pcm_spsc_ring_buffer.hpp>
 
 #include "age_ui_qt.hpp"
 
@@ -39,6 +39,40 @@
 namespace age
 {
 
+    //!
+    //! \brief A QIODevice the QAudioSink pulls audio data from.
+    //!
+    //! Audio data is read from a pcm_spsc_ring_buffer,
+    //! which may be filled by a different thread.
+    //! On buffer underflow silence is played until the ring buffer has
+    //! been filled up to the specified number of samples again.
+    //! By enforcing the audio latency in that way the probability of
+    //! multiple concurrent buffer underflows is reduced.
+    //!
+    class qt_audio_pull_device : public QIODevice
+    {
+        AGE_DISABLE_COPY(qt_audio_pull_device);
+        AGE_DISABLE_MOVE(qt_audio_pull_device);
+
+    public:
+        qt_audio_pull_device(QSharedPointer<pcm_spsc_ring_buffer> buffer, int refill_samples);
+        ~qt_audio_pull_device() override = default;
+
+        [[nodiscard]] bool   isSequential() const override;
+        [[nodiscard]] qint64 bytesAvailable() const override;
+
+    protected:
+        qint64 readData(char* data, qint64 max_size) override;
+        qint64 writeData(const char* data, qint64 max_size) override;
+
+    private:
+        QSharedPointer<pcm_spsc_ring_buffer> m_buffer;
+        const int                            m_refill_samples;
+        bool                                 m_refilling = true;
+    };
+
+
+
     //!
     //! \brief The qt_audio_output class can be used for easily configurable audio streaming.
     //!
@@ -52,9 +86,9 @@ namespace age
     //! - audio output format: set_output()
     //!
     //! Before any audio streaming is possible, set_device() must be called at least once.
-    //! The audio stream must be kept alive by regular stream_audio_data() calls.
-    //! The underlying QAudioSink object is used in "push mode" (by not specifying any
-    //! QIODevice when calling QAudioSink::start()).
+    //! The underlying QAudioSink object is used in "pull mode":
+    //! it reads audio data from a qt_audio_pull_device whenever it needs to,
+    //! independently of buffer_samples() calls.
     //!
     class qt_audio_output
     {
@@ -95,6 +129,22 @@ namespace age
         //!
         [[nodiscard]] size_t get_downsampler_fir_size() const;
 
+        //!
+        //! \brief Get the audio latency currently achieved by dynamic rate control.
+        //! \return The average number of buffered milliseconds (intermediate
+        //! buffer and audio output device buffer) or zero, if there is no
+        //! audio output device.
+        //!
+        [[nodiscard]] int get_achieved_latency_milliseconds() const;
+
+        //!
+        //! \brief Get the factor currently applied to the downsampler's
+        //! input/output sampling rate ratio by dynamic rate control.
+        //! \return The current correction factor in the range
+        //! [1 - age::qt_audio_max_rate_correction; 1 + age::qt_audio_max_rate_correction].
+        //!
+        [[nodiscard]] double get_rate_correction() const;
+
 
 
         //!
@@ -164,47 +214,24 @@ namespace age
         //! \brief Copy the audio data specified as {@link pcm_frame}s
         //! to the intermediate buffer.
         //!
-        //! To stream audio data from the intermediate buffer to the audio output
-        //! device, call stream_audio_data().
+        //! The audio output device reads audio data from the intermediate
+        //! buffer on its own.
+        //! If the intermediate buffer runs empty (e.g. because the emulation
+        //! is paused), silence is played.
+        //!
+        //! To prevent the intermediate buffer from running empty or
+        //! overflowing, the downsampler's input/output sampling rate ratio
+        //! is adjusted slightly based on the buffer's fill level
+        //! (dynamic rate control).
         //!
         //! \param samples The {@link pcm_frame}s to be buffered.
         //!
         void buffer_samples(const pcm_vector& samples);
 
-        //!
-        //! \brief Copy a specific amount of silent {@link pcm_frame}s
-        //! to the intermediate buffer.
-        //!
-        //! The amount of silent samples copied is calculated automatically, so that
-        //! afterwards the intermediate buffer contains enough samples to completely
-        //! fill the audio output device's buffer.
-        //!
-        //! To stream audio data from the intermediate buffer to the audio output
-        //! device, call stream_audio_data().
-        //!
-        void buffer_silence();
-
-        //!
-        //! \brief Stream buffered audio data to the audio device.
-        //!
-        //! This method must be called regularly to keep the audio stream running.
-        //! If a buffer underflow occurs on the audio device's buffer (which may produce
-        //! some audible crack noise), streaming will be paused until the intermediate
-        //! buffer is filled completely.
-        //! By enforcing the audio latency in that way the probability of multiple
-        //! concurrent buffer underflows is reduced.
-        //!
-        //! To add new audio data to the intermediate buffer, call buffer_samples()
-        //! or buffer_silence().
-        //!
-        void stream_audio_data();
-
-
-
     private:
         void reset();
         void create_downsampler();
-        int  write_samples();
+        void update_rate_correction();
 
         int                    m_input_sampling_rate  = 200000; // some (arbitrary) big value
         float                  m_volume               = 1;
@@ -213,13 +240,16 @@ namespace age
         QAudioDevice           m_device;
         QAudioFormat           m_format;
 
-        QSharedPointer<downsampler> m_downsampler;
-        size_t                      m_downsampler_fir_size = 0;
-        pcm_ring_buffer             m_buffer{1};
-        QSharedPointer<QAudioSink>  m_sink;
-        QIODevice*                  m_io_device = nullptr;
-        pcm_vector                  m_silence;
-        bool                        m_pause_streaming = false;
+        QSharedPointer<downsampler>          m_downsampler;
+        size_t                               m_downsampler_fir_size = 0;
+        QSharedPointer<pcm_spsc_ring_buffer> m_buffer;
+        QSharedPointer<qt_audio_pull_device> m_pull_device;
+        QSharedPointer<QAudioSink>           m_sink;
+
+        int    m_device_samples           = 0; //!< samples buffered by the audio output device
+        int    m_target_buffered_samples  = 0; //!< intermediate buffer fill level to converge to
+        double m_average_buffered_samples = 0;
+        double m_rate_correction          = 1;
     };
 
 } // namespace age
@@ -16,22 +16,47 @@
 
 #include "age_ui_qt_emulation_runner.hpp"
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <utility> // std::move
 
 namespace
 {
+    // used while there is nothing to emulate,
+    // e.g. to check for modified audio settings
+    constexpr int idle_interval_millis = 8;
 
-    constexpr int    emulation_interval_millis = 8;
-    constexpr qint64 emulation_interval_nanos  = emulation_interval_millis * 1000000;
+    static_assert(idle_interval_millis > 0, "the idle interval must be greater than zero");
 
-    static_assert(emulation_interval_millis > 0, "the emulation interval must be greater than zero");
+    // The timer wakes us up this early (at least),
+    // the rest of the time until the next frame is spent busy waiting.
+    constexpr qint64 frame_spin_nanos = 1000000;
+
+    // Restart frame pacing if we are lagging behind by this many frames
+    // (e.g. because the CPU cannot keep up),
+    // instead of trying to catch up.
+    constexpr qint64 max_frames_behind = 3;
+
+    // used to emulate the end of a frame line by line
+    constexpr int lcd_lines_per_frame = 154;
 
     constexpr qint64 emulation_speed_interval_nanos = 1000000000 / age::stats_per_second;
 
+    // Save modified persistent ram periodically,
+    // so that we don't lose too much progress in case of a crash.
+    constexpr qint64 ram_save_interval_nanos = qint64{5} * 1000000000;
+
+    //! real time duration of one emulated frame (at normal speed)
+    qint64 get_frame_nanos(const age::gb_emulator& emu)
+    {
+        return qint64{emu.get_cycles_per_frame()} * 1000000000 / emu.get_cycles_per_second();
+    }
+
 
 
     std::string category_str(age::gb_log_category category)
@@ -102,8 +127,10 @@ namespace
 //
 //---------------------------------------------------------
 
-age::qt_emulation_runner::qt_emulation_runner()
+age::qt_emulation_runner::qt_emulation_runner(QSharedPointer<frame_pool> pool)
+    : m_frame_pool(std::move(pool))
 {
+    assert(m_frame_pool != nullptr);
     m_timer.start();
 }
 
@@ -132,9 +159,11 @@ void age::qt_emulation_runner::initialize()
     m_emulation_event_trigger = new QTimer(this);
     connect(m_emulation_event_trigger, &QTimer::timeout, this, &qt_emulation_runner::continue_emulation);
 
-    // start continuous emulation
+    // start continuous emulation,
+    // the timer is restarted for every frame
     m_emulation_event_trigger->setTimerType(Qt::PreciseTimer); // if possible, use millisecond accuracy
-    m_emulation_event_trigger->start(emulation_interval_millis);
+    m_emulation_event_trigger->setSingleShot(true);
+    m_emulation_event_trigger->start(idle_interval_millis);
 }
 
 
@@ -148,12 +177,17 @@ void age::qt_emulation_runner::set_emulator(QSharedPointer<qt_emulator> new_emul
     m_audio_output.set_input_sampling_rate(emu->get_pcm_sampling_rate());
     emit_audio_output_activated();
 
-    m_last_emulate_nanos = m_speed_last_nanos = m_timer.nsecsElapsed();
+    m_speed_last_nanos = m_ram_saved_nanos = m_timer.nsecsElapsed();
     m_emulated_cycles = m_speed_last_cycles = 0;
+    restart_frame_pacing();
+
+    // don't mix frame pacing stats of different emulators
+    m_frame_pacing = {};
 
     m_emulator     = new_emulator;
     m_buttons_down = 0;
     m_buttons_up   = 0;
+    apply_fast_forward(*emu);
 }
 
 void age::qt_emulation_runner::set_emulator_buttons_down(int buttons)
@@ -173,7 +207,22 @@ void age::qt_emulation_runner::set_emulator_synchronize(bool synchronize)
     if (m_synchronize != synchronize)
     {
         m_synchronize = synchronize;
-        set_emulation_timer_interval();
+        restart_frame_pacing();
+    }
+}
+
+void age::qt_emulation_runner::set_emulator_fast_forward(int speed_multiplier)
+{
+    assert(speed_multiplier >= 0);
+    if (m_fast_forward != speed_multiplier)
+    {
+        m_fast_forward = speed_multiplier;
+        restart_frame_pacing();
+
+        if (m_emulator != nullptr)
+        {
+            apply_fast_forward(*m_emulator->get_emulator());
+        }
     }
 }
 
@@ -189,10 +238,9 @@ void age::qt_emulation_runner::set_emulator_paused(bool paused)
         }
         else
         {
-            m_last_emulate_nanos = m_speed_last_nanos = m_timer.nsecsElapsed();
+            m_speed_last_nanos = m_timer.nsecsElapsed();
+            restart_frame_pacing();
         }
-
-        set_emulation_timer_interval();
     }
 }
 
@@ -259,8 +307,8 @@ void age::qt_emulation_runner::continue_emulation()
     }
 
     // run the emulation, if we have an emulator available
-    bool buffer_audio_silence = true;
-
+    // (the audio output plays silence if no new audio data is available,
+    // e.g. because the emulation is paused)
     if (m_emulator != nullptr)
     {
         auto emu = m_emulator->get_emulator();
@@ -272,23 +320,23 @@ void age::qt_emulation_runner::continue_emulation()
         // run the emulation, if we're not paused
         if (!m_paused)
         {
-            emulate(emu);
-            buffer_audio_silence = false;
+            emulate_frame(emu);
         }
 
         // handle "button up" events even when paused
         emu->set_buttons_up(m_buttons_up);
         m_buttons_up = 0;
-    }
 
-    // Keep the audio stream alive. If no new audio data is available
-    // (e.g. because the emulation is paused), allow silent samples
-    // to be streamed.
-    if (buffer_audio_silence)
-    {
-        m_audio_output.buffer_silence();
+        // the persistent ram is written in the background
+        qint64 current_nanos = m_timer.nsecsElapsed();
+        if (current_nanos - m_ram_saved_nanos >= ram_save_interval_nanos)
+        {
+            m_emulator->save_persistent_ram();
+            m_ram_saved_nanos = current_nanos;
+        }
     }
-    m_audio_output.stream_audio_data();
+
+    schedule_next_frame();
 }
 
 
@@ -299,40 +347,46 @@ void age::qt_emulation_runner::continue_emulation()
 //
 //---------------------------------------------------------
 
-void age::qt_emulation_runner::emulate(QSharedPointer<gb_emulator> emu)
+void age::qt_emulation_runner::emulate_frame(QSharedPointer<gb_emulator> emu)
 {
-    qint64 current_timer_nanos = m_timer.nsecsElapsed();
-    qint64 timer_nanos_elapsed = current_timer_nanos - m_last_emulate_nanos;
-
-    // Calculate the number of nanoseconds to emulate based on elapsed time.
-    // Limit the nanos to emulate in order to not stall the system if the CPU cannot keep up
-    // (allow evening out load spikes though, requiring a limit greater than emulation_interval_nanos).
-    qint64 nanos_to_emulate = m_synchronize ? timer_nanos_elapsed : qint64_max;
-    nanos_to_emulate        = qMin(nanos_to_emulate, emulation_interval_nanos * 2);
-
-    // convert nanoseconds to emulation cycles
-    assert(qint64_max / nanos_to_emulate > emu->get_cycles_per_second());
-    qint64 cycles_to_emulate = nanos_to_emulate * emu->get_cycles_per_second() / 1000000000;
-
-    // save the nanoseconds that make up just a fraction of an emulation cycle
-    // for the next emulate() iteration
-    m_last_emulate_nanos = current_timer_nanos - (nanos_to_emulate - cycles_to_emulate * 1000000000 / emu->get_cycles_per_second());
-    assert(m_last_emulate_nanos <= current_timer_nanos);
-    assert(m_last_emulate_nanos >= current_timer_nanos - 1000000000 / emu->get_cycles_per_second() - 1);
-
-    // Calculate the number of emulation cycles we should have reached by now.
-    // Since the last call to emulator::emulate() may have emulated more cycles
-    // than requested, we have to do this to keep the emulation synchronous.
-    m_emulated_cycles += cycles_to_emulate;
-    qint64 cycles_left = m_emulated_cycles - emu->get_emulated_cycles();
-    if (cycles_left <= 0)
+    if (m_synchronize && (m_fast_forward != qt_fast_forward_unbounded))
     {
-        return;
+        // Check the timer's wakeup delay before busy waiting,
+        // which would hide it otherwise.
+        qint64 frame_start_nanos = get_frame_start_nanos(*emu);
+        qint64 current_nanos     = m_timer.nsecsElapsed();
+        qint64 delay_nanos       = qMax(qint64{0}, current_nanos - m_wakeup_nanos);
+
+        ++m_frame_pacing.m_frames;
+        m_frame_pacing.m_max_wakeup_delay_nanos = qMax(m_frame_pacing.m_max_wakeup_delay_nanos, delay_nanos);
+        if (current_nanos > frame_start_nanos)
+        {
+            ++m_frame_pacing.m_late_frames;
+        }
+
+        // busy wait for the frame to start
+        while (current_nanos < frame_start_nanos)
+        {
+            std::this_thread::yield();
+            current_nanos = m_timer.nsecsElapsed();
+        }
+
+        const auto& bounds        = qt_frame_jitter_bucket_micros;
+        qint64      jitter_micros = (current_nanos - frame_start_nanos) / 1000;
+        auto        bucket        = std::upper_bound(begin(bounds), end(bounds), jitter_micros) - begin(bounds);
+        ++m_frame_pacing.m_jitter_histogram[static_cast<size_t>(bucket)];
+
+        // don't try to catch up if we're lagging behind too much
+        qint64 frame_nanos = get_frame_nanos(*emu) / m_fast_forward;
+        if (current_nanos - frame_start_nanos > max_frames_behind * frame_nanos)
+        {
+            restart_frame_pacing();
+        }
     }
 
-    assert(cycles_left <= int_max);
-    bool new_frame = emu->emulate(static_cast<int>(cycles_left));
-    assert(emu->get_emulated_cycles() >= m_emulated_cycles);
+    // the next frame starts where this frame ends
+    bool new_frame    = emulate_to_frame_boundary(*emu);
+    m_emulated_cycles = emu->get_emulated_cycles();
 
     auto log_entries = emu->get_and_clear_log_entries();
     std::for_each(begin(log_entries),
@@ -342,15 +396,19 @@ void age::qt_emulation_runner::emulate(QSharedPointer<gb_emulator> emu)
                   });
 
     // update video & audio
-    if (new_frame)
+    if (new_frame && present_frame(*emu))
     {
-        // copy screen buffer since the emulator will overwrite it eventually
-        QSharedPointer<age::pixel_vector> screen = QSharedPointer<pixel_vector>(new pixel_vector(emu->get_screen_front_buffer()));
-        emit                              emulator_screen_updated(screen);
+        // Copy the screen buffer since the emulator will overwrite it eventually.
+        // There is no need to notify the video output again,
+        // if it did not yet take the previous frame.
+        if (m_frame_pool->publish_frame(emu->get_screen_front_buffer(), emu->get_screen_front_buffer_hash()))
+        {
+            emit emulator_screen_updated();
+        }
     }
-    m_audio_output.buffer_samples(emu->get_audio_buffer());
 
     // calculate emulation speed
+    qint64 current_timer_nanos = m_timer.nsecsElapsed();
     assert(current_timer_nanos >= m_speed_last_nanos);
     qint64 speed_diff_nanos = current_timer_nanos - m_speed_last_nanos;
 
@@ -365,6 +423,8 @@ void age::qt_emulation_runner::emulate(QSharedPointer<gb_emulator> emu)
 
         emit emulator_speed(static_cast<int>(speed_percent));
         emit emulator_milliseconds(emulated_millis);
+        emit audio_output_stats(m_audio_output.get_achieved_latency_milliseconds(), m_audio_output.get_rate_correction());
+        emit_frame_pacing_stats();
 
         m_speed_last_nanos  = current_timer_nanos;
         m_speed_last_cycles = m_emulated_cycles;
@@ -373,10 +433,131 @@ void age::qt_emulation_runner::emulate(QSharedPointer<gb_emulator> emu)
 
 
 
-void age::qt_emulation_runner::set_emulation_timer_interval()
+bool age::qt_emulation_runner::emulate_to_frame_boundary(gb_emulator& emu)
+{
+    // gb_emulator::emulate() does not stop at frame boundaries.
+    // Emulate most of the frame at once and the remaining cycles
+    // line by line until the frame id changes.
+    // If the first step already crossed the frame boundary
+    // (e.g. because the LCD has just been switched on),
+    // the next frame's first step ends closer to its boundary.
+    int      frame_cycles = emu.get_cycles_per_frame();
+    int      line_cycles  = frame_cycles / lcd_lines_per_frame;
+    unsigned frame_id     = emu.get_screen_frame_id();
+    int64_t  max_cycles   = emu.get_emulated_cycles() + 2 * frame_cycles;
+
+    int  cycles    = frame_cycles - line_cycles;
+    bool new_frame = false;
+    while (!new_frame && (emu.get_emulated_cycles() < max_cycles))
+    {
+        emu.emulate(cycles);
+        new_frame = emu.get_screen_frame_id() != frame_id;
+        cycles    = line_cycles;
+
+        // emulate() discards the previous audio samples.
+        // Audio is muted while fast-forwarding,
+        // skip buffering to not confuse the audio output's rate control.
+        if (!is_fast_forwarding())
+        {
+            m_audio_output.buffer_samples(emu.get_audio_buffer());
+        }
+    }
+    return new_frame;
+}
+
+
+
+void age::qt_emulation_runner::schedule_next_frame()
 {
-    int millis = (!m_paused && !m_synchronize) ? 0 : emulation_interval_millis;
-    m_emulation_event_trigger->setInterval(millis);
+    qint64 current_nanos = m_timer.nsecsElapsed();
+
+    // nothing to emulate
+    if ((m_emulator == nullptr) || m_paused)
+    {
+        m_emulation_event_trigger->start(idle_interval_millis);
+        m_wakeup_nanos = current_nanos + qint64{idle_interval_millis} * 1000000;
+        return;
+    }
+
+    // emulate as fast as possible
+    if (!m_synchronize || (m_fast_forward == qt_fast_forward_unbounded))
+    {
+        m_emulation_event_trigger->start(0);
+        m_wakeup_nanos = current_nanos;
+        return;
+    }
+
+    // wake up shortly before the next frame starts
+    // (we could still be handling events at that time)
+    qint64 frame_start_nanos = get_frame_start_nanos(*m_emulator->get_emulator());
+    qint64 wait_nanos        = frame_start_nanos - frame_spin_nanos - current_nanos;
+    qint64 wait_millis       = qBound(qint64{0}, wait_nanos / 1000000, qint64{1000});
+    m_emulation_event_trigger->start(static_cast<int>(wait_millis));
+    m_wakeup_nanos = current_nanos + wait_millis * 1000000;
+}
+
+void age::qt_emulation_runner::restart_frame_pacing()
+{
+    m_pacing_start_nanos  = m_timer.nsecsElapsed();
+    m_pacing_start_cycles = m_emulated_cycles;
+}
+
+void age::qt_emulation_runner::apply_fast_forward(gb_emulator& emu)
+{
+    // while fast-forwarding,
+    // frames are rendered only if they are presented (see present_frame())
+    bool fast_forward = is_fast_forwarding();
+    emu.set_screen_rendering_enabled(!fast_forward);
+    emu.set_audio_enabled(!fast_forward);
+    m_frames_to_present = 0;
+}
+
+bool age::qt_emulation_runner::is_fast_forwarding() const
+{
+    return m_fast_forward != 1;
+}
+
+bool age::qt_emulation_runner::present_frame(gb_emulator& emu)
+{
+    if (!is_fast_forwarding())
+    {
+        return true;
+    }
+
+    // present the frame we enabled rendering for
+    if (m_frames_to_present > 0)
+    {
+        --m_frames_to_present;
+        if (m_frames_to_present > 0)
+        {
+            return false;
+        }
+        emu.set_screen_rendering_enabled(false);
+        m_present_last_nanos = m_timer.nsecsElapsed();
+        return true;
+    }
+
+    // Present frames at the emulated device's frame rate.
+    // Enabling rendering takes effect with the next frame,
+    // which is finished after the current frame.
+    if (m_timer.nsecsElapsed() - m_present_last_nanos >= get_frame_nanos(emu))
+    {
+        emu.set_screen_rendering_enabled(true);
+        m_frames_to_present = 2;
+    }
+    return false;
+}
+
+qint64 age::qt_emulation_runner::get_frame_start_nanos(const gb_emulator& emu) const
+{
+    assert(m_fast_forward != qt_fast_forward_unbounded);
+
+    // The next frame starts as soon as the emulated cycles have been reached
+    // in real time (considering fast-forwarding).
+    // Calculate this relative to the start of pacing to prevent the
+    // accumulation of rounding errors.
+    auto cycles = static_cast<double>(m_emulated_cycles - m_pacing_start_cycles);
+    return m_pacing_start_nanos + qRound64(cycles * 1000000000 / emu.get_cycles_per_second() / m_fast_forward);
 }
 
 
@@ -390,3 +571,24 @@ void age::qt_emulation_runner::emit_audio_output_activated()
 
     emit audio_device_activated(device, format, buffer_size, downsampler_fir_size);
 }
+
+void age::qt_emulation_runner::emit_frame_pacing_stats()
+{
+    // nothing to report while not synchronizing
+    if (m_frame_pacing.m_frames == 0)
+    {
+        return;
+    }
+
+    auto   max_delay_micros    = static_cast<int>(qMin(m_frame_pacing.m_max_wakeup_delay_nanos / 1000, qint64{int_max}));
+    double late_frames_percent = m_frame_pacing.m_late_frames * 100.0 / m_frame_pacing.m_frames;
+
+    QList<int> jitter_histogram;
+    for (qint64 frames : m_frame_pacing.m_jitter_histogram)
+    {
+        jitter_histogram.append(static_cast<int>(qMin(frames, qint64{int_max})));
+    }
+
+    emit frame_pacing_stats(max_delay_micros, late_frames_percent, jitter_histogram);
+    m_frame_pacing = {};
+}
@@ -28,6 +28,7 @@
 #include <QTimer>
 
 #include <age_types.hpp>
+#include <gfx/age_frame_pool.hpp>
 
 #include "age_ui_qt_audio.hpp"
 #include "age_ui_qt_emulator.hpp"
@@ -42,19 +43,37 @@ namespace age
     //!
     //! This can be passed to another thread for asynchronous emulation.
     //!
+    //! The emulation is paced frame by frame:
+    //! each frame is emulated as soon as its emulated start time is reached.
+    //! Every frame is emulated up to the end of the emulated LCD frame
+    //! (see gb_emulator::get_screen_frame_id()).
+    //! A single shot timer wakes up the runner shortly before that time,
+    //! the remaining time is spent busy waiting.
+    //! The thread's event loop keeps running while the timer is active,
+    //! so that queued slot calls (e.g. button events) are not blocked.
+    //!
+    //! Emulated frames are handed to the video output through a
+    //! frame_pool, emulator_screen_updated() just notifies the video
+    //! output about a new frame.
+    //!
+    //! When fast-forwarding, only frames presented at the emulated
+    //! device's frame rate are rendered and audio is muted.
+    //!
     class qt_emulation_runner : public QObject
     {
         Q_OBJECT
         AGE_DISABLE_COPY(qt_emulation_runner);
 
     public:
-        qt_emulation_runner();
+        explicit qt_emulation_runner(QSharedPointer<frame_pool> pool);
         ~qt_emulation_runner() override;
 
     signals:
 
         void audio_device_activated(QAudioDevice device, QAudioFormat format, int buffer_size, int downsampler_fir_size);
-        void emulator_screen_updated(QSharedPointer<const pixel_vector> screen);
+        void audio_output_stats(int latency_milliseconds, double rate_correction);
+        void frame_pacing_stats(int max_wakeup_delay_microseconds, double late_frames_percent, QList<int> frame_jitter_histogram);
+        void emulator_screen_updated();
         void emulator_speed(int speed_percent);
         void emulator_milliseconds(qint64 emulated_milliseconds);
 
@@ -70,6 +89,7 @@ namespace age
 
         void set_emulator_synchronize(bool synchronize);
         void set_emulator_paused(bool paused);
+        void set_emulator_fast_forward(int speed_multiplier);
 
         void set_audio_device(QAudioDevice device, QAudioFormat format);
         void set_audio_volume(int volume_percent);
@@ -84,24 +104,50 @@ namespace age
         void continue_emulation();
 
     private:
-        void emulate(QSharedPointer<gb_emulator> emu);
-        void set_emulation_timer_interval();
-        void emit_audio_output_activated();
-
-        QTimer*       m_emulation_event_trigger = nullptr;
-        QElapsedTimer m_timer;
-        qint64        m_last_emulate_nanos = 0;
-        qint64        m_emulated_cycles    = 0;
-        qint64        m_speed_last_nanos   = 0;
-        qint64        m_speed_last_cycles  = 0;
-        bool          m_synchronize        = true;
-        bool          m_paused             = false;
+        void                 emulate_frame(QSharedPointer<gb_emulator> emu);
+        bool                 emulate_to_frame_boundary(gb_emulator& emu);
+        void                 schedule_next_frame();
+        void                 restart_frame_pacing();
+        void                 apply_fast_forward(gb_emulator& emu);
+        [[nodiscard]] bool   is_fast_forwarding() const;
+        [[nodiscard]] bool   present_frame(gb_emulator& emu);
+        [[nodiscard]] qint64 get_frame_start_nanos(const gb_emulator& emu) const;
+        void                 emit_audio_output_activated();
+        void                 emit_frame_pacing_stats();
+
+        //! frame pacing statistics since they have been emitted last
+        struct frame_pacing
+        {
+            qint64 m_frames                 = 0;
+            qint64 m_late_frames            = 0; //!< frames started late despite the timer
+            qint64 m_max_wakeup_delay_nanos = 0; //!< max. delay between scheduled and actual timer wakeup
+
+            //! frames per jitter bucket (see qt_frame_jitter_bucket_micros)
+            std::array<qint64, qt_frame_jitter_buckets> m_jitter_histogram = {};
+        };
+
+        QTimer*                   m_emulation_event_trigger = nullptr;
+        QElapsedTimer             m_timer;
+        qint64                    m_pacing_start_nanos  = 0;
+        qint64                    m_pacing_start_cycles = 0;
+        qint64                    m_emulated_cycles     = 0;
+        qint64                    m_speed_last_nanos    = 0;
+        qint64                    m_speed_last_cycles   = 0;
+        bool                      m_synchronize         = true;
+        bool                      m_paused              = false;
+        int                       m_fast_forward        = 1; //!< emulation speed multiplier
+        qint64                    m_present_last_nanos  = 0; //!< last frame presented while fast-forwarding
+        int                       m_frames_to_present   = 0; //!< finished frames to wait for until presenting
+        qint64                    m_ram_saved_nanos     = 0; //!< last periodic save of the persistent ram
+        qint64                    m_wakeup_nanos        = 0; //!< scheduled timer wakeup
+        frame_pacing              m_frame_pacing;
 
         qt_audio_output m_audio_output;
         int             m_audio_latency_milliseconds = qt_audio_latency_milliseconds_min;
         bool            m_audio_latency_changed      = false;
 
         QSharedPointer<qt_emulator> m_emulator;
+        QSharedPointer<frame_pool>  m_frame_pool;
         int                         m_buttons_down = 0;
         int                         m_buttons_up   = 0;
     };
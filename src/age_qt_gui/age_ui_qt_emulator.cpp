@@ -20,6 +20,7 @@
 #include <emulator/age_gb_emulator.hpp>
 
 #include <cassert>
+#include <chrono>
 #include <utility> // std::move
 
 #include <QVariant>
@@ -58,6 +59,9 @@ age::qt_emulator::qt_emulator(const QByteArray& rom_contents, gb_device_type dev
             uint8_vector ram_vec(ram.begin(), ram.end());
             gb_emu->set_persistent_ram(ram_vec);
         }
+
+        // keep a copy for saving modified pages later on
+        m_ram = gb_emu->get_persistent_ram();
     }
 
     // done
@@ -71,11 +75,16 @@ age::qt_emulator::~qt_emulator()
     // save persistent ram
     if (m_ram_key.length() > 0)
     {
-        uint8_vector ram = m_emulator->get_persistent_ram();
+        // wait for a pending background save to not write m_ram concurrently
+        if (m_ram_saved.valid())
+        {
+            m_ram_saved.wait();
+        }
+        m_emulator->copy_dirty_persistent_ram(m_ram);
 
-        assert(ram.size() <= int_max);
-        int         ram_size = static_cast<int>(ram.size());
-        const char* ram_data = reinterpret_cast<const char*>(ram.data());
+        assert(m_ram.size() <= int_max);
+        int         ram_size = static_cast<int>(m_ram.size());
+        const char* ram_data = reinterpret_cast<const char*>(m_ram.data());
 
         QByteArray ram_array = {ram_data, ram_size};
         m_user_value_store->set_value(m_ram_key, ram_array);
@@ -94,3 +103,42 @@ QSharedPointer<age::gb_emulator> age::qt_emulator::get_emulator()
 {
     return m_emulator;
 }
+
+
+
+void age::qt_emulator::save_persistent_ram()
+{
+    if (m_ram_key.length() == 0)
+    {
+        return;
+    }
+
+    if (m_ram_saved.valid())
+    {
+        // m_ram is still being written by the previous save,
+        // the modified pages remain dirty until the next call
+        if (m_ram_saved.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+        // The modified pages copied for the previous save are no longer
+        // marked dirty, retry writing them if the previous save failed.
+        m_ram_save_failed |= !m_ram_saved.get();
+    }
+
+    if (!m_ram_save_failed && !m_emulator->is_persistent_ram_dirty())
+    {
+        return;
+    }
+    m_emulator->copy_dirty_persistent_ram(m_ram);
+    m_ram_save_failed = false;
+
+    // m_ram is not modified until the save has finished,
+    // so we don't have to copy it
+    assert(m_ram.size() <= int_max);
+    QByteArray ram_array = QByteArray::fromRawData(reinterpret_cast<const char*>(m_ram.data()), static_cast<int>(m_ram.size()));
+
+    m_ram_saved = std::async(std::launch::async, [store = m_user_value_store, key = m_ram_key, ram_array] {
+        return store->write_value_file(key, ram_array);
+    });
+}
@@ -24,11 +24,14 @@
 #include <QByteArray>
 #include <QString>
 
+#include <age_types.hpp>
 #include <emulator/age_gb_emulator.hpp>
 #include <emulator/age_gb_types.hpp>
 
 #include "age_ui_qt_user_value_store.hpp"
 
+#include <future>
+
 
 
 namespace age
@@ -42,10 +45,24 @@ namespace age
 
         QSharedPointer<gb_emulator> get_emulator();
 
+        //!
+        //! \brief Save the persistent ram in the background, if it has been modified.
+        //!
+        //! Only modified pages are copied from the emulator.
+        //! This method must be called from the thread running the emulator.
+        //! If the previous save has not finished yet, nothing is saved
+        //! and the modifications will be saved by a later call.
+        //! If the previous save failed, it is repeated by the next call.
+        //!
+        void save_persistent_ram();
+
     private:
         QString                             m_ram_key;
         QSharedPointer<gb_emulator>         m_emulator;
         QSharedPointer<qt_user_value_store> m_user_value_store;
+        uint8_vector                        m_ram;                     //!< copy of the persistent ram, written by m_ram_saved
+        std::future<bool>                   m_ram_saved;               //!< pending background save
+        bool                                m_ram_save_failed = false; //!< m_ram has to be saved again
     };
 
 } // namespace age
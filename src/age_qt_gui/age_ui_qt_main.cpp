@@ -35,7 +35,6 @@
 Q_DECLARE_METATYPE(age::int16_t)
 Q_DECLARE_METATYPE(QSharedPointer<age::qt_emulator>)
 Q_DECLARE_METATYPE(age::qt_downsampler_quality)
-Q_DECLARE_METATYPE(QSharedPointer<const age::pixel_vector>)
 
 
 
@@ -79,7 +78,6 @@ int main(int argc, char* argv[])
     qRegisterMetaType<age::int16_t>("int16_t");
     qRegisterMetaType<QSharedPointer<age::qt_emulator>>();
     qRegisterMetaType<age::qt_downsampler_quality>();
-    qRegisterMetaType<QSharedPointer<const age::pixel_vector>>();
 
     age::qt_main_window w;
     w.show();
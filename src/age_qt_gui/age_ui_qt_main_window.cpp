@@ -49,7 +49,11 @@ age::qt_main_window::qt_main_window(QWidget* parent, Qt::WindowFlags flags)
 
     m_user_value_store = QSharedPointer<qt_user_value_store>(new qt_user_value_store());
 
-    auto* video_output = new qt_video_output(this);
+    // frames are handed from the emulation runner to the video output
+    // through the frame pool
+    auto pool = QSharedPointer<frame_pool>(new frame_pool());
+
+    auto* video_output = new qt_video_output(pool, this);
     setCentralWidget(video_output);
 
     m_settings = new qt_settings_dialog(m_user_value_store, this, Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
@@ -82,7 +86,7 @@ age::qt_main_window::qt_main_window(QWidget* parent, Qt::WindowFlags flags)
     emulator_milliseconds(0);
     fps(0);
 
-    auto* emulation_runner = new qt_emulation_runner();
+    auto* emulation_runner = new qt_emulation_runner(pool);
     emulation_runner->moveToThread(&m_emulation_runner_thread);
 
     // connect emulation runner (& thread) signals
@@ -91,6 +95,8 @@ age::qt_main_window::qt_main_window(QWidget* parent, Qt::WindowFlags flags)
     connect(&m_emulation_runner_thread, &QThread::finished, emulation_runner, &QObject::deleteLater);
 
     connect(emulation_runner, &qt_emulation_runner::audio_device_activated, m_settings, &qt_settings_dialog::audio_device_activated);
+    connect(emulation_runner, &qt_emulation_runner::audio_output_stats, m_settings, &qt_settings_dialog::audio_output_stats);
+    connect(emulation_runner, &qt_emulation_runner::frame_pacing_stats, m_settings, &qt_settings_dialog::frame_pacing_stats);
     connect(emulation_runner, &qt_emulation_runner::emulator_screen_updated, video_output, &qt_video_output::new_frame);
     connect(emulation_runner, &qt_emulation_runner::emulator_speed, this, &qt_main_window::emulator_speed);
     connect(emulation_runner, &qt_emulation_runner::emulator_milliseconds, this, &qt_main_window::emulator_milliseconds);
@@ -114,6 +120,7 @@ age::qt_main_window::qt_main_window(QWidget* parent, Qt::WindowFlags flags)
 
     connect(m_settings, &qt_settings_dialog::misc_pause_emulator_changed, emulation_runner, &qt_emulation_runner::set_emulator_paused);
     connect(m_settings, &qt_settings_dialog::misc_synchronize_emulator_changed, emulation_runner, &qt_emulation_runner::set_emulator_synchronize);
+    connect(m_settings, &qt_settings_dialog::misc_fast_forward_changed, emulation_runner, &qt_emulation_runner::set_emulator_fast_forward);
     connect(m_settings, &qt_settings_dialog::misc_show_menu_bar_changed, this, &qt_main_window::misc_show_menu_bar_changed);
     connect(m_settings, &qt_settings_dialog::misc_show_status_bar_changed, this, &qt_main_window::misc_show_status_bar_changed);
     connect(m_settings, &qt_settings_dialog::misc_show_menu_bar_fullscreen_changed, this, &qt_main_window::misc_show_menu_bar_fullscreen_changed);
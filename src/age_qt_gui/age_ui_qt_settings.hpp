@@ -90,7 +90,8 @@ namespace age
         audio_decrease_volume,
 
         misc_toggle_pause_emulator,
-        misc_toggle_synchronize_emulator
+        misc_toggle_synchronize_emulator,
+        misc_toggle_fast_forward
     };
 
 
@@ -219,6 +220,7 @@ namespace age
         explicit qt_settings_audio(QSharedPointer<qt_user_value_store> user_value_store, QWidget* parent = nullptr, Qt::WindowFlags flags = {});
 
         void set_active_audio_device(const QAudioDevice& device, const QAudioFormat& format, int buffer_size, int downsampler_fir_size);
+        void set_audio_output_stats(int latency_milliseconds, double rate_correction);
 
         void toggle_mute();
         void increase_volume();
@@ -249,11 +251,12 @@ namespace age
 
         QSharedPointer<qt_user_value_store> m_user_value_store;
 
-        QComboBox* m_combo_devices     = nullptr;
-        QLabel*    m_label_device      = nullptr;
-        QLabel*    m_label_format      = nullptr;
-        QLabel*    m_label_buffer      = nullptr;
-        QLabel*    m_label_fir_entries = nullptr;
+        QComboBox* m_combo_devices      = nullptr;
+        QLabel*    m_label_device       = nullptr;
+        QLabel*    m_label_format       = nullptr;
+        QLabel*    m_label_buffer       = nullptr;
+        QLabel*    m_label_fir_entries  = nullptr;
+        QLabel*    m_label_rate_control = nullptr;
 
         QComboBox* m_combo_downsampler = nullptr;
 
@@ -354,13 +357,16 @@ namespace age
 
         void toggle_pause_emulator();
         void toggle_synchronize_emulator();
+        void toggle_fast_forward();
         void set_pause_emulator(bool pause_emulator);
+        void set_frame_pacing_stats(int max_wakeup_delay_microseconds, double late_frames_percent, const QList<int>& frame_jitter_histogram);
         void emit_settings_signals();
 
     signals:
 
         void pause_emulator_changed(bool pause_emulator);
         void synchronize_emulator_changed(bool synchronize_emulator);
+        void fast_forward_changed(int speed_multiplier);
 
         void show_menu_bar_changed(bool show_menu_bar);
         void show_status_bar_changed(bool show_status_bar);
@@ -371,6 +377,8 @@ namespace age
 
         void on_pause_emulator_change(int state);
         void on_synchronize_emulator_change(int state);
+        void on_fast_forward_change(int state);
+        void on_fast_forward_speed_change(const QString& text);
 
         void on_show_menu_bar_change(int state);
         void on_show_status_bar_change(int state);
@@ -378,10 +386,15 @@ namespace age
         void on_show_status_bar_fullscreen_change(int state);
 
     private:
+        [[nodiscard]] int get_fast_forward_speed_multiplier() const;
+
         QSharedPointer<qt_user_value_store> m_user_value_store;
 
         QCheckBox* m_pause_emulator       = nullptr;
         QCheckBox* m_synchronize_emulator = nullptr;
+        QCheckBox* m_fast_forward         = nullptr;
+        QComboBox* m_fast_forward_speed   = nullptr;
+        QLabel*    m_frame_pacing         = nullptr;
 
         QCheckBox* m_show_menu_bar              = nullptr;
         QCheckBox* m_show_status_bar            = nullptr;
@@ -431,6 +444,7 @@ namespace age
 
         void misc_pause_emulator_changed(bool pause_emulator);
         void misc_synchronize_emulator_changed(bool synchronize_emulator);
+        void misc_fast_forward_changed(int speed_multiplier);
         void misc_show_menu_bar_changed(bool show_menu_bar);
         void misc_show_status_bar_changed(bool show_status_bar);
         void misc_show_menu_bar_fullscreen_changed(bool show_menu_bar_fullscreen);
@@ -439,6 +453,8 @@ namespace age
     public slots:
 
         void audio_device_activated(QAudioDevice device, QAudioFormat format, int buffer_size, int downsampler_fir_size);
+        void audio_output_stats(int latency_milliseconds, double rate_correction);
+        void frame_pacing_stats(int max_wakeup_delay_microseconds, double late_frames_percent, QList<int> frame_jitter_histogram);
         void set_emulator_screen_size(age::int16_t width, age::int16_t height);
 
 
@@ -460,6 +476,7 @@ namespace age
 
         void emit_misc_pause_emulator_changed(bool pause_emulator);
         void emit_misc_synchronize_emulator_changed(bool synchronize_emulator);
+        void emit_misc_fast_forward_changed(int speed_multiplier);
         void emit_misc_show_menu_bar_changed(bool show_menu_bar);
         void emit_misc_show_status_bar_changed(bool show_status_bar);
         void emit_misc_show_menu_bar_fullscreen_changed(bool show_menu_bar_fullscreen);
@@ -56,11 +56,12 @@ age::qt_settings_audio::qt_settings_audio(QSharedPointer<qt_user_value_store> us
 
     m_combo_devices = new QComboBox;
     m_combo_devices->setEditable(false);
-    auto* current       = new QLabel("current device:");
-    m_label_device      = new QLabel("n/a");
-    m_label_format      = new QLabel("n/a");
-    m_label_buffer      = new QLabel("n/a");
-    m_label_fir_entries = new QLabel("n/a");
+    auto* current        = new QLabel("current device:");
+    m_label_device       = new QLabel("n/a");
+    m_label_format       = new QLabel("n/a");
+    m_label_buffer       = new QLabel("n/a");
+    m_label_fir_entries  = new QLabel("n/a");
+    m_label_rate_control = new QLabel("n/a");
 
     // since audio device names may be quite long, we let the respective widgets expand or shrink
     // (and don't use audio device names as minimum size, like it was before)
@@ -75,6 +76,7 @@ age::qt_settings_audio::qt_settings_audio(QSharedPointer<qt_user_value_store> us
     audio_device_layout->addWidget(m_label_format);
     audio_device_layout->addWidget(m_label_buffer);
     audio_device_layout->addWidget(m_label_fir_entries);
+    audio_device_layout->addWidget(m_label_rate_control);
 
     auto* audio_device_group = new QGroupBox("audio device");
     audio_device_group->setLayout(audio_device_layout);
@@ -115,6 +117,7 @@ age::qt_settings_audio::qt_settings_audio(QSharedPointer<qt_user_value_store> us
     m_combo_downsampler->addItem(get_name_for_qt_downsampler_quality(qt_downsampler_quality::low));
     m_combo_downsampler->addItem(get_name_for_qt_downsampler_quality(qt_downsampler_quality::high));
     m_combo_downsampler->addItem(get_name_for_qt_downsampler_quality(qt_downsampler_quality::highest));
+    m_combo_downsampler->addItem(get_name_for_qt_downsampler_quality(qt_downsampler_quality::multistage));
     m_combo_downsampler->setCurrentText(qt_downsampler_quality_high); // default value
     auto* quality = new QLabel("resampling quality:");
 
@@ -179,6 +182,7 @@ void age::qt_settings_audio::set_active_audio_device(const QAudioDevice& device,
         m_label_format->setText("n/a");
         m_label_buffer->setText("n/a");
         m_label_fir_entries->setText("n/a");
+        m_label_rate_control->setText("n/a");
         return;
     }
 
@@ -198,6 +202,14 @@ void age::qt_settings_audio::set_active_audio_device(const QAudioDevice& device,
     m_label_fir_entries->setText(QString::number(downsampler_fir_size) + " FIR entries");
 }
 
+void age::qt_settings_audio::set_audio_output_stats(int latency_milliseconds, double rate_correction)
+{
+    double correction_percent = (rate_correction - 1) * 100;
+    m_label_rate_control->setText(QString::number(latency_milliseconds) + " milliseconds latency ("
+                                  + QString("%1%").arg(correction_percent, 0, 'f', 2)
+                                  + " rate correction)");
+}
+
 
 
 void age::qt_settings_audio::toggle_mute()
@@ -72,6 +72,7 @@ age::qt_settings_dialog::qt_settings_dialog(QSharedPointer<qt_user_value_store>
 
     connect(m_settings_miscellaneous, &qt_settings_miscellaneous::pause_emulator_changed, this, &qt_settings_dialog::emit_misc_pause_emulator_changed);
     connect(m_settings_miscellaneous, &qt_settings_miscellaneous::synchronize_emulator_changed, this, &qt_settings_dialog::emit_misc_synchronize_emulator_changed);
+    connect(m_settings_miscellaneous, &qt_settings_miscellaneous::fast_forward_changed, this, &qt_settings_dialog::emit_misc_fast_forward_changed);
     connect(m_settings_miscellaneous, &qt_settings_miscellaneous::show_menu_bar_changed, this, &qt_settings_dialog::emit_misc_show_menu_bar_changed);
     connect(m_settings_miscellaneous, &qt_settings_miscellaneous::show_status_bar_changed, this, &qt_settings_dialog::emit_misc_show_status_bar_changed);
     connect(m_settings_miscellaneous, &qt_settings_miscellaneous::show_menu_bar_fullscreen_changed, this, &qt_settings_dialog::emit_misc_show_menu_bar_fullscreen_changed);
@@ -162,6 +163,10 @@ bool age::qt_settings_dialog::trigger_settings_event(qt_key_event event)
             m_settings_miscellaneous->toggle_synchronize_emulator();
             break;
 
+        case qt_key_event::misc_toggle_fast_forward:
+            m_settings_miscellaneous->toggle_fast_forward();
+            break;
+
         default:
             result = false;
             break;
@@ -192,6 +197,16 @@ void age::qt_settings_dialog::audio_device_activated(QAudioDevice device, QAudio
     m_settings_audio->set_active_audio_device(device, format, buffer_size, downsampler_fir_size);
 }
 
+void age::qt_settings_dialog::audio_output_stats(int latency_milliseconds, double rate_correction)
+{
+    m_settings_audio->set_audio_output_stats(latency_milliseconds, rate_correction);
+}
+
+void age::qt_settings_dialog::frame_pacing_stats(int max_wakeup_delay_microseconds, double late_frames_percent, QList<int> frame_jitter_histogram)
+{
+    m_settings_miscellaneous->set_frame_pacing_stats(max_wakeup_delay_microseconds, late_frames_percent, frame_jitter_histogram);
+}
+
 void age::qt_settings_dialog::set_emulator_screen_size(int16_t width, int16_t height)
 {
     m_settings_video->set_emulator_screen_size(width, height);
@@ -288,6 +303,11 @@ void age::qt_settings_dialog::emit_misc_synchronize_emulator_changed(bool synchr
     emit misc_synchronize_emulator_changed(synchronize_emulator);
 }
 
+void age::qt_settings_dialog::emit_misc_fast_forward_changed(int speed_multiplier)
+{
+    emit misc_fast_forward_changed(speed_multiplier);
+}
+
 void age::qt_settings_dialog::emit_misc_show_menu_bar_changed(bool show_menu_bar)
 {
     emit misc_show_menu_bar_changed(show_menu_bar);
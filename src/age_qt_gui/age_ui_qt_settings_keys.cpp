@@ -41,6 +41,7 @@ namespace
     constexpr const char* qt_settings_keys_audio_decrease_volume            = "keys/audio_decrease_volume";
     constexpr const char* qt_settings_keys_misc_toggle_pause_emulator       = "keys/misc_toggle_pause_emulator";
     constexpr const char* qt_settings_keys_misc_toggle_synchronize_emulator = "keys/misc_toggle_synchronize_emulator";
+    constexpr const char* qt_settings_keys_misc_toggle_fast_forward         = "keys/misc_toggle_fast_forward";
 
     QString get_key_string(Qt::Key key)
     {
@@ -81,7 +82,8 @@ age::qt_settings_keys::qt_settings_keys(QSharedPointer<qt_user_value_store> user
                           std::pair<qt_key_event, const char*>(qt_key_event::audio_decrease_volume, "audio settings"),
 
                           std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_pause_emulator, "miscellaneous settings"),
-                          std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_synchronize_emulator, "miscellaneous settings")}),
+                          std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_synchronize_emulator, "miscellaneous settings"),
+                          std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_fast_forward, "miscellaneous settings")}),
 
       m_event_strings({std::pair<qt_key_event, const char*>(qt_key_event::gb_up, "up"),
                        std::pair<qt_key_event, const char*>(qt_key_event::gb_down, "down"),
@@ -101,7 +103,8 @@ age::qt_settings_keys::qt_settings_keys(QSharedPointer<qt_user_value_store> user
                        std::pair<qt_key_event, const char*>(qt_key_event::audio_decrease_volume, "decrease volume"),
 
                        std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_pause_emulator, "toggle pause emulator"),
-                       std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_synchronize_emulator, "toggle synchronize emulator clock")}),
+                       std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_synchronize_emulator, "toggle synchronize emulator clock"),
+                       std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_fast_forward, "toggle fast forward")}),
 
       m_event_setting_strings({std::pair<qt_key_event, const char*>(qt_key_event::gb_up, qt_settings_keys_game_boy_up),
                                std::pair<qt_key_event, const char*>(qt_key_event::gb_down, qt_settings_keys_game_boy_down),
@@ -121,7 +124,8 @@ age::qt_settings_keys::qt_settings_keys(QSharedPointer<qt_user_value_store> user
                                std::pair<qt_key_event, const char*>(qt_key_event::audio_decrease_volume, qt_settings_keys_audio_decrease_volume),
 
                                std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_pause_emulator, qt_settings_keys_misc_toggle_pause_emulator),
-                               std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_synchronize_emulator, qt_settings_keys_misc_toggle_synchronize_emulator)}),
+                               std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_synchronize_emulator, qt_settings_keys_misc_toggle_synchronize_emulator),
+                               std::pair<qt_key_event, const char*>(qt_key_event::misc_toggle_fast_forward, qt_settings_keys_misc_toggle_fast_forward)}),
 
       m_allowed_keys({
           Qt::Key_Tab,
@@ -238,6 +242,7 @@ age::qt_settings_keys::qt_settings_keys(QSharedPointer<qt_user_value_store> user
     auto* misc_keys_layout = new QGridLayout;
     add_key_widgets(misc_keys_layout, 0, qt_key_event::misc_toggle_pause_emulator, Qt::Key_F9);
     add_key_widgets(misc_keys_layout, 1, qt_key_event::misc_toggle_synchronize_emulator, Qt::Key_F10);
+    add_key_widgets(misc_keys_layout, 2, qt_key_event::misc_toggle_fast_forward, Qt::Key_F11);
 
     const char* misc_category   = m_category_strings.value(qt_key_event::misc_toggle_pause_emulator);
     auto*       misc_keys_group = new QGroupBox(misc_category);
@@ -15,14 +15,18 @@
 //
 
 #include <QGroupBox>
+#include <QHBoxLayout>
 #include <QVBoxLayout>
 
 #include "age_ui_qt_settings.hpp"
 
+#include <cassert>
+#include <numeric> // std::accumulate
 #include <utility> // std::move
 
 constexpr const char* qt_settings_misc_pause_emulator        = "miscellaneous/pause_emulator";
 constexpr const char* qt_settings_misc_synchronize_emulator  = "miscellaneous/synchronize_emulator";
+constexpr const char* qt_settings_misc_fast_forward_speed    = "miscellaneous/fast_forward_speed";
 constexpr const char* qt_settings_misc_menu_bar              = "miscellaneous/menu_bar";
 constexpr const char* qt_settings_misc_status_bar            = "miscellaneous/status_bar";
 constexpr const char* qt_settings_misc_menu_bar_fullscreen   = "miscellaneous/menu_bar_fullscreen";
@@ -46,11 +50,27 @@ age::qt_settings_miscellaneous::qt_settings_miscellaneous(QSharedPointer<qt_user
 
     m_pause_emulator       = new QCheckBox("pause emulator");
     m_synchronize_emulator = new QCheckBox("synchronize emulator to clock");
+    m_fast_forward         = new QCheckBox("fast forward");
+
+    m_fast_forward_speed = new QComboBox();
+    m_fast_forward_speed->setEditable(false);
+    m_fast_forward_speed->addItem("2x", 2);
+    m_fast_forward_speed->addItem("4x", 4);
+    m_fast_forward_speed->addItem("unbounded", qt_fast_forward_unbounded);
+
+    m_frame_pacing = new QLabel();
+
+    auto* fast_forward_layout = new QHBoxLayout;
+    fast_forward_layout->addWidget(m_fast_forward);
+    fast_forward_layout->addWidget(m_fast_forward_speed);
 
     auto* emulator_layout = new QVBoxLayout;
     emulator_layout->setAlignment(Qt::AlignCenter);
     emulator_layout->addWidget(m_pause_emulator);
     emulator_layout->addWidget(m_synchronize_emulator);
+    emulator_layout->addLayout(fast_forward_layout);
+    emulator_layout->addSpacing(qt_settings_element_spacing);
+    emulator_layout->addWidget(m_frame_pacing);
 
     auto* emulator_group = new QGroupBox("emulator");
     emulator_group->setLayout(emulator_layout);
@@ -86,6 +106,8 @@ age::qt_settings_miscellaneous::qt_settings_miscellaneous(QSharedPointer<qt_user
 
     connect(m_pause_emulator, &QCheckBox::stateChanged, this, &qt_settings_miscellaneous::on_pause_emulator_change);
     connect(m_synchronize_emulator, &QCheckBox::stateChanged, this, &qt_settings_miscellaneous::on_synchronize_emulator_change);
+    connect(m_fast_forward, &QCheckBox::stateChanged, this, &qt_settings_miscellaneous::on_fast_forward_change);
+    connect(m_fast_forward_speed, &QComboBox::currentTextChanged, this, &qt_settings_miscellaneous::on_fast_forward_speed_change);
     connect(m_show_menu_bar, &QCheckBox::stateChanged, this, &qt_settings_miscellaneous::on_show_menu_bar_change);
     connect(m_show_status_bar, &QCheckBox::stateChanged, this, &qt_settings_miscellaneous::on_show_status_bar_change);
     connect(m_show_menu_bar_fullscreen, &QCheckBox::stateChanged, this, &qt_settings_miscellaneous::on_show_menu_bar_fullscreen_change);
@@ -95,6 +117,7 @@ age::qt_settings_miscellaneous::qt_settings_miscellaneous(QSharedPointer<qt_user
 
     m_pause_emulator->setChecked(m_user_value_store->get_value(qt_settings_misc_pause_emulator, false).toBool());
     m_synchronize_emulator->setChecked(m_user_value_store->get_value(qt_settings_misc_synchronize_emulator, true).toBool());
+    m_fast_forward_speed->setCurrentText(m_user_value_store->get_value(qt_settings_misc_fast_forward_speed, "4x").toString());
     m_show_menu_bar->setChecked(m_user_value_store->get_value(qt_settings_misc_menu_bar, true).toBool());
     m_show_status_bar->setChecked(m_user_value_store->get_value(qt_settings_misc_status_bar, true).toBool());
     m_show_menu_bar_fullscreen->setChecked(m_user_value_store->get_value(qt_settings_misc_menu_bar_fullscreen, true).toBool());
@@ -137,15 +160,45 @@ void age::qt_settings_miscellaneous::toggle_synchronize_emulator()
     m_synchronize_emulator->toggle();
 }
 
+void age::qt_settings_miscellaneous::toggle_fast_forward()
+{
+    m_fast_forward->toggle();
+}
+
 void age::qt_settings_miscellaneous::set_pause_emulator(bool pause_emulator)
 {
     m_pause_emulator->setChecked(pause_emulator);
 }
 
+void age::qt_settings_miscellaneous::set_frame_pacing_stats(int max_wakeup_delay_microseconds, double late_frames_percent, const QList<int>& frame_jitter_histogram)
+{
+    QString text = QString("timer wakeup delayed by up to ") + QString::number(max_wakeup_delay_microseconds)
+                   + " microseconds ("
+                   + QString("%1%").arg(late_frames_percent, 0, 'f', 2)
+                   + " frames started late)";
+
+    // one line per jitter bucket
+    assert(frame_jitter_histogram.size() == qt_frame_jitter_buckets);
+    qint64 frames = std::accumulate(begin(frame_jitter_histogram), end(frame_jitter_histogram), qint64{0});
+    for (int i = 0; (i < frame_jitter_histogram.size()) && (frames > 0); ++i)
+    {
+        QString bucket = (i < static_cast<int>(qt_frame_jitter_bucket_micros.size()))
+                             ? QString("< %1").arg(qt_frame_jitter_bucket_micros[static_cast<size_t>(i)])
+                             : QString(">= %1").arg(qt_frame_jitter_bucket_micros.back());
+
+        text += QString("\nframe start delayed %1 microseconds: %2%")
+                    .arg(bucket)
+                    .arg(frame_jitter_histogram[i] * 100.0 / static_cast<double>(frames), 0, 'f', 2);
+    }
+
+    m_frame_pacing->setText(text);
+}
+
 void age::qt_settings_miscellaneous::emit_settings_signals()
 {
     emit pause_emulator_changed(m_pause_emulator->isChecked());
     emit synchronize_emulator_changed(m_synchronize_emulator->isChecked());
+    emit fast_forward_changed(get_fast_forward_speed_multiplier());
     emit show_menu_bar_changed(m_show_menu_bar->isChecked());
     emit show_status_bar_changed(m_show_status_bar->isChecked());
     emit show_menu_bar_fullscreen_changed(m_show_menu_bar_fullscreen->isChecked());
@@ -178,6 +231,23 @@ void age::qt_settings_miscellaneous::on_synchronize_emulator_change(int state)
     emit synchronize_emulator_changed(checked);
 }
 
+void age::qt_settings_miscellaneous::on_fast_forward_change(int /*state*/)
+{
+    // fast-forwarding is not persisted,
+    // we don't want to start the next session fast-forwarding
+    emit fast_forward_changed(get_fast_forward_speed_multiplier());
+}
+
+void age::qt_settings_miscellaneous::on_fast_forward_speed_change(const QString& text)
+{
+    m_user_value_store->set_value(qt_settings_misc_fast_forward_speed, text);
+
+    if (m_fast_forward->isChecked())
+    {
+        emit fast_forward_changed(get_fast_forward_speed_multiplier());
+    }
+}
+
 void age::qt_settings_miscellaneous::on_show_menu_bar_change(int state)
 {
     bool checked = is_checked(state);
@@ -209,3 +279,18 @@ void age::qt_settings_miscellaneous::on_show_status_bar_fullscreen_change(int st
 
     emit show_status_bar_fullscreen_changed(checked);
 }
+
+
+
+
+
+//---------------------------------------------------------
+//
+//   private methods
+//
+//---------------------------------------------------------
+
+int age::qt_settings_miscellaneous::get_fast_forward_speed_multiplier() const
+{
+    return m_fast_forward->isChecked() ? m_fast_forward_speed->currentData().toInt() : 1;
+}
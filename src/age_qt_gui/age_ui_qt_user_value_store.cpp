@@ -18,6 +18,7 @@
 #include <QDir>
 #include <QFile>
 #include <QMetaType>
+#include <QSaveFile>
 
 #include "age_ui_qt.hpp"
 #include "age_ui_qt_user_value_store.hpp"
@@ -105,17 +106,8 @@ bool age::qt_user_value_store::set_value(const QString& key, const QVariant& val
     // if this is a byte array, store it as extra file
     if (QMetaType::QByteArray == value.userType())
     {
-        make_user_directory(); // make sure the user value directory exists
-
-        QString file_path = m_user_value_directory + key;
-
-        QFile file{file_path};
-        if (file.open(QIODevice::WriteOnly))
+        if (write_value_file(key, value.toByteArray()))
         {
-
-            QByteArray bytes = value.toByteArray();
-            file.write(bytes.data(), bytes.size());
-
             // remove the key from the settings file to prevent any confusion
             m_settings->remove(key);
             saved = true;
@@ -135,6 +127,23 @@ bool age::qt_user_value_store::set_value(const QString& key, const QVariant& val
 
 
 
+bool age::qt_user_value_store::write_value_file(const QString& key, const QByteArray& bytes) const
+{
+    make_user_directory(); // make sure the user value directory exists
+
+    // QSaveFile writes to a temporary file and renames it on commit(),
+    // the previous value file remains untouched if anything goes wrong
+    QSaveFile file{m_user_value_directory + key};
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(bytes);
+    return file.commit();
+}
+
+
+
 void age::qt_user_value_store::sync()
 {
     if (m_settings != nullptr)
@@ -151,7 +160,7 @@ void age::qt_user_value_store::sync()
 //
 //---------------------------------------------------------
 
-void age::qt_user_value_store::make_user_directory()
+void age::qt_user_value_store::make_user_directory() const
 {
     QDir home = QDir::home();
 
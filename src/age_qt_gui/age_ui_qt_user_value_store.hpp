@@ -21,6 +21,7 @@
 //! \file
 //!
 
+#include <QByteArray>
 #include <QSettings>
 #include <QSharedPointer>
 #include <QString>
@@ -73,13 +74,27 @@ namespace age
         //!
         bool set_value(const QString& key, const QVariant& value);
 
+        //!
+        //! \brief Write a byte array user value to its value file.
+        //!
+        //! The value file is replaced atomically,
+        //! so that it is never left partially written.
+        //! Since the settings file is not accessed,
+        //! this method may be called from any thread.
+        //!
+        //! \param key The unique identifier of the user value to write.
+        //! \param bytes The value to write.
+        //! \return True if the value has been saved. False if the value could not be saved for some reason.
+        //!
+        bool write_value_file(const QString& key, const QByteArray& bytes) const;
+
         //!
         //! \brief Synchronize the persistent value store and all in-memory copies of user values.
         //!
         void sync();
 
     private:
-        void make_user_directory();
+        void make_user_directory() const;
 
         const QString             m_user_value_directory;
         QSharedPointer<QSettings> m_settings = nullptr;
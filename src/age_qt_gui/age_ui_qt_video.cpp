@@ -30,7 +30,7 @@
 namespace
 {
 
-    QString load_shader(const QString& file_name)
+    QString prepare_shader(const QString& shader_code)
     {
         // we need an OpenGL context for checking the OpenGL version
         bool is_opengl_es;
@@ -43,20 +43,6 @@ namespace
             is_opengl_es = ctx->isOpenGLES();
         }
 
-        // load the shader code
-        QString shader_code;
-        {
-            QFile file(file_name);
-            if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-            {
-                qWarning() << "could not open file: " << file_name;
-                return "";
-            }
-
-            shader_code = QString(file.readAll()); // QString created using fromUtf8()
-            file.close();
-        }
-
         //
         // The #version directive is added to the shader depending
         // on the current OpenGL implementation being used.
@@ -96,6 +82,25 @@ namespace
         return result;
     }
 
+    QString load_shader(const QString& file_name)
+    {
+        // load the shader code
+        QString shader_code;
+        {
+            QFile file(file_name);
+            if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            {
+                qWarning() << "could not open file: " << file_name;
+                return "";
+            }
+
+            shader_code = QString(file.readAll()); // QString created using fromUtf8()
+            file.close();
+        }
+
+        return prepare_shader(shader_code);
+    }
+
 } // namespace
 
 void age::qt_init_shader_program(QOpenGLShaderProgram& program, const QString& vertex_shader_file, const QString& fragment_shader_file)
@@ -107,6 +112,14 @@ void age::qt_init_shader_program(QOpenGLShaderProgram& program, const QString& v
     program.link();
 }
 
+void age::qt_init_generated_shader_program(QOpenGLShaderProgram& program, const QString& vertex_shader_file, const QString& fragment_shader_code)
+{
+    // failures are logged by Qt
+    program.addShaderFromSourceCode(QOpenGLShader::Vertex, load_shader(vertex_shader_file));
+    program.addShaderFromSourceCode(QOpenGLShader::Fragment, prepare_shader(fragment_shader_code));
+    program.link();
+}
+
 void age::qt_use_float_attribute_buffer(QOpenGLShaderProgram& program, const char* attribute_name, int offset, int tuple_size, int stride)
 {
     int attribute_location = program.attributeLocation(attribute_name);
@@ -124,9 +137,11 @@ void age::qt_use_float_attribute_buffer(QOpenGLShaderProgram& program, const cha
 //
 //---------------------------------------------------------
 
-age::qt_video_output::qt_video_output(QWidget* parent)
-    : QOpenGLWidget(parent)
+age::qt_video_output::qt_video_output(QSharedPointer<frame_pool> pool, QWidget* parent)
+    : QOpenGLWidget(parent),
+      m_frame_pool(std::move(pool))
 {
+    assert(m_frame_pool != nullptr);
     // Which OpenGL Version is being used?
     // https://stackoverflow.com/questions/41021681/qt-how-to-detect-which-version-of-opengl-is-being-used
 
@@ -157,7 +172,8 @@ age::qt_video_output::~qt_video_output()
 
 void age::qt_video_output::set_emulator_screen_size(int16_t w, int16_t h)
 {
-    m_emulator_screen = QSize(w, h);
+    m_emulator_screen  = QSize(w, h);
+    m_last_frame_valid = false; // the native frames will be reset
 
     run_if_initialized([this] {
         m_renderer->update_matrix(m_emulator_screen, QSize(width(), height()));
@@ -165,9 +181,32 @@ void age::qt_video_output::set_emulator_screen_size(int16_t w, int16_t h)
     });
 }
 
-void age::qt_video_output::new_frame(QSharedPointer<const age::pixel_vector> new_frame)
+void age::qt_video_output::new_frame()
 {
-    new_frame_slot(std::move(new_frame));
+    // The frame pool skips all frames but the latest one,
+    // if we cannot keep up with the emulation.
+    // The frame stays valid until we take the next one.
+    const pool_frame* frame = m_frame_pool->take_frame();
+    if (frame == nullptr)
+    {
+        return;
+    }
+
+    run_if_initialized([this, frame] {
+        // the emulation runner publishes the same hash again if the
+        // screen did not change
+        if (m_last_frame_valid && (frame->m_hash == m_last_frame_hash))
+        {
+            m_post_processor->repeat_last_frame();
+        }
+        else
+        {
+            m_post_processor->add_new_frame(frame->m_pixels);
+            m_last_frame_hash  = frame->m_hash;
+            m_last_frame_valid = true;
+        }
+        ++m_frame_counter;
+    });
 }
 
 
@@ -262,37 +301,3 @@ void age::qt_video_output::update_fps()
     emit fps(m_frame_counter * stats_per_second);
     m_frame_counter = 0;
 }
-
-void age::qt_video_output::new_frame_slot(QSharedPointer<const pixel_vector> new_frame)
-{
-    if (new_frame == nullptr)
-    {
-        return;
-    }
-
-    // if multiple frame are queued,
-    // we handle only the last one and discard all others
-    // (this should not happen if the machine can handle the load)
-    if (m_new_frame == nullptr)
-    {
-        // call process_new_frame() after all events scheduled so far (with the same priority) have been processed
-        //  -> this requires an event loop
-        QMetaObject::invokeMethod(this, "process_new_frame", Qt::QueuedConnection);
-    }
-    else
-    {
-        ++m_frames_discarded;
-    }
-    m_new_frame = new_frame;
-}
-
-void age::qt_video_output::process_new_frame()
-{
-    run_if_initialized([this] {
-        assert(nullptr != m_new_frame);
-        m_post_processor->add_new_frame(*m_new_frame);
-        ++m_frame_counter;
-    });
-
-    m_new_frame = nullptr; // allow next frame to be processed
-}
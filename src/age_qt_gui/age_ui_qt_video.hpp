@@ -22,6 +22,7 @@
 
 #include <functional> // std::function
 
+#include <QHash>
 #include <QList>
 #include <QMatrix4x4>
 #include <QOpenGLBuffer>
@@ -36,6 +37,7 @@
 #include <QVector3D>
 
 #include <age_types.hpp>
+#include <gfx/age_frame_pool.hpp>
 #include <gfx/age_pixel.hpp>
 
 #include "age_ui_qt.hpp"
@@ -52,6 +54,7 @@ namespace age
     };
 
     void qt_init_shader_program(QOpenGLShaderProgram& program, const QString& vertex_shader_file, const QString& fragment_shader_file);
+    void qt_init_generated_shader_program(QOpenGLShaderProgram& program, const QString& vertex_shader_file, const QString& fragment_shader_code);
     void qt_use_float_attribute_buffer(QOpenGLShaderProgram& program, const char* attribute_name, int offset, int tuple_size, int stride = 0);
 
 
@@ -85,6 +88,7 @@ namespace age
         void set_post_processing_filter(const qt_filter_list& filter_list);
 
         void add_new_frame(const pixel_vector& frame);
+        void repeat_last_frame();
 
         [[nodiscard]] QList<GLuint> get_frame_textures(int last_N_frames) const;
 
@@ -98,32 +102,44 @@ namespace age
         void set_min_mag_filter(GLuint texture_id, bool min_linear, bool mag_linear);
         void set_wrap_mode(GLuint texture_id);
 
+        void               create_pixel_buffers();
+        void               destroy_pixel_buffers();
+        void               upload_frame(QOpenGLTexture& texture, const pixel_vector& pixel_data);
+        [[nodiscard]] bool upload_frame_async(QOpenGLTexture& texture, const pixel_vector& pixel_data);
+        [[nodiscard]] int  get_unused_frame_texture() const;
+
         [[nodiscard]] bool post_process_frames() const;
         void               post_process_frame(int frame_idx);
 
         void                                            create_post_processor();
         QList<QSharedPointer<QOpenGLFramebufferObject>> create_frame_buffers(int buffers_to_create, const QSize& buffer_size);
         bool                                            add_step(QList<processing_step>& post_processor, QOpenGLShaderProgram* program, const QSize& result_frame_size);
+        QOpenGLShaderProgram*                           get_convolution_program(const QString& fragment_shader_code);
 
         QSize          m_native_frame_size{1, 1};
         bool           m_bilinear_filter = false;
         qt_filter_list m_filter_list;
 
+        //! The frame history references frame textures by index.
+        //! Repeated frames reference the same texture.
         int                                   m_new_frame_idx = 0;
+        QList<int>                            m_frame_history;
         QList<QSharedPointer<QOpenGLTexture>> m_native_frames;
 
+        //! Pixel buffer objects used alternately for asynchronous texture uploads.
+        //! This list is empty if pixel buffer objects are not supported.
+        QList<QOpenGLBuffer> m_pixel_buffers;
+        int                  m_pixel_buffer_idx = 0;
+
         QList<QSharedPointer<QOpenGLFramebufferObject>> m_processed_frames;
         QList<processing_step>                          m_post_processor;
         QOpenGLShaderProgram                            m_program_scale2x;
         QOpenGLShaderProgram                            m_program_scale2x_age;
-        QOpenGLShaderProgram                            m_program_gauss3x3_s;
-        QOpenGLShaderProgram                            m_program_gauss3x3_t;
-        QOpenGLShaderProgram                            m_program_gauss5x5_s;
-        QOpenGLShaderProgram                            m_program_gauss5x5_t;
-        QOpenGLShaderProgram                            m_program_emboss3x3;
-        QOpenGLShaderProgram                            m_program_emboss5x5;
         QOpenGLBuffer                                   m_vertices;
         QOpenGLBuffer                                   m_indices;
+
+        //! generated convolution shader programs by fragment shader code
+        QHash<QString, QSharedPointer<QOpenGLShaderProgram>> m_convolution_programs;
     };
 
 
@@ -135,7 +151,7 @@ namespace age
         // public interface
 
     public:
-        explicit qt_video_output(QWidget* parent = nullptr);
+        explicit qt_video_output(QSharedPointer<frame_pool> pool, QWidget* parent = nullptr);
         ~qt_video_output() override;
 
     signals:
@@ -145,7 +161,7 @@ namespace age
     public slots:
 
         void set_emulator_screen_size(age::int16_t width, age::int16_t height);
-        void new_frame(QSharedPointer<const age::pixel_vector> new_frame);
+        void new_frame();
 
         void set_blend_frames(int num_frames_to_blend);
         void set_post_processing_filter(age::qt_filter_list filter_list);
@@ -178,12 +194,10 @@ namespace age
         void update_fps();
 
     private:
-        void             new_frame_slot(QSharedPointer<const pixel_vector> new_frame);
-        Q_INVOKABLE void process_new_frame();
-
-        QSharedPointer<const pixel_vector> m_new_frame        = nullptr;
-        int                                m_frames_discarded = 0;
-        int                                m_frame_counter    = 0;
+        QSharedPointer<frame_pool> m_frame_pool;
+        uint64_t                      m_last_frame_hash  = 0; //!< hash of the last frame uploaded
+        bool                          m_last_frame_valid = false;
+        int                           m_frame_counter    = 0;
     };
 
 } // namespace age
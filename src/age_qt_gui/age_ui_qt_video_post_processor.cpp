@@ -16,7 +16,14 @@
 
 #include "age_ui_qt_video.hpp"
 
+#include <gfx/age_convolution.hpp>
+
 #include <cassert>
+#include <cstring> // memcpy
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -26,6 +33,49 @@ namespace
     constexpr QOpenGLTexture::PixelFormat   tx_pixel_format = QOpenGLTexture::RGBA;
     constexpr QOpenGLTexture::PixelType     tx_pixel_type   = QOpenGLTexture::UInt8;
 
+    // double buffering for asynchronous texture uploads
+    constexpr int pixel_buffer_count = 2;
+
+
+
+    std::vector<age::convolution_kernel> get_filter_kernels(age::qt_filter filter)
+    {
+        switch (filter)
+        {
+            case age::qt_filter::gauss3x3: return {age::convolution_gauss3x3_s, age::convolution_gauss3x3_t};
+            case age::qt_filter::gauss5x5: return {age::convolution_gauss5x5_s, age::convolution_gauss5x5_t};
+            case age::qt_filter::emboss3x3: return {age::convolution_emboss3x3};
+            case age::qt_filter::emboss5x5: return {age::convolution_emboss5x5};
+            default: return {}; // not a convolution filter
+        }
+    }
+
+    std::string create_convolution_shader(const age::convolution_kernel& kernel)
+    {
+        // version directive and OpenGL ES precision qualifiers
+        // are added by the shader loader
+        std::stringstream shader;
+        shader << std::fixed << std::setprecision(8)
+               << "uniform sampler2D texture;\n"
+               << "uniform vec2 u_inv_texture_size;\n"
+               << "\n"
+               << "void main()\n"
+               << "{\n"
+               << "    vec2 tex_coord = vec2(gl_FragCoord);\n"
+               << "    vec4 color = vec4(0.0);\n";
+
+        for (const auto& [offset, weight] : kernel)
+        {
+            shader << "    color += texture2D(texture, (tex_coord + vec2("
+                   << offset.first << ".0, " << offset.second << ".0)) * u_inv_texture_size) * "
+                   << weight << ";\n";
+        }
+
+        shader << "    gl_FragColor = color;\n"
+               << "}\n";
+        return shader.str();
+    }
+
 } // namespace
 
 
@@ -44,12 +94,7 @@ age::qt_video_post_processor::qt_video_post_processor()
 
     qt_init_shader_program(m_program_scale2x, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_scale2x_fsh.glsl");
     qt_init_shader_program(m_program_scale2x_age, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_scale2x_age_fsh.glsl");
-    qt_init_shader_program(m_program_gauss3x3_s, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_gauss3x3_s_fsh.glsl");
-    qt_init_shader_program(m_program_gauss3x3_t, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_gauss3x3_t_fsh.glsl");
-    qt_init_shader_program(m_program_gauss5x5_s, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_gauss5x5_s_fsh.glsl");
-    qt_init_shader_program(m_program_gauss5x5_t, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_gauss5x5_t_fsh.glsl");
-    qt_init_shader_program(m_program_emboss3x3, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_emboss3x3_fsh.glsl");
-    qt_init_shader_program(m_program_emboss5x5, ":/age_ui_qt_pp_vsh.glsl", ":/age_ui_qt_pp_emboss5x5_fsh.glsl");
+    // convolution shader programs are generated on demand
 
     // vertex buffer
     // (we can already transform the vertices since the projection matrix is never modified)
@@ -78,6 +123,7 @@ age::qt_video_post_processor::qt_video_post_processor()
 
 age::qt_video_post_processor::~qt_video_post_processor()
 {
+    destroy_pixel_buffers();
     m_indices.destroy();
     m_vertices.destroy();
 }
@@ -95,6 +141,7 @@ void age::qt_video_post_processor::set_native_frame_size(const QSize& size)
     m_native_frame_size = size;
 
     m_new_frame_idx = 0;
+    m_frame_history.clear();
     m_native_frames.clear();
 
     pixel_vector empty_frame(size.width() * size.height(), pixel());
@@ -110,9 +157,11 @@ void age::qt_video_post_processor::set_native_frame_size(const QSize& size)
         set_min_mag_filter(frame->textureId(), true, m_bilinear_filter);
         set_wrap_mode(frame->textureId());
 
+        m_frame_history.append(i);
         m_native_frames.append(frame);
     }
 
+    create_pixel_buffers();
     set_post_processing_filter(m_filter_list);
 }
 
@@ -146,18 +195,34 @@ void age::qt_video_post_processor::add_new_frame(const pixel_vector& pixel_data)
 {
     assert(!m_native_frames.empty());
     assert(m_new_frame_idx >= 0);
-    assert(m_new_frame_idx < m_native_frames.size());
+    assert(m_new_frame_idx < m_frame_history.size());
 
-    m_native_frames[m_new_frame_idx]->bind();
-    m_native_frames[m_new_frame_idx]->setData(tx_pixel_format, tx_pixel_type, pixel_data.data());
+    int texture_idx = get_unused_frame_texture();
+    upload_frame(*m_native_frames[texture_idx], pixel_data);
 
     if (post_process_frames())
     {
-        post_process_frame(m_new_frame_idx);
+        post_process_frame(texture_idx);
     }
 
+    m_frame_history[m_new_frame_idx] = texture_idx;
+    ++m_new_frame_idx;
+    m_new_frame_idx = (m_new_frame_idx >= m_frame_history.size()) ? 0 : m_new_frame_idx;
+}
+
+void age::qt_video_post_processor::repeat_last_frame()
+{
+    assert(!m_frame_history.empty());
+    assert(m_new_frame_idx >= 0);
+    assert(m_new_frame_idx < m_frame_history.size());
+
+    // reference the last frame's texture again,
+    // no need to upload or post-process anything
+    int last_frame_idx               = ((m_new_frame_idx > 0) ? m_new_frame_idx : m_frame_history.size()) - 1;
+    m_frame_history[m_new_frame_idx] = m_frame_history[last_frame_idx];
+
     ++m_new_frame_idx;
-    m_new_frame_idx = (m_new_frame_idx >= m_native_frames.size()) ? 0 : m_new_frame_idx;
+    m_new_frame_idx = (m_new_frame_idx >= m_frame_history.size()) ? 0 : m_new_frame_idx;
 }
 
 
@@ -165,20 +230,21 @@ void age::qt_video_post_processor::add_new_frame(const pixel_vector& pixel_data)
 QList<GLuint> age::qt_video_post_processor::get_frame_textures(int last_N_frames) const
 {
     last_N_frames = qMax(last_N_frames, 1);
-    last_N_frames = qMin(last_N_frames, m_native_frames.size());
+    last_N_frames = qMin(last_N_frames, m_frame_history.size());
     assert(last_N_frames > 0);
-    assert(last_N_frames <= m_native_frames.size());
+    assert(last_N_frames <= m_frame_history.size());
 
     QList<GLuint> result;
     int           frame_idx = m_new_frame_idx;
 
     for (int i = 0; i < last_N_frames; ++i)
     {
-        frame_idx = ((frame_idx > 0) ? frame_idx : m_native_frames.size()) - 1;
+        frame_idx       = ((frame_idx > 0) ? frame_idx : m_frame_history.size()) - 1;
+        int texture_idx = m_frame_history[frame_idx];
 
         result.append(post_process_frames()
-                          ? m_processed_frames[frame_idx]->texture()
-                          : m_native_frames[frame_idx]->textureId());
+                          ? m_processed_frames[texture_idx]->texture()
+                          : m_native_frames[texture_idx]->textureId());
     }
 
     return result;
@@ -216,6 +282,111 @@ void age::qt_video_post_processor::set_wrap_mode(GLuint texture_id)
 
 
 
+void age::qt_video_post_processor::create_pixel_buffers()
+{
+    destroy_pixel_buffers();
+
+    int bytes = m_native_frame_size.width() * m_native_frame_size.height() * static_cast<int>(sizeof(pixel));
+
+    for (int i = 0; i < pixel_buffer_count; ++i)
+    {
+        QOpenGLBuffer buffer(QOpenGLBuffer::PixelUnpackBuffer);
+        if (!buffer.create())
+        {
+            break;
+        }
+        buffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+        buffer.bind();
+        buffer.allocate(bytes);
+        buffer.release();
+        m_pixel_buffers.append(buffer);
+    }
+
+    // fall back to synchronous uploads if we could not create all buffers
+    if (m_pixel_buffers.size() < pixel_buffer_count)
+    {
+        destroy_pixel_buffers();
+    }
+}
+
+void age::qt_video_post_processor::destroy_pixel_buffers()
+{
+    for (auto& buffer : m_pixel_buffers)
+    {
+        buffer.destroy();
+    }
+    m_pixel_buffers.clear();
+    m_pixel_buffer_idx = 0;
+}
+
+void age::qt_video_post_processor::upload_frame(QOpenGLTexture& texture, const pixel_vector& pixel_data)
+{
+    assert(static_cast<int>(pixel_data.size()) == m_native_frame_size.width() * m_native_frame_size.height());
+
+    if (!m_pixel_buffers.empty() && upload_frame_async(texture, pixel_data))
+    {
+        return;
+    }
+    texture.bind();
+    texture.setData(tx_pixel_format, tx_pixel_type, pixel_data.data());
+}
+
+bool age::qt_video_post_processor::upload_frame_async(QOpenGLTexture& texture, const pixel_vector& pixel_data)
+{
+    // Copy the frame to a pixel buffer object and let OpenGL transfer it
+    // to the texture asynchronously.
+    // By alternating between buffers we don't have to wait for the
+    // previous frame's transfer to finish.
+    QOpenGLBuffer& buffer = m_pixel_buffers[m_pixel_buffer_idx];
+    ++m_pixel_buffer_idx;
+    m_pixel_buffer_idx = (m_pixel_buffer_idx >= m_pixel_buffers.size()) ? 0 : m_pixel_buffer_idx;
+
+    int bytes = buffer.size();
+    assert(bytes == static_cast<int>(pixel_data.size() * sizeof(pixel)));
+
+    buffer.bind();
+    void* mapped = buffer.mapRange(0, bytes, QOpenGLBuffer::RangeWrite | QOpenGLBuffer::RangeInvalidateBuffer);
+    if (mapped == nullptr)
+    {
+        // buffer mapping not supported (e.g. OpenGL ES 2.0),
+        // fall back to synchronous uploads
+        buffer.release();
+        destroy_pixel_buffers();
+        return false;
+    }
+    memcpy(mapped, pixel_data.data(), static_cast<size_t>(bytes));
+    buffer.unmap();
+
+    // read pixels from the bound pixel buffer object (offset 0)
+    texture.bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_native_frame_size.width(), m_native_frame_size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    buffer.release();
+
+    return true;
+}
+
+int age::qt_video_post_processor::get_unused_frame_texture() const
+{
+    // The frame about to be replaced does not count,
+    // so there is at least one texture that is not referenced.
+    for (int texture_idx = 0; texture_idx < m_native_frames.size(); ++texture_idx)
+    {
+        bool used = false;
+        for (int i = 0; i < m_frame_history.size(); ++i)
+        {
+            used |= (i != m_new_frame_idx) && (m_frame_history[i] == texture_idx);
+        }
+        if (!used)
+        {
+            return texture_idx;
+        }
+    }
+    assert(false);
+    return m_frame_history[m_new_frame_idx];
+}
+
+
+
 bool age::qt_video_post_processor::post_process_frames() const
 {
     assert(m_post_processor.empty() == m_processed_frames.empty());
@@ -303,50 +474,57 @@ void age::qt_video_post_processor::create_post_processor()
     // (disable post-processing if that fails)
     QList<processing_step> post_processor;
     QSize                  result_frame_size = m_native_frame_size;
+    bool                   success           = true;
+
+    // Consecutive convolution kernels are fused where possible,
+    // see fuse_convolution_kernels().
+    std::vector<convolution_kernel> pending_kernels;
+
+    auto add_pending_kernels = [&] {
+        for (const auto& kernel : fuse_convolution_kernels(pending_kernels))
+        {
+            auto* program = get_convolution_program(QString::fromStdString(create_convolution_shader(kernel)));
+            success       = success && add_step(post_processor, program, result_frame_size);
+        }
+        pending_kernels.clear();
+    };
 
     for (int i = 0; i < m_filter_list.size(); ++i)
     {
-        qt_filter filter = m_filter_list[i];
+        qt_filter filter  = m_filter_list[i];
+        auto      kernels = get_filter_kernels(filter);
+
+        // convolution filter
+        if (!kernels.empty())
+        {
+            assert(get_qt_filter_factor(filter) == 1);
+            pending_kernels.insert(end(pending_kernels), begin(kernels), end(kernels));
+            continue;
+        }
+
+        // upscaling filter
+        add_pending_kernels();
         result_frame_size *= get_qt_filter_factor(filter);
 
-        bool step_added = false;
         switch (filter)
         {
             case qt_filter::scale2x:
-                step_added = add_step(post_processor, &m_program_scale2x, result_frame_size);
+                success = success && add_step(post_processor, &m_program_scale2x, result_frame_size);
                 break;
 
             case qt_filter::scale2x_age:
-                step_added = add_step(post_processor, &m_program_scale2x_age, result_frame_size);
-                break;
-
-            case qt_filter::gauss3x3:
-                step_added = add_step(post_processor, &m_program_gauss3x3_s, result_frame_size)
-                             && add_step(post_processor, &m_program_gauss3x3_t, result_frame_size);
-                break;
-
-            case qt_filter::gauss5x5:
-                step_added = add_step(post_processor, &m_program_gauss5x5_s, result_frame_size)
-                             && add_step(post_processor, &m_program_gauss5x5_t, result_frame_size);
-                break;
-
-            case qt_filter::emboss3x3:
-                step_added = add_step(post_processor, &m_program_emboss3x3, result_frame_size);
-                break;
-
-            case qt_filter::emboss5x5:
-                step_added = add_step(post_processor, &m_program_emboss5x5, result_frame_size);
+                success = success && add_step(post_processor, &m_program_scale2x_age, result_frame_size);
                 break;
 
             default:
                 assert(false);
         }
+    }
+    add_pending_kernels();
 
-        if (!step_added)
-        {
-            post_processor.clear(); // indicate failure
-            break;
-        }
+    if (!success)
+    {
+        post_processor.clear(); // indicate failure
     }
 
     // create a new frame buffer object for every frame
@@ -412,3 +590,14 @@ bool age::qt_video_post_processor::add_step(QList<processing_step>& post_process
     post_processor.append(step);
     return true;
 }
+
+QOpenGLShaderProgram* age::qt_video_post_processor::get_convolution_program(const QString& fragment_shader_code)
+{
+    auto& program = m_convolution_programs[fragment_shader_code];
+    if (program == nullptr)
+    {
+        program = QSharedPointer<QOpenGLShaderProgram>::create();
+        qt_init_generated_shader_program(*program, ":/age_ui_qt_pp_vsh.glsl", fragment_shader_code);
+    }
+    return program.data();
+}
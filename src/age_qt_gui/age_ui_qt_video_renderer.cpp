@@ -14,6 +14,8 @@
 // limitations under the License.
 //
 
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
 #include <QRectF>
 #include <QVector2D>
 #include <QVector3D>
@@ -24,12 +26,31 @@
 #include <cassert>
 
 
+
+namespace
+{
+    // the render shader blends up to four frames in a single pass
+    constexpr int max_blended_frames = 4;
+
+    static_assert(age::qt_video_frame_history_size <= max_blended_frames, "the render shader cannot blend all frames");
+
+} // namespace
+
+
+
 age::qt_video_renderer::qt_video_renderer()
     : m_indices(QOpenGLBuffer::IndexBuffer)
 {
     // shader program
     qt_init_shader_program(m_program, ":/age_ui_qt_render_vsh.glsl", ":/age_ui_qt_render_fsh.glsl");
 
+    // frame i is read from texture unit i
+    m_program.bind();
+    for (int i = 0; i < max_blended_frames; ++i)
+    {
+        m_program.setUniformValue(QString("u_frame%1").arg(i).toLatin1().constData(), i);
+    }
+
     // vertex buffer
     std::array vertices{
         qt_vertex_data{QVector3D(0, 0, 0), QVector2D(0, 0)},
@@ -94,10 +115,25 @@ void age::qt_video_renderer::render(const QList<GLuint>& textures_to_render)
     qt_use_float_attribute_buffer(m_program, "a_vertex", 0, 3, sizeof(qt_vertex_data));
     qt_use_float_attribute_buffer(m_program, "a_texcoord", sizeof(QVector3D), 2, sizeof(qt_vertex_data));
 
-    for (int i = 0; i < textures_to_render.size(); ++i)
+    // Blend all frames in a single pass by binding each frame to a
+    // separate texture unit.
+    // Unused texture units read the most recent frame with zero weight.
+    assert(!textures_to_render.empty());
+    assert(textures_to_render.size() <= max_blended_frames);
+
+    QOpenGLFunctions* gl      = QOpenGLContext::currentContext()->functions();
+    QVector4D         weights = {0, 0, 0, 0};
+    auto              weight  = 1.F / static_cast<float>(textures_to_render.size());
+
+    for (int i = 0; i < max_blended_frames; ++i)
     {
-        m_program.setUniformValue("u_color", QVector4D(1, 1, 1, 1.F / (static_cast<float>(i) + 1)));
-        glBindTexture(GL_TEXTURE_2D, textures_to_render[i]);
-        glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, nullptr);
+        bool is_used = i < textures_to_render.size();
+        gl->glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, textures_to_render[is_used ? i : 0]);
+        weights[i] = is_used ? weight : 0;
     }
+    gl->glActiveTexture(GL_TEXTURE0); // the post processor uses texture unit 0
+
+    m_program.setUniformValue("u_frame_weights", weights);
+    glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, nullptr);
 }
@@ -17,14 +17,21 @@
 // version directive and OpenGL ES precision qualifiers
 // are added by the shader loader
 
-uniform sampler2D texture;
+// frames to blend, u_frame0 being the most recent one
+uniform sampler2D u_frame0;
+uniform sampler2D u_frame1;
+uniform sampler2D u_frame2;
+uniform sampler2D u_frame3;
 
-uniform vec4 u_color; // used to blend frames
+uniform vec4 u_frame_weights; // used to blend frames
 
 varying vec2 v_texcoord;
 
 
 void main()
 {
-    gl_FragColor = u_color * texture2D(texture, v_texcoord);
+    gl_FragColor = texture2D(u_frame0, v_texcoord) * u_frame_weights.x
+                   + texture2D(u_frame1, v_texcoord) * u_frame_weights.y
+                   + texture2D(u_frame2, v_texcoord) * u_frame_weights.z
+                   + texture2D(u_frame3, v_texcoord) * u_frame_weights.w;
 }
@@ -20,6 +20,7 @@
 #include "age_tr_cmd_option.hpp"
 
 #include <algorithm> // std::for_each
+#include <charconv>  // std::from_chars
 #include <iostream>  // std::cout
 
 #include <getopt.h>  // getopt_long
@@ -36,6 +37,9 @@ namespace
     constexpr char opt_print_passed = 'p';
     constexpr char opt_whitelist    = 'w';
     constexpr char opt_blacklist    = 'x';
+    constexpr char opt_results_json = 'J';
+    constexpr char opt_merge        = 'M';
+    constexpr char opt_shard        = 'S';
 
     std::vector<age::tr::age_tr_cmd_option> cmd_options()
     {
@@ -47,6 +51,9 @@ namespace
             {opt_dmg_only, "dmg-only", "run only Game Boy Classic (DMG) tests"},
             {opt_whitelist, "whitelist", true, "whitelist file/regex"},
             {opt_blacklist, "blacklist", true, "blacklist file/regex"},
+            {opt_shard, "shard", true, "run only shard i/n of all tests (e.g. 2/4)"},
+            {opt_results_json, "results-json", true, "write test results to this JSON file"},
+            {opt_merge, "merge", "merge the JSON result files specified instead of running tests"},
             {opt_write_logs,
              "write-logs",
 #ifdef AGE_COMPILE_LOGGER
@@ -87,6 +94,36 @@ namespace
         }
     }
 
+    bool parse_shard(const std::string& shard, age::tr::options& options)
+    {
+        // expected format: "<index>/<count>"
+        auto separator = shard.find('/');
+        if (separator == std::string::npos)
+        {
+            return false;
+        }
+
+        const char* begin_index = shard.data();
+        const char* end_index   = begin_index + separator;
+        const char* end_count   = begin_index + shard.length();
+
+        int  index         = 0;
+        int  count         = 0;
+        auto [ptr_i, ec_i] = std::from_chars(begin_index, end_index, index);
+        auto [ptr_c, ec_c] = std::from_chars(end_index + 1, end_count, count);
+
+        if ((ec_i != std::errc{}) || (ptr_i != end_index)
+            || (ec_c != std::errc{}) || (ptr_c != end_count)
+            || (count < 1) || (index < 1) || (index > count))
+        {
+            return false;
+        }
+
+        options.m_shard_index = index;
+        options.m_shard_count = count;
+        return true;
+    }
+
 } // namespace
 
 
@@ -117,12 +154,18 @@ void age::tr::print_help(const std::string&                invoked_program,
 
     std::cout << "Usage:" << std::endl;
     std::cout << "  " << invoked_program << " [options] [gameboy-test-roms path]" << std::endl;
+    std::cout << "  " << invoked_program << " --merge [options] <JSON result file> ..." << std::endl;
     std::cout << std::endl;
 
     std::cout << "  If no gameboy-test-roms path is specified" << std::endl;
     std::cout << "  the current working directory is used." << std::endl;
     std::cout << std::endl;
 
+    std::cout << "  Tests can be split across multiple machines using --shard." << std::endl;
+    std::cout << "  The JSON result files written by each shard (--results-json)" << std::endl;
+    std::cout << "  can later be combined into a single summary using --merge." << std::endl;
+    std::cout << std::endl;
+
     std::cout << "Options:" << std::endl;
     print_options(cmd_options());
     std::cout << std::endl;
@@ -256,6 +299,21 @@ age::tr::options age::tr::parse_arguments(const std::vector<char*>&   args,
                 options.m_blacklist = std::string(optarg);
                 break;
 
+            case opt_merge:
+                options.m_merge = true;
+                break;
+
+            case opt_results_json:
+                options.m_results_file = std::filesystem::current_path() / optarg;
+                break;
+
+            case opt_shard:
+                if (!parse_shard(optarg, options))
+                {
+                    options.m_invalid_arg_options.emplace_back(1, static_cast<char>(c));
+                }
+                break;
+
             case '?':
                 // invalid long option: optopt == 0, use argv[optind] instead
                 // see also: https://stackoverflow.com/a/53828745
@@ -279,7 +337,14 @@ age::tr::options age::tr::parse_arguments(const std::vector<char*>&   args,
     }
 
     options.m_test_suite_path = std::filesystem::current_path();
-    if (optind < args.size())
+    if (options.m_merge)
+    {
+        for (auto i = static_cast<std::size_t>(optind); i < args.size(); ++i)
+        {
+            options.m_merge_files.emplace_back(std::filesystem::current_path() / args[i]);
+        }
+    }
+    else if (optind < args.size())
     {
         options.m_test_suite_path /= args[optind];
     }
@@ -38,6 +38,24 @@ namespace age::tr
         bool m_write_logs   = false;
         bool m_print_passed = false;
         bool m_print_failed = false;
+        bool m_merge        = false;
+
+        //!
+        //! Run only the tests of the specified shard.
+        //! Shards are numbered from 1 to m_shard_count (inclusive).
+        //!
+        int m_shard_index = 1;
+        int m_shard_count = 1;
+
+        //!
+        //! If not empty, test results are written to this (JSON) file.
+        //!
+        std::filesystem::path m_results_file = {};
+
+        //!
+        //! (JSON) result files to merge, if m_merge is true
+        //!
+        std::vector<std::filesystem::path> m_merge_files = {};
 
         //!
         //! path to the gameboy-test-roms test suite,
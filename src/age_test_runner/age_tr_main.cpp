@@ -16,6 +16,7 @@
 
 #include "age_tr_arguments.hpp"
 #include "age_tr_print.hpp"
+#include "age_tr_results_file.hpp"
 #include "age_tr_run_tests.hpp"
 #include "modules/age_tr_module.hpp"
 
@@ -115,6 +116,78 @@ namespace
         std::cout << std::endl;
     }
 
+    bool write_results(const age::tr::options& opts, const age::tr::age_tr_test_run_results& results)
+    {
+        return opts.m_results_file.empty() || age::tr::write_results_file(opts.m_results_file, results);
+    }
+
+    int print_results(const age::tr::options& opts, const age::tr::age_tr_test_run_results& results)
+    {
+        if (!write_results(opts, results))
+        {
+            return 1;
+        }
+
+        std::cout << "tests were created from " << results.m_rom_count << " rom(s)" << std::endl;
+
+        std::vector<age::tr::age_tr_test_result> passed_tests;
+        std::copy_if(begin(results.m_test_results),
+                     end(results.m_test_results),
+                     std::back_inserter(passed_tests),
+                     [](auto& res) {
+                         return res.m_test_passed;
+                     });
+
+        std::cout << passed_tests.size() << " test(s) passed" << std::endl;
+        if (opts.m_print_passed)
+        {
+            sort_and_print(passed_tests);
+        }
+
+        std::vector<age::tr::age_tr_test_result> failed_tests;
+        std::copy_if(begin(results.m_test_results),
+                     end(results.m_test_results),
+                     std::back_inserter(failed_tests),
+                     [](auto& res) {
+                         return !res.m_test_passed;
+                     });
+
+        std::cout << failed_tests.size() << " test(s) failed" << std::endl;
+        if (opts.m_print_failed)
+        {
+            sort_and_print(failed_tests);
+        }
+
+        std::cout << std::endl;
+        print_stats(results);
+
+        return failed_tests.empty() ? 0 : 1;
+    }
+
+    int merge_result_files(const age::tr::options& opts)
+    {
+        if (opts.m_merge_files.empty())
+        {
+            std::cout << "no test results to merge!" << std::endl;
+            return 1;
+        }
+
+        std::vector<age::tr::age_tr_test_run_results> all_results;
+        for (const auto& file : opts.m_merge_files)
+        {
+            std::cout << "merging test results:     " << file.string() << std::endl;
+            auto results = age::tr::read_results_file(file);
+            if (!results.has_value())
+            {
+                return 1;
+            }
+            all_results.emplace_back(results.value());
+        }
+        std::cout << std::endl;
+
+        return print_results(opts, age::tr::merge_results(all_results));
+    }
+
 } // namespace
 
 
@@ -154,6 +227,12 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    // merge test results instead of running tests
+    if (opts.m_merge)
+    {
+        return merge_result_files(opts);
+    }
+
     // notify the user about what we're going to do
     std::cout << std::endl;
     print_test_categories(modules);
@@ -181,6 +260,15 @@ int main(int argc, char** argv)
         //! \todo print log categories
     }
 
+    if (opts.m_shard_count > 1)
+    {
+        std::cout << "shard:                    " << opts.m_shard_index << " of " << opts.m_shard_count << std::endl;
+    }
+    if (!opts.m_results_file.empty())
+    {
+        std::cout << "results file:             " << opts.m_results_file.string() << std::endl;
+    }
+
     // check hardware concurrency
     unsigned threads = std::max(4U, std::thread::hardware_concurrency());
     std::cout << "thread pool size:         " << threads << std::endl;
@@ -190,42 +278,17 @@ int main(int argc, char** argv)
     auto results = age::tr::run_tests(opts, modules, threads);
     if (results.m_test_results.empty())
     {
+        // A shard may not get any test at all.
+        // Write an empty results file anyway,
+        // so that all shard results can be merged.
+        if (opts.m_shard_count > 1)
+        {
+            std::cout << "no test found for this shard" << std::endl;
+            return write_results(opts, results) ? 0 : 1;
+        }
         std::cout << "no test found!" << std::endl;
         return 1;
     }
 
-    std::cout << "tests were created from " << results.m_rom_count << " rom(s)" << std::endl;
-
-    std::vector<age::tr::age_tr_test_result> passed_tests;
-    std::copy_if(begin(results.m_test_results),
-                 end(results.m_test_results),
-                 std::back_inserter(passed_tests),
-                 [](auto& res) {
-                     return res.m_test_passed;
-                 });
-
-    std::cout << passed_tests.size() << " test(s) passed" << std::endl;
-    if (opts.m_print_passed)
-    {
-        sort_and_print(passed_tests);
-    }
-
-    std::vector<age::tr::age_tr_test_result> failed_tests;
-    std::copy_if(begin(results.m_test_results),
-                 end(results.m_test_results),
-                 std::back_inserter(failed_tests),
-                 [](auto& res) {
-                     return !res.m_test_passed;
-                 });
-
-    std::cout << failed_tests.size() << " test(s) failed" << std::endl;
-    if (opts.m_print_failed)
-    {
-        sort_and_print(failed_tests);
-    }
-
-    std::cout << std::endl;
-    print_stats(results);
-
-    return failed_tests.empty() ? 0 : 1;
+    return print_results(opts, results);
 }
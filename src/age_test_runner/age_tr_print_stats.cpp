@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <map>
 
 
 
@@ -58,6 +59,28 @@ namespace
                   << ")" << std::endl;
     }
 
+    void print_init_duration(const age::tr::age_tr_test_run_results& test_run_results)
+    {
+        if (test_run_results.m_test_results.empty())
+        {
+            return;
+        }
+
+        std::chrono::duration<double, std::micro> total{0};
+        std::chrono::duration<double, std::micro> max{0};
+        for (const auto& tr : test_run_results.m_test_results)
+        {
+            total += tr.m_init_duration;
+            max = std::max<std::chrono::duration<double, std::micro>>(max, tr.m_init_duration);
+        }
+        auto mean = total / static_cast<double>(test_run_results.m_test_results.size());
+
+        std::cout << "test initialization: " << static_cast<int64_t>(mean.count())
+                  << " microseconds per test (max " << static_cast<int64_t>(max.count())
+                  << ", total " << static_cast<int64_t>(total.count())
+                  << ")" << std::endl;
+    }
+
     void print_cps_table(std::vector<age::tr::age_tr_test_result>::const_iterator begin,
                          std::vector<age::tr::age_tr_test_result>::const_iterator end)
     {
@@ -115,6 +138,34 @@ namespace
         print_cps_table(end(test_results) - static_cast<int64_t>(lowest_count), end(test_results));
     }
 
+    void print_skipped_cycles(const age::tr::age_tr_test_run_results& test_run_results)
+    {
+        // group by test suite directory (first path element of the test name)
+        std::map<std::string, std::pair<int64_t, double>> skipped_by_suite;
+        for (const auto& tr : test_run_results.m_test_results)
+        {
+            if ((tr.m_skipped_cycles <= 0) || (tr.m_cycles_per_second <= 0))
+            {
+                continue;
+            }
+            auto& skipped = skipped_by_suite[tr.m_test_name.substr(0, tr.m_test_name.find('/'))];
+            skipped.first += tr.m_skipped_cycles;
+            skipped.second += static_cast<double>(tr.m_skipped_cycles) / static_cast<double>(tr.m_cycles_per_second);
+        }
+        if (skipped_by_suite.empty())
+        {
+            return;
+        }
+
+        std::cout << "time saved by finishing tests early:" << std::endl;
+        for (const auto& [suite, skipped] : skipped_by_suite)
+        {
+            std::cout << "  " << suite << ": "
+                      << skipped.second << " seconds (estimated), "
+                      << skipped.first << " cycles skipped" << std::endl;
+        }
+    }
+
 } // namespace
 
 
@@ -127,5 +178,7 @@ void age::tr::print_stats(const age::tr::age_tr_test_run_results& test_run_resul
               << std::endl;
 
     print_cycles_per_second(test_run_results);
+    print_init_duration(test_run_results);
     print_slowest_fastest_tests(test_run_results);
+    print_skipped_cycles(test_run_results);
 }
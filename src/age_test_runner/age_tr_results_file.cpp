@@ -0,0 +1,469 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "age_tr_results_file.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+
+
+namespace
+{
+    constexpr const char* key_rom_count         = "rom_count";
+    constexpr const char* key_total_duration_ns = "total_duration_ns";
+    constexpr const char* key_tests             = "tests";
+
+    constexpr const char* key_name                   = "name";
+    constexpr const char* key_passed                 = "passed";
+    constexpr const char* key_init_duration_ns       = "init_duration_ns";
+    constexpr const char* key_run_duration_ns        = "run_duration_ns";
+    constexpr const char* key_evaluation_duration_ns = "evaluation_duration_ns";
+    constexpr const char* key_write_logs_duration_ns = "write_logs_duration_ns";
+    constexpr const char* key_emulated_cycles        = "emulated_cycles";
+    constexpr const char* key_cycles_per_second      = "cycles_per_second";
+    constexpr const char* key_skipped_cycles         = "skipped_cycles";
+
+    std::string json_string(const std::string& value)
+    {
+        std::string result = "\"";
+        for (char c : value)
+        {
+            switch (c)
+            {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        // other control characters must be escaped as well
+                        constexpr const char* hex_digits = "0123456789abcdef";
+                        result += "\\u00";
+                        result += hex_digits[(c >> 4) & 0xF];
+                        result += hex_digits[c & 0xF];
+                    }
+                    else
+                    {
+                        result += c;
+                    }
+                    break;
+            }
+        }
+        return result + "\"";
+    }
+
+
+
+    //!
+    //! Minimal JSON reader supporting just what we need to read
+    //! result files written by results_to_json():
+    //! objects, arrays, strings, integers and booleans.
+    //!
+    class json_reader
+    {
+    public:
+        explicit json_reader(const std::string& json)
+            : m_json(json)
+        {}
+
+        [[nodiscard]] bool at_end()
+        {
+            skip_whitespace();
+            return m_pos >= m_json.size();
+        }
+
+        bool consume(char c)
+        {
+            skip_whitespace();
+            if ((m_pos < m_json.size()) && (m_json[m_pos] == c))
+            {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+
+        std::optional<std::string> read_string()
+        {
+            if (!consume('"'))
+            {
+                return std::nullopt;
+            }
+            std::string result;
+            while (m_pos < m_json.size())
+            {
+                char c = m_json[m_pos++];
+                if (c == '"')
+                {
+                    return result;
+                }
+                if (c != '\\')
+                {
+                    result += c;
+                    continue;
+                }
+                if (m_pos >= m_json.size())
+                {
+                    break;
+                }
+                switch (m_json[m_pos++])
+                {
+                    case '"': result += '"'; break;
+                    case '\\': result += '\\'; break;
+                    case '/': result += '/'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    case 't': result += '\t'; break;
+                    case 'u':
+                        if (!read_code_point(result))
+                        {
+                            return std::nullopt;
+                        }
+                        break;
+                    default: return std::nullopt; // not supported
+                }
+            }
+            return std::nullopt;
+        }
+
+        //!
+        //! Read the four hex digits following "\\u" and append the
+        //! respective UTF-8 sequence.
+        //! Surrogate pairs are not supported.
+        //!
+        bool read_code_point(std::string& result)
+        {
+            unsigned    code_point = 0;
+            const char* begin      = m_json.data() + m_pos;
+            const char* end        = begin + std::min<std::size_t>(4, m_json.size() - m_pos);
+
+            auto [ptr, ec] = std::from_chars(begin, end, code_point, 16);
+            if ((ec != std::errc{}) || (ptr != begin + 4) || ((code_point >= 0xD800) && (code_point < 0xE000)))
+            {
+                return false;
+            }
+            m_pos += 4;
+
+            if (code_point < 0x80)
+            {
+                result += static_cast<char>(code_point);
+            }
+            else if (code_point < 0x800)
+            {
+                result += static_cast<char>(0xC0 | (code_point >> 6));
+                result += static_cast<char>(0x80 | (code_point & 0x3F));
+            }
+            else
+            {
+                result += static_cast<char>(0xE0 | (code_point >> 12));
+                result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code_point & 0x3F));
+            }
+            return true;
+        }
+
+        std::optional<age::int64_t> read_int64()
+        {
+            skip_whitespace();
+            age::int64_t value = 0;
+            const char*  begin = m_json.data() + m_pos;
+            const char*  end   = m_json.data() + m_json.size();
+
+            auto [ptr, ec] = std::from_chars(begin, end, value);
+            if (ec != std::errc{})
+            {
+                return std::nullopt;
+            }
+            m_pos += static_cast<std::size_t>(ptr - begin);
+            return value;
+        }
+
+        std::optional<bool> read_bool()
+        {
+            skip_whitespace();
+            if (m_json.compare(m_pos, 4, "true") == 0)
+            {
+                m_pos += 4;
+                return true;
+            }
+            if (m_json.compare(m_pos, 5, "false") == 0)
+            {
+                m_pos += 5;
+                return false;
+            }
+            return std::nullopt;
+        }
+
+        //!
+        //! Read all key-value pairs of an object.
+        //! The callback has to consume each value
+        //! and returns false on error.
+        //!
+        bool read_object(const std::function<bool(const std::string& key)>& read_value)
+        {
+            if (!consume('{'))
+            {
+                return false;
+            }
+            if (consume('}'))
+            {
+                return true;
+            }
+            do
+            {
+                auto key = read_string();
+                if (!key.has_value() || !consume(':') || !read_value(key.value()))
+                {
+                    return false;
+                }
+            } while (consume(','));
+            return consume('}');
+        }
+
+        bool read_array(const std::function<bool()>& read_value)
+        {
+            if (!consume('['))
+            {
+                return false;
+            }
+            if (consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!read_value())
+                {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        }
+
+    private:
+        void skip_whitespace()
+        {
+            while ((m_pos < m_json.size()) && std::isspace(static_cast<unsigned char>(m_json[m_pos])))
+            {
+                ++m_pos;
+            }
+        }
+
+        const std::string& m_json;
+        std::size_t        m_pos = 0;
+    };
+
+    bool read_int64(json_reader& reader, age::int64_t& value)
+    {
+        auto v = reader.read_int64();
+        value  = v.value_or(0);
+        return v.has_value();
+    }
+
+    bool read_nanoseconds(json_reader& reader, std::chrono::nanoseconds& value)
+    {
+        auto v = reader.read_int64();
+        value  = std::chrono::nanoseconds(v.value_or(0));
+        return v.has_value();
+    }
+
+    std::optional<age::tr::age_tr_test_result> read_test_result(json_reader& reader)
+    {
+        age::tr::age_tr_test_result result{};
+
+        bool success = reader.read_object([&](const std::string& key) {
+            if (key == key_name)
+            {
+                auto name          = reader.read_string();
+                result.m_test_name = name.value_or("");
+                return name.has_value();
+            }
+            if (key == key_passed)
+            {
+                auto passed          = reader.read_bool();
+                result.m_test_passed = passed.value_or(false);
+                return passed.has_value();
+            }
+            if (key == key_init_duration_ns)
+            {
+                return read_nanoseconds(reader, result.m_init_duration);
+            }
+            if (key == key_run_duration_ns)
+            {
+                return read_nanoseconds(reader, result.m_run_duration);
+            }
+            if (key == key_evaluation_duration_ns)
+            {
+                return read_nanoseconds(reader, result.m_evaluation_duration);
+            }
+            if (key == key_write_logs_duration_ns)
+            {
+                return read_nanoseconds(reader, result.m_write_logs_duration);
+            }
+            if (key == key_emulated_cycles)
+            {
+                return read_int64(reader, result.m_emulated_cycles);
+            }
+            if (key == key_cycles_per_second)
+            {
+                return read_int64(reader, result.m_cycles_per_second);
+            }
+            if (key == key_skipped_cycles)
+            {
+                return read_int64(reader, result.m_skipped_cycles);
+            }
+            return false; // unknown key
+        });
+
+        return success ? std::optional(result) : std::nullopt;
+    }
+
+} // namespace
+
+
+
+std::string age::tr::results_to_json(const age_tr_test_run_results& results)
+{
+    std::stringstream json;
+
+    json << "{" << std::endl;
+    json << "  \"" << key_rom_count << "\": " << results.m_rom_count << "," << std::endl;
+    json << "  \"" << key_total_duration_ns << "\": " << results.m_total_duration.count() << "," << std::endl;
+    json << "  \"" << key_tests << "\": [";
+
+    // one test result per line
+    bool first = true;
+    for (const auto& tr : results.m_test_results)
+    {
+        json << (first ? "" : ",") << std::endl;
+        first = false;
+
+        json << "    {\"" << key_name << "\": " << json_string(tr.m_test_name)
+             << ", \"" << key_passed << "\": " << (tr.m_test_passed ? "true" : "false")
+             << ", \"" << key_init_duration_ns << "\": " << tr.m_init_duration.count()
+             << ", \"" << key_run_duration_ns << "\": " << tr.m_run_duration.count()
+             << ", \"" << key_evaluation_duration_ns << "\": " << tr.m_evaluation_duration.count()
+             << ", \"" << key_write_logs_duration_ns << "\": " << tr.m_write_logs_duration.count()
+             << ", \"" << key_emulated_cycles << "\": " << tr.m_emulated_cycles
+             << ", \"" << key_cycles_per_second << "\": " << tr.m_cycles_per_second
+             << ", \"" << key_skipped_cycles << "\": " << tr.m_skipped_cycles
+             << "}";
+    }
+
+    json << std::endl
+         << "  ]" << std::endl;
+    json << "}" << std::endl;
+
+    return json.str();
+}
+
+std::optional<age::tr::age_tr_test_run_results> age::tr::results_from_json(const std::string& json)
+{
+    age_tr_test_run_results results{};
+    json_reader             reader(json);
+
+    bool success = reader.read_object([&](const std::string& key) {
+        if (key == key_rom_count)
+        {
+            int64_t rom_count   = 0;
+            bool    valid       = read_int64(reader, rom_count);
+            results.m_rom_count = static_cast<int>(rom_count);
+            return valid;
+        }
+        if (key == key_total_duration_ns)
+        {
+            return read_nanoseconds(reader, results.m_total_duration);
+        }
+        if (key == key_tests)
+        {
+            return reader.read_array([&]() {
+                auto tr = read_test_result(reader);
+                if (tr.has_value())
+                {
+                    results.m_test_results.emplace_back(tr.value());
+                }
+                return tr.has_value();
+            });
+        }
+        return false; // unknown key
+    });
+
+    return (success && reader.at_end()) ? std::optional(results) : std::nullopt;
+}
+
+
+
+bool age::tr::write_results_file(const std::filesystem::path& file_path, const age_tr_test_run_results& results)
+{
+    std::ofstream file(file_path, std::ios::out | std::ios::trunc);
+    file << results_to_json(results);
+    file.close();
+
+    if (file.fail())
+    {
+        std::cout << "could not write test results: " << file_path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::optional<age::tr::age_tr_test_run_results> age::tr::read_results_file(const std::filesystem::path& file_path)
+{
+    std::ifstream file(file_path, std::ios::in);
+    if (!file)
+    {
+        std::cout << "could not read test results: " << file_path.string() << std::endl;
+        return std::nullopt;
+    }
+
+    std::string json{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    auto        results = results_from_json(json);
+    if (!results.has_value())
+    {
+        std::cout << "invalid test results file: " << file_path.string() << std::endl;
+    }
+    return results;
+}
+
+
+
+age::tr::age_tr_test_run_results age::tr::merge_results(const std::vector<age_tr_test_run_results>& results)
+{
+    age_tr_test_run_results merged{.m_test_results   = {},
+                                   .m_rom_count      = 0,
+                                   .m_total_duration = std::chrono::nanoseconds::zero()};
+
+    for (const auto& res : results)
+    {
+        merged.m_test_results.insert(end(merged.m_test_results),
+                                     begin(res.m_test_results),
+                                     end(res.m_test_results));
+
+        // every shard finds the same test roms
+        merged.m_rom_count      = std::max(merged.m_rom_count, res.m_rom_count);
+        merged.m_total_duration = std::max(merged.m_total_duration, res.m_total_duration);
+    }
+
+    return merged;
+}
@@ -0,0 +1,49 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_TR_RESULTS_FILE_HPP
+#define AGE_TR_RESULTS_FILE_HPP
+
+#include "age_tr_run_tests.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+
+namespace age::tr
+{
+    std::string                            results_to_json(const age_tr_test_run_results& results);
+    std::optional<age_tr_test_run_results> results_from_json(const std::string& json);
+
+    bool                                   write_results_file(const std::filesystem::path& file_path, const age_tr_test_run_results& results);
+    std::optional<age_tr_test_run_results> read_results_file(const std::filesystem::path& file_path);
+
+    //!
+    //! Combine the results of multiple test runs (e.g. shards of the same
+    //! test suite run on different machines) into a single result.
+    //! The total duration of the merged result is the longest duration
+    //! of all test runs as shards are expected to run in parallel.
+    //!
+    age_tr_test_run_results merge_results(const std::vector<age_tr_test_run_results>& results);
+
+} // namespace age::tr
+
+
+
+#endif // AGE_TR_RESULTS_FILE_HPP
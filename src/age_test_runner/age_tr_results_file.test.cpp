@@ -0,0 +1,136 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "age_tr_results_file.hpp"
+
+namespace
+{
+    age::tr::age_tr_test_result test_result(const std::string& name, bool passed, int64_t cycles)
+    {
+        return {.m_test_passed         = passed,
+                .m_test_name           = name,
+                .m_init_duration       = std::chrono::nanoseconds(1000 + cycles),
+                .m_run_duration        = std::chrono::nanoseconds(2000 + cycles),
+                .m_evaluation_duration = std::chrono::nanoseconds(3000 + cycles),
+                .m_write_logs_duration = std::chrono::nanoseconds(4000 + cycles),
+                .m_emulated_cycles     = cycles,
+                .m_cycles_per_second   = cycles * 2,
+                .m_skipped_cycles      = cycles * 3};
+    }
+
+    void expect_equal(const age::tr::age_tr_test_result& expected, const age::tr::age_tr_test_result& actual)
+    {
+        EXPECT_EQ(expected.m_test_passed, actual.m_test_passed);
+        EXPECT_EQ(expected.m_test_name, actual.m_test_name);
+        EXPECT_EQ(expected.m_init_duration, actual.m_init_duration);
+        EXPECT_EQ(expected.m_run_duration, actual.m_run_duration);
+        EXPECT_EQ(expected.m_evaluation_duration, actual.m_evaluation_duration);
+        EXPECT_EQ(expected.m_write_logs_duration, actual.m_write_logs_duration);
+        EXPECT_EQ(expected.m_emulated_cycles, actual.m_emulated_cycles);
+        EXPECT_EQ(expected.m_cycles_per_second, actual.m_cycles_per_second);
+        EXPECT_EQ(expected.m_skipped_cycles, actual.m_skipped_cycles);
+    }
+
+} // namespace
+
+
+
+TEST(AgeTestRunnerResultsFile, ReadsWrittenResults)
+{
+    age::tr::age_tr_test_run_results results{
+        .m_test_results   = {test_result("blargg/cpu_instrs.gb dmg", true, 123456),
+                             test_result(R"(odd "name" \ with	tab)", false, 0)},
+        .m_rom_count      = 17,
+        .m_total_duration = std::chrono::nanoseconds(987654321),
+    };
+
+    auto read = age::tr::results_from_json(age::tr::results_to_json(results));
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(read->m_rom_count, 17);
+    EXPECT_EQ(read->m_total_duration, std::chrono::nanoseconds(987654321));
+    ASSERT_EQ(read->m_test_results.size(), 2);
+    expect_equal(results.m_test_results[0], read->m_test_results[0]);
+    expect_equal(results.m_test_results[1], read->m_test_results[1]);
+}
+
+TEST(AgeTestRunnerResultsFile, EscapesControlCharacters)
+{
+    age::tr::age_tr_test_run_results results{
+        .m_test_results   = {test_result("bell\x07 and \x1F unit separator", true, 42)},
+        .m_rom_count      = 1,
+        .m_total_duration = std::chrono::nanoseconds(1),
+    };
+
+    auto json = age::tr::results_to_json(results);
+    EXPECT_NE(json.find(R"(bell\u0007 and \u001f unit separator)"), std::string::npos) << json;
+    EXPECT_EQ(json.find('\x07'), std::string::npos);
+    EXPECT_EQ(json.find('\x1F'), std::string::npos);
+
+    auto read = age::tr::results_from_json(json);
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(read->m_test_results.size(), 1);
+    expect_equal(results.m_test_results[0], read->m_test_results[0]);
+}
+
+TEST(AgeTestRunnerResultsFile, ReadsUnicodeEscapes)
+{
+    auto read = age::tr::results_from_json(R"({"tests": [{"name": "\u0041\u00e9\u20ac", "passed": true}]})");
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(read->m_test_results.size(), 1);
+    EXPECT_EQ(read->m_test_results[0].m_test_name, "A\xC3\xA9\xE2\x82\xAC");
+
+    EXPECT_FALSE(age::tr::results_from_json(R"({"tests": [{"name": "\u00", "passed": true}]})").has_value());
+    EXPECT_FALSE(age::tr::results_from_json(R"({"tests": [{"name": "\ud83d", "passed": true}]})").has_value());
+}
+
+TEST(AgeTestRunnerResultsFile, ReadsEmptyResults)
+{
+    auto read = age::tr::results_from_json(age::tr::results_to_json({.m_test_results = {}, .m_rom_count = 0, .m_total_duration = {}}));
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(read->m_test_results.empty());
+}
+
+TEST(AgeTestRunnerResultsFile, RejectsInvalidJson)
+{
+    EXPECT_FALSE(age::tr::results_from_json("").has_value());
+    EXPECT_FALSE(age::tr::results_from_json(R"({"rom_count": 1)").has_value());
+    EXPECT_FALSE(age::tr::results_from_json(R"({"unknown": 1})").has_value());
+    EXPECT_FALSE(age::tr::results_from_json(R"({"tests": [{"passed": 1}]})").has_value());
+}
+
+TEST(AgeTestRunnerResultsFile, MergesResults)
+{
+    age::tr::age_tr_test_run_results shard1{
+        .m_test_results   = {test_result("a.gb dmg", true, 1)},
+        .m_rom_count      = 3,
+        .m_total_duration = std::chrono::nanoseconds(500),
+    };
+    age::tr::age_tr_test_run_results shard2{
+        .m_test_results   = {test_result("b.gb dmg", false, 2), test_result("c.gb dmg", true, 3)},
+        .m_rom_count      = 3,
+        .m_total_duration = std::chrono::nanoseconds(700),
+    };
+
+    auto merged = age::tr::merge_results({shard1, shard2});
+    EXPECT_EQ(merged.m_rom_count, 3);
+    EXPECT_EQ(merged.m_total_duration, std::chrono::nanoseconds(700));
+    ASSERT_EQ(merged.m_test_results.size(), 3);
+    expect_equal(shard1.m_test_results[0], merged.m_test_results[0]);
+    expect_equal(shard2.m_test_results[0], merged.m_test_results[1]);
+    expect_equal(shard2.m_test_results[1], merged.m_test_results[2]);
+}
@@ -15,6 +15,7 @@
 //
 
 #include "age_tr_run_tests.hpp"
+#include "age_tr_shard.hpp"
 #include "age_tr_thread_pool.hpp"
 
 #include <algorithm>
@@ -177,6 +178,10 @@ age::tr::age_tr_test_run_results age::tr::run_tests(const options&
         return whitelist(path) && !blacklist(path);
     };
 
+    auto in_shard = [&](const std::string& test_name) {
+        return is_test_in_shard(test_name, opts.m_shard_index, opts.m_shard_count);
+    };
+
     blocking_vector<age_tr_test_result> results;
     int                                 rom_count = 0;
     {
@@ -215,8 +220,13 @@ age::tr::age_tr_test_run_results age::tr::run_tests(const options&
                               // no tests to run -> mark this as failed test
                               if (tests.empty())
                               {
-                                  results.push({.m_test_passed = false,
-                                                .m_test_name   = rom_path.string() + " (no test scheduled)"});
+                                  std::string test_name = normalize_path_separator(std::filesystem::relative(rom_path, opts.m_test_suite_path))
+                                                          + " (no test scheduled)";
+                                  if (in_shard(test_name))
+                                  {
+                                      results.push({.m_test_passed = false,
+                                                    .m_test_name   = test_name});
+                                  }
                                   return;
                               }
 
@@ -237,6 +247,11 @@ age::tr::age_tr_test_run_results age::tr::run_tests(const options&
                                   return false;
                               });
 
+                              // run only the tests of the selected shard
+                              erase_if(tests, [&](const age_tr_test& test) {
+                                  return !in_shard(test.test_name(opts.m_test_suite_path));
+                              });
+
                               // schedule tests for this rom file
                               for (auto& test : tests)
                               {
@@ -262,7 +277,8 @@ age::tr::age_tr_test_run_results age::tr::run_tests(const options&
                                                             .m_run_duration        = begin_evaluation - begin_run,
                                                             .m_evaluation_duration = end_evaluation - begin_evaluation,
                                                             .m_emulated_cycles     = test.emulated_cycles(),
-                                                            .m_cycles_per_second   = static_cast<int64_t>(cycles_per_second)};
+                                                            .m_cycles_per_second   = static_cast<int64_t>(cycles_per_second),
+                                                            .m_skipped_cycles      = test.skipped_cycles()};
 
                                       if (opts.m_write_logs)
                                       {
@@ -271,6 +287,7 @@ age::tr::age_tr_test_run_results age::tr::run_tests(const options&
                                           tr.m_write_logs_duration = end_write_logs - end_evaluation;
                                       }
 
+                                      test.finish_test();
                                       results.push(tr);
                                   });
                               }
@@ -38,6 +38,7 @@ namespace age::tr
         std::chrono::nanoseconds m_write_logs_duration;
         int64_t                  m_emulated_cycles;
         int64_t                  m_cycles_per_second;
+        int64_t                  m_skipped_cycles; //!< cycles not emulated due to the test finishing early
     };
 
     struct age_tr_test_run_results
@@ -0,0 +1,35 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "age_tr_shard.hpp"
+
+#include <cstdint>
+
+
+
+bool age::tr::is_test_in_shard(const std::string& test_name, int shard_index, int shard_count)
+{
+    // We need a hash that does not change across platforms and compilers
+    // (unlike std::hash) as shards may run on different machines.
+    // FNV-1a, see also: https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+    uint64_t hash = 0xcbf29ce484222325;
+    for (char c : test_name)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    return static_cast<int>(hash % static_cast<uint64_t>(shard_count)) == (shard_index - 1);
+}
@@ -0,0 +1,37 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef AGE_TR_SHARD_HPP
+#define AGE_TR_SHARD_HPP
+
+#include <string>
+
+
+
+namespace age::tr
+{
+    //!
+    //! Deterministically assign a test to one of several shards based on
+    //! the test's name.
+    //! Shards are numbered from 1 to shard_count (inclusive).
+    //!
+    bool is_test_in_shard(const std::string& test_name, int shard_index, int shard_count);
+
+} // namespace age::tr
+
+
+
+#endif // AGE_TR_SHARD_HPP
@@ -0,0 +1,95 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "age_tr_shard.hpp"
+
+#include <string>
+#include <vector>
+
+
+
+TEST(AgeTestRunnerShard, AssignsEachTestToExactlyOneShard)
+{
+    for (int shard_count = 1; shard_count <= 7; ++shard_count)
+    {
+        std::vector<int> tests_per_shard(shard_count, 0);
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string test_name = "suite/rom_" + std::to_string(i) + ".gb dmg";
+
+            int shards = 0;
+            for (int shard_index = 1; shard_index <= shard_count; ++shard_index)
+            {
+                if (age::tr::is_test_in_shard(test_name, shard_index, shard_count))
+                {
+                    ++shards;
+                    ++tests_per_shard[shard_index - 1];
+                }
+            }
+            EXPECT_EQ(shards, 1) << test_name << " in " << shards << " of " << shard_count << " shards";
+        }
+
+        // every shard gets some tests
+        for (int tests : tests_per_shard)
+        {
+            EXPECT_GT(tests, 0);
+        }
+    }
+}
+
+TEST(AgeTestRunnerShard, AssignsTestsDeterministically)
+{
+    // Shards may run on different machines,
+    // so these assignments must never change
+    // (FNV-1a hash of the test name modulo the shard count).
+    struct expected_shard
+    {
+        std::string m_test_name;
+        int         m_shard_count;
+        int         m_shard_index;
+    };
+    const std::vector<expected_shard> expected_shards = {
+        {"blargg/cpu_instrs.gb dmg", 1, 1},
+        {"blargg/cpu_instrs.gb dmg", 2, 1},
+        {"blargg/cpu_instrs.gb dmg", 4, 3},
+        {"blargg/cpu_instrs.gb dmg", 7, 3},
+        {"blargg/cpu_instrs.gb cgb", 7, 5},
+        {"mooneye/acceptance/ei_timing.gb dmg", 7, 2},
+        {"mealybug/m3_scx_low_3_bits.gb cgb", 4, 1},
+        {"mealybug/m3_scx_low_3_bits.gb cgb", 7, 4},
+        {"gambatte/tima/tc00_1.gb dmg", 2, 2},
+        {"gambatte/tima/tc00_1.gb dmg", 3, 3},
+        {"gambatte/tima/tc00_1.gb dmg", 4, 4},
+        {"gambatte/tima/tc00_1.gb dmg", 7, 6},
+    };
+
+    for (const auto& expected : expected_shards)
+    {
+        std::vector<int> shards;
+        for (int shard_index = 1; shard_index <= expected.m_shard_count; ++shard_index)
+        {
+            if (age::tr::is_test_in_shard(expected.m_test_name, shard_index, expected.m_shard_count))
+            {
+                shards.push_back(shard_index);
+            }
+        }
+        EXPECT_EQ(shards, std::vector<int>{expected.m_shard_index})
+            << expected.m_test_name << " with " << expected.m_shard_count << " shards";
+    }
+}
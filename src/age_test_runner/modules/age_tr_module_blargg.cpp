@@ -20,6 +20,13 @@
 
 namespace
 {
+    // Blargg's test roms may not update the screen for several seconds
+    // while running a single test.
+    // Passed tests usually finish early by matching the screenshot,
+    // failed tests are finished after the screen did not change for
+    // this number of frames.
+    constexpr int stable_frames = 60 * 15;
+
     int test_duration_ms(const std::string& screenshot_filename, age::gb_device_type device_type)
     {
         // see https://github.com/c-sp/gameboy-test-roms/blob/master/src/howto/blargg.md
@@ -84,15 +91,17 @@ age::tr::age_tr_module age::tr::create_blargg_module()
                     rom_path,
                     rom_contents,
                     gb_device_type::cgb_abcd,
-                    finished_after_milliseconds(test_duration_ms(cgb_screenshot.filename(), gb_device_type::cgb_abcd)),
-                    succeeded_with_screenshot(cgb_screenshot));
+                    test_duration_ms(cgb_screenshot.filename(), gb_device_type::cgb_abcd),
+                    stable_frames,
+                    cgb_screenshot);
 
                 tests.emplace_back(
                     rom_path,
                     rom_contents,
                     gb_device_type::cgb_e,
-                    finished_after_milliseconds(test_duration_ms(cgb_screenshot.filename(), gb_device_type::cgb_e)),
-                    succeeded_with_screenshot(cgb_screenshot));
+                    test_duration_ms(cgb_screenshot.filename(), gb_device_type::cgb_e),
+                    stable_frames,
+                    cgb_screenshot);
             }
 
             auto dmg_screenshot = dmg_cgb_screenshot.empty() ? find_screenshot(rom_path, "-dmg.png") : dmg_cgb_screenshot;
@@ -102,8 +111,9 @@ age::tr::age_tr_module age::tr::create_blargg_module()
                     rom_path,
                     rom_contents,
                     gb_device_type::dmg,
-                    finished_after_milliseconds(test_duration_ms(dmg_screenshot.filename(), gb_device_type::dmg)),
-                    succeeded_with_screenshot(dmg_screenshot));
+                    test_duration_ms(dmg_screenshot.filename(), gb_device_type::dmg),
+                    stable_frames,
+                    dmg_screenshot);
             }
 
             return tests;
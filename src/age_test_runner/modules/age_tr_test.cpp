@@ -18,7 +18,9 @@
 #include "age_tr_write_log.hpp"
 
 #include <gfx/age_png.hpp>
+#include <gfx/age_screen_buffer.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -42,6 +44,12 @@ namespace
         }
     }
 
+    // Emulators are recycled per thread to not reallocate their buffers
+    // for every test.
+    // All tests of a test run use the same log categories,
+    // so we don't have to care about those when resetting an emulator.
+    thread_local std::vector<std::shared_ptr<age::gb_emulator>> emulator_pool;
+
 } // namespace
 
 
@@ -123,6 +131,23 @@ age::tr::age_tr_test::age_tr_test(std::filesystem::path                        r
 
 
 
+age::tr::age_tr_test::age_tr_test(std::filesystem::path               rom_path,
+                                  std::shared_ptr<const uint8_vector> rom,
+                                  age::gb_device_type                 device_type,
+                                  age::int64_t                        max_milliseconds,
+                                  int                                 stable_frames,
+                                  const std::filesystem::path&        screenshot_path)
+    : age_tr_test(std::move(rom_path),
+                  std::move(rom),
+                  device_type,
+                  finished_when_screen_stable(stable_frames, max_milliseconds, screenshot_path),
+                  succeeded_with_screenshot(screenshot_path))
+{
+    m_max_milliseconds = max_milliseconds;
+}
+
+
+
 age::gb_device_type age::tr::age_tr_test::device_type() const
 {
     return m_device_type;
@@ -147,12 +172,30 @@ age::int64_t age::tr::age_tr_test::emulated_cycles() const
     return m_emulator->get_emulated_cycles();
 }
 
+age::int64_t age::tr::age_tr_test::skipped_cycles() const
+{
+    if (m_max_milliseconds <= 0)
+    {
+        return 0;
+    }
+    auto max_cycles = m_max_milliseconds * m_emulator->get_cycles_per_second() / 1000;
+    return std::max<int64_t>(0, max_cycles - m_emulator->get_emulated_cycles());
+}
+
 void age::tr::age_tr_test::init_test(const gb_log_categories& log_categories)
 {
-    if (m_emulator == nullptr)
+    if (m_emulator != nullptr)
+    {
+        return;
+    }
+    if (emulator_pool.empty())
     {
-        m_emulator = std::make_shared<gb_emulator>(*m_rom, m_device_type, m_colors_hint, log_categories);
+        m_emulator = std::make_shared<gb_emulator>(m_rom, m_device_type, m_colors_hint, log_categories);
+        return;
     }
+    m_emulator = emulator_pool.back();
+    emulator_pool.pop_back();
+    m_emulator->reset(m_rom, m_device_type, m_colors_hint);
 }
 
 void age::tr::age_tr_test::run_test()
@@ -172,6 +215,15 @@ void age::tr::age_tr_test::write_logs()
     write_log(log_path, m_emulator->get_and_clear_log_entries(), m_rom_path, m_device_type);
 }
 
+void age::tr::age_tr_test::finish_test()
+{
+    if (m_emulator != nullptr)
+    {
+        emulator_pool.emplace_back(std::move(m_emulator));
+        m_emulator = nullptr;
+    }
+}
+
 
 
 std::function<bool(const age::gb_emulator&)> age::tr::finished_after_milliseconds(age::int64_t milliseconds)
@@ -191,6 +243,52 @@ std::function<bool(const age::gb_emulator&)> age::tr::finished_after_ld_b_b()
     };
 }
 
+std::function<bool(const age::gb_emulator&)> age::tr::finished_when_screen_stable(int                          frames,
+                                                                                  age::int64_t                 max_milliseconds,
+                                                                                  const std::filesystem::path& screenshot_path)
+{
+    // 154 lines per frame, 456 clock cycles per line
+    constexpr int64_t cycles_per_frame = 154 * 456;
+
+    bool          screenshot_loaded = screenshot_path.empty();
+    bool          use_screenshot    = false;
+    age::uint64_t screenshot_hash   = 0;
+    age::uint64_t last_hash         = 0;
+    int64_t       last_change_cycle = -1;
+
+    return [=](const age::gb_emulator& emulator) mutable {
+        auto emulated_cycles = emulator.get_emulated_cycles();
+        if (emulated_cycles >= max_milliseconds * emulator.get_cycles_per_second() / 1000)
+        {
+            return true;
+        }
+
+        // load the screenshot just once for this test
+        if (!screenshot_loaded)
+        {
+            screenshot_loaded = true;
+            auto screenshot   = read_png_file(screenshot_path,
+                                            emulator.get_screen_width(),
+                                            emulator.get_screen_height());
+            use_screenshot    = !screenshot.empty();
+            screenshot_hash   = age::screen_buffer::calculate_hash(screenshot, emulator.get_screen_width());
+        }
+
+        auto hash = emulator.get_screen_front_buffer_hash();
+        if (use_screenshot && (hash == screenshot_hash))
+        {
+            return true;
+        }
+        if ((last_change_cycle < 0) || (hash != last_hash))
+        {
+            last_hash         = hash;
+            last_change_cycle = emulated_cycles;
+            return false;
+        }
+        return emulated_cycles - last_change_cycle >= frames * cycles_per_frame;
+    };
+}
+
 std::function<bool(const age::gb_emulator&)> age::tr::succeeded_with_screenshot(const std::filesystem::path& screenshot_path)
 {
     return [=](const age::gb_emulator& emulator) {
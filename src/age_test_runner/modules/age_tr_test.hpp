@@ -32,6 +32,16 @@ namespace age::tr //! \todo remove ::tr, rename classes from "age_tr_..." to "tr
     std::function<bool(const age::gb_emulator&)> finished_after_milliseconds(int64_t milliseconds);
     std::function<bool(const age::gb_emulator&)> finished_after_ld_b_b();
 
+    //!
+    //! Finish a test as soon as the screen matches the specified screenshot
+    //! or once the screen did not change for the specified number of frames.
+    //! If no screenshot is specified, only the latter criterion is used.
+    //! The test is finished after the specified milliseconds in any case.
+    //!
+    std::function<bool(const age::gb_emulator&)> finished_when_screen_stable(int                          frames,
+                                                                             int64_t                      max_milliseconds,
+                                                                             const std::filesystem::path& screenshot_path = {});
+
     std::function<bool(const age::gb_emulator&)> succeeded_with_screenshot(const std::filesystem::path& screenshot_path);
     std::function<bool(const age::gb_emulator&)> succeeded_with_fibonacci_regs();
 
@@ -56,6 +66,18 @@ namespace age::tr //! \todo remove ::tr, rename classes from "age_tr_..." to "tr
                     std::function<void(age::gb_emulator&)>       run_test,
                     std::function<bool(const age::gb_emulator&)> test_succeeded);
 
+        //!
+        //! Create a screenshot based test that runs for the specified
+        //! milliseconds at most but may finish early,
+        //! see finished_when_screen_stable().
+        //!
+        age_tr_test(std::filesystem::path               rom_path,
+                    std::shared_ptr<const uint8_vector> rom,
+                    gb_device_type                      device_type,
+                    int64_t                             max_milliseconds,
+                    int                                 stable_frames,
+                    const std::filesystem::path&        screenshot_path);
+
         age_tr_test(std::filesystem::path                        rom_path,
                     std::shared_ptr<const uint8_vector>          rom,
                     gb_device_type                               device_type,
@@ -74,18 +96,23 @@ namespace age::tr //! \todo remove ::tr, rename classes from "age_tr_..." to "tr
         [[nodiscard]] gb_device_type device_type() const;
         [[nodiscard]] std::string    test_name(const std::string& base_path) const;
         [[nodiscard]] int64_t        emulated_cycles() const;
+        [[nodiscard]] int64_t        skipped_cycles() const;
 
         void init_test(const gb_log_categories& log_categories);
         void run_test();
         bool test_succeeded();
         void write_logs();
 
+        //! Hand over the emulator for reuse by the next test on this thread.
+        void finish_test();
+
     private:
         std::filesystem::path               m_rom_path;
         std::shared_ptr<const uint8_vector> m_rom;
         gb_device_type                      m_device_type;
         gb_colors_hint                      m_colors_hint;
         std::string                         m_additional_info;
+        int64_t                             m_max_milliseconds = 0; //!< used to calculate skipped cycles of tests finished early
 
         std::function<void(age::gb_emulator&)>       m_run_test;
         std::function<bool(const age::gb_emulator&)> m_test_succeeded;
@@ -0,0 +1,69 @@
+//
+// © 2023 Christoph Sprenger <https://github.com/c-sp>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "age_tr_test.hpp"
+
+#include "../../age_emulator_gb/age_gb_test_rom.hpp"
+
+namespace
+{
+    constexpr int64_t max_milliseconds = 1000;
+
+    //! run the emulator frame by frame until the test is finished
+    age::int64_t run_until_finished(const std::shared_ptr<const age::uint8_vector>& rom)
+    {
+        age::gb_emulator emulator(rom, age::gb_device_type::dmg);
+        auto             finished = age::tr::finished_when_screen_stable(10, max_milliseconds);
+
+        while (!finished(emulator))
+        {
+            emulator.emulate(emulator.get_cycles_per_frame());
+        }
+        return emulator.get_emulated_cycles() * 1000 / emulator.get_cycles_per_second();
+    }
+
+} // namespace
+
+
+
+TEST(AgeTestRunnerScreenStable, FinishesEarlyForStableScreen)
+{
+    // loop: jr loop
+    auto rom = age::gb_create_test_rom({0x18, 0xFE});
+
+    EXPECT_LT(run_until_finished(rom), max_milliseconds / 2);
+}
+
+TEST(AgeTestRunnerScreenStable, RunsUntilTimeoutForChangingScreen)
+{
+    // change the background palette once per frame
+    auto rom = age::gb_create_test_rom({
+        0xF0, 0x44, // loop: ldh a, [LY]
+        0xFE, 0x90, //       cp 144
+        0x20, 0xFA, //       jr nz, loop
+        0xF0, 0x47, //       ldh a, [BGP]
+        0x3C,       //       inc a
+        0xE0, 0x47, //       ldh [BGP], a
+        0xF0, 0x44, // wait: ldh a, [LY]
+        0xFE, 0x90, //       cp 144
+        0x28, 0xFA, //       jr z, wait
+        0x18, 0xED, //       jr loop
+    });
+
+    EXPECT_GE(run_until_finished(rom), max_milliseconds);
+}
@@ -29,14 +29,16 @@
 #endif
 
 
-static std::unique_ptr<age::downsampler_kaiser_low_pass> downsampler        = nullptr;
-static int                                               output_sample_rate = 44100;
+static std::unique_ptr<age::downsampler> downsampler                = nullptr;
+static int                               output_sample_rate         = 44100;
+static bool                              use_multistage_downsampler = false;
 
 static std::unique_ptr<age::gb_emulator> gb_emu = nullptr;
 static age::uint8_vector                 gb_rom;
 static std::string                       rom_name;
 static age::uint8_vector                 gb_persistent_ram;
 static bool                              gb_persistent_ram_dirty = false; // true => emulator_exists() == true
+static bool                              use_indexed_screen      = false;
 
 void free_memory(age::uint8_vector& vec)
 {
@@ -69,6 +71,7 @@ void gb_new_emulator()
     gb_emu      = std::make_unique<age::gb_emulator>(gb_rom);
     rom_name    = gb_emu->get_emulator_title();
     downsampler = nullptr;
+    gb_emu->set_indexed_screen_enabled(use_indexed_screen);
 
     free_memory(gb_persistent_ram);
     free_memory(gb_rom);
@@ -109,6 +112,16 @@ void gb_set_persistent_ram()
 
 
 
+EMSCRIPTEN_KEEPALIVE
+void gb_set_multistage_downsampler(bool multistage)
+{
+    if (use_multistage_downsampler != multistage)
+    {
+        use_multistage_downsampler = multistage;
+        downsampler                = nullptr; // re-created by gb_emulate()
+    }
+}
+
 // 32 bit vs. 64 bit:
 // https://github.com/kripken/emscripten/issues/5130
 //  -> use 32 bit min_cycles_to_emulate for now
@@ -122,7 +135,14 @@ bool gb_emulate(int min_cycles_to_emulate, int sample_rate)
         if ((output_sample_rate != sample_rate) || (downsampler == nullptr))
         {
             output_sample_rate = sample_rate;
-            downsampler        = std::make_unique<age::downsampler_kaiser_low_pass>(gb_emu->get_pcm_sampling_rate(), output_sample_rate, 0.1);
+            if (use_multistage_downsampler)
+            {
+                downsampler = std::make_unique<age::downsampler_multistage>(gb_emu->get_pcm_sampling_rate(), output_sample_rate, 0.001);
+            }
+            else
+            {
+                downsampler = std::make_unique<age::downsampler_polyphase>(gb_emu->get_pcm_sampling_rate(), output_sample_rate, 0.1);
+            }
         }
 
         downsampler->clear_output_samples();
@@ -190,6 +210,53 @@ const age::pixel* gb_get_screen_front_buffer()
 
 
 
+// The indexed screen replaces the RGBA screen returned by
+// gb_get_screen_front_buffer() (see gb_indexed_screen for details).
+// The color of pixel (x, y) is looked up by the caller:
+//   palettes[line_palettes[y] * gb_get_indexed_palette_size() + color_indexes[y * width + x]]
+
+EMSCRIPTEN_KEEPALIVE
+void gb_set_indexed_screen_enabled(bool enabled)
+{
+    use_indexed_screen = enabled;
+    if (emulator_exists())
+    {
+        gb_emu->set_indexed_screen_enabled(enabled);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int gb_get_indexed_palette_size()
+{
+    return age::gb_indexed_palette_size;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const age::uint8_t* gb_get_indexed_screen_color_indexes()
+{
+    return emulator_exists() ? gb_emu->get_indexed_screen_front_buffer().m_color_indexes.data() : nullptr;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const age::uint16_t* gb_get_indexed_screen_line_palettes()
+{
+    return emulator_exists() ? gb_emu->get_indexed_screen_front_buffer().m_line_palettes.data() : nullptr;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const age::pixel* gb_get_indexed_screen_palettes()
+{
+    return emulator_exists() ? gb_emu->get_indexed_screen_front_buffer().m_palettes.data() : nullptr;
+}
+
+EMSCRIPTEN_KEEPALIVE
+age::size_t gb_get_indexed_screen_palettes_size()
+{
+    return emulator_exists() ? gb_emu->get_indexed_screen_front_buffer().m_palettes.size() : 0;
+}
+
+
+
 EMSCRIPTEN_KEEPALIVE
 const age::pcm_frame* gb_get_audio_buffer()
 {